@@ -0,0 +1,78 @@
+#pragma once
+
+#include <future>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace jsonrpc::client {
+
+class Client;
+
+/**
+ * @brief Builder for a JSON-RPC batch request.
+ *
+ * Collects method calls and notifications that are sent together as a single
+ * JSON array by Client::SendBatch. Each method call returns a future that is
+ * resolved when its response arrives, in whatever order the server answers.
+ */
+class Batch {
+ public:
+  Batch() = default;
+  ~Batch() = default;
+
+  Batch(const Batch &) = delete;
+  auto operator=(const Batch &) -> Batch & = delete;
+
+  Batch(Batch &&) noexcept = default;
+  auto operator=(Batch &&) noexcept -> Batch & = default;
+
+  /**
+   * @brief Adds a method call to the batch.
+   *
+   * @param method The name of the method to call.
+   * @param params Optional parameters to pass to the method.
+   * @return A future that will hold the JSON response from the server.
+   */
+  auto AddMethodCall(
+      const std::string &method,
+      std::optional<nlohmann::json> params = std::nullopt)
+      -> std::future<nlohmann::json>;
+
+  /**
+   * @brief Adds a notification to the batch.
+   *
+   * @param method The name of the method to notify.
+   * @param params Optional parameters to pass to the method.
+   */
+  void AddNotification(
+      const std::string &method,
+      std::optional<nlohmann::json> params = std::nullopt);
+
+  /// @brief Gets the number of calls and notifications in the batch.
+  [[nodiscard]] auto Size() const -> std::size_t;
+
+  /// @brief Checks if the batch is empty.
+  [[nodiscard]] auto IsEmpty() const -> bool;
+
+ private:
+  /// @brief A call or notification queued in the batch.
+  struct Entry {
+    std::string method;
+    std::optional<nlohmann::json> params;
+    /// Set for method calls, empty for notifications.
+    std::optional<std::promise<nlohmann::json>> promise;
+  };
+
+  /// @brief The queued entries, in the order they were added.
+  std::vector<Entry> entries_;
+
+  /// @brief Number of entries that expect a response.
+  std::size_t num_calls_ = 0;
+
+  friend class Client;
+};
+
+}  // namespace jsonrpc::client
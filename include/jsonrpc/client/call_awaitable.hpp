@@ -0,0 +1,87 @@
+#pragma once
+
+#include <chrono>
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+#include "jsonrpc/client/pending_call_table.hpp"
+#include "jsonrpc/executor/executor.hpp"
+
+namespace jsonrpc::client {
+
+class Client;
+
+/**
+ * @brief Awaitable JSON-RPC method call returned by Client::Call.
+ *
+ * The request is sent when the awaiting coroutine suspends. The response is
+ * stored in the awaitable itself, which lives in the coroutine frame, so no
+ * std::promise shared state is allocated. The coroutine is resumed straight
+ * from the client's response path: on the listener thread, or through the
+ * executor given to Client::Call. The response is parsed on resumption, so
+ * with an executor the listener thread never parses it.
+ *
+ * Works with any coroutine type that accepts arbitrary awaitables. A
+ * coroutine suspended on a call must not be destroyed before it resumes.
+ */
+class CallAwaitable : public CallWaiter {
+ public:
+  /**
+   * @brief Constructs a CallAwaitable. Use Client::Call instead.
+   *
+   * @param client The client sending the call.
+   * @param method The name of the method to call.
+   * @param params Optional parameters to pass to the method.
+   * @param executor Executor to resume the coroutine on, or null to resume it
+   * on the thread that completes the call.
+   * @param timeout How long to wait for the response.
+   */
+  CallAwaitable(
+      Client &client, std::string method,
+      std::optional<nlohmann::json> params,
+      std::shared_ptr<executor::Executor> executor,
+      std::optional<std::chrono::milliseconds> timeout);
+
+  /// @brief Always suspends; the call is sent from await_suspend.
+  [[nodiscard]] auto await_ready() const noexcept -> bool;
+
+  /**
+   * @brief Sends the call and registers the coroutine for resumption.
+   *
+   * @param handle The awaiting coroutine.
+   */
+  void await_suspend(std::coroutine_handle<> handle);
+
+  /**
+   * @brief Returns the response.
+   *
+   * @return The JSON response received from the server.
+   * @throws TimeoutError or std::runtime_error if the call failed, or
+   * nlohmann::json::parse_error if the response is malformed.
+   */
+  auto await_resume() -> nlohmann::json;
+
+  void OnResponse(RawResponse response) override;
+
+  void OnError(std::exception_ptr error) override;
+
+ private:
+  /// @brief Resumes the awaiting coroutine on the chosen executor.
+  void Resume();
+
+  Client &client_;
+  std::string method_;
+  std::optional<nlohmann::json> params_;
+  std::shared_ptr<executor::Executor> executor_;
+  std::optional<std::chrono::milliseconds> timeout_;
+  std::coroutine_handle<> handle_;
+  std::optional<RawResponse> response_;
+  std::exception_ptr error_;
+};
+
+}  // namespace jsonrpc::client
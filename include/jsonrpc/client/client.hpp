@@ -1,21 +1,76 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
 #include <future>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <stdexcept>
 #include <string>
 #include <thread>
-#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <nlohmann/json_fwd.hpp>
 
+#include "jsonrpc/client/batch.hpp"
+#include "jsonrpc/client/call_awaitable.hpp"
+#include "jsonrpc/client/pending_call_table.hpp"
+#include "jsonrpc/client/raw_response.hpp"
 #include "jsonrpc/client/request.hpp"
+#include "jsonrpc/client/timer_wheel.hpp"
+#include "jsonrpc/executor/executor.hpp"
 #include "jsonrpc/transport/transport.hpp"
 
 namespace jsonrpc::client {
 
+/**
+ * @brief Error delivered to a call whose response did not arrive in time.
+ */
+class TimeoutError : public std::runtime_error {
+ public:
+  using std::runtime_error::runtime_error;
+};
+
+/**
+ * @brief Configuration for automatic request coalescing.
+ *
+ * When enabled, calls and notifications are buffered and sent together as a
+ * single JSON-RPC batch once the oldest buffered message has waited for
+ * `window`, or as soon as the buffer reaches `max_messages` or `max_bytes`.
+ */
+struct AutoBatchOptions {
+  /// @brief Buffer outgoing messages instead of sending them immediately.
+  bool enabled = false;
+
+  /// @brief Longest time a buffered message waits before it is sent.
+  std::chrono::microseconds window{200};
+
+  /// @brief Number of buffered messages that triggers an immediate send.
+  std::size_t max_messages = 64;
+
+  /// @brief Size of the buffered batch in bytes that triggers a send.
+  std::size_t max_bytes = 64 * 1024;
+};
+
+/**
+ * @brief Configuration for a Client.
+ */
+struct ClientOptions {
+  /// @brief Automatic coalescing of outgoing messages into batches.
+  AutoBatchOptions auto_batch;
+
+  /// @brief Timeout for calls that do not set their own. None waits forever.
+  std::optional<std::chrono::milliseconds> default_timeout;
+
+  /// @brief Timer wheel used for timeouts. Null uses the shared wheel.
+  std::shared_ptr<TimerWheel> timer_wheel;
+};
+
 /**
  * @brief A JSON-RPC client for sending requests and receiving responses.
  *
@@ -32,8 +87,18 @@ class Client {
    */
   explicit Client(std::unique_ptr<transport::Transport> transport);
 
-  /// @brief Destructor.
-  ~Client() = default;
+  /**
+   * @brief Constructs a JSON-RPC client with a transport and options.
+   *
+   * @param transport A unique pointer to a transport layer used for
+   * communication.
+   * @param options The client configuration.
+   */
+  Client(
+      std::unique_ptr<transport::Transport> transport, ClientOptions options);
+
+  /// @brief Destructor. Stops the listener thread if it is still running.
+  ~Client();
 
   // Delete copy constructor and copy assignment operator
   Client(const Client &) = delete;
@@ -47,16 +112,18 @@ class Client {
    * @brief Starts the JSON-RPC client listener thread.
    *
    * Initializes and starts a background thread that listens for responses from
-   * the server. This must be called before sending any requests.
+   * the server, and the flusher thread if auto-batching is enabled. This must
+   * be called before sending any requests.
    */
   void Start();
 
   /**
    * @brief Stops the JSON-RPC client listener thread.
    *
-   * Stops the background listener thread and waits for it to join.
-   * This should be called before the client is destroyed or when the client no
-   * longer needs to listen for responses.
+   * Sends any buffered auto-batched messages, then closes the transport to
+   * wake the listener thread and waits for it to join. This should be called
+   * before the client is destroyed or when the client no longer needs to
+   * listen for responses.
    */
   void Stop();
 
@@ -75,11 +142,16 @@ class Client {
    *
    * @param method The name of the method to call.
    * @param params Optional parameters to pass to the method.
+   * @param timeout How long to wait for the response. Defaults to the
+   * client's default timeout.
    * @return The JSON response received from the server.
+   * @throws TimeoutError if the response does not arrive in time.
    */
   auto SendMethodCall(
       const std::string &method,
-      std::optional<nlohmann::json> params = std::nullopt) -> nlohmann::json;
+      std::optional<nlohmann::json> params = std::nullopt,
+      std::optional<std::chrono::milliseconds> timeout = std::nullopt)
+      -> nlohmann::json;
 
   /**
    * @brief Sends a JSON-RPC method call asynchronously.
@@ -89,13 +161,120 @@ class Client {
    *
    * @param method The name of the method to call.
    * @param params Optional parameters to pass to the method.
+   * @param timeout How long to wait for the response. Defaults to the
+   * client's default timeout. On expiry the future holds a TimeoutError.
    * @return A future that will hold the JSON response from the server.
    */
   auto SendMethodCallAsync(
       const std::string &method,
-      std::optional<nlohmann::json> params = std::nullopt)
+      std::optional<nlohmann::json> params = std::nullopt,
+      std::optional<std::chrono::milliseconds> timeout = std::nullopt)
       -> std::future<nlohmann::json>;
 
+  /**
+   * @brief Sends a call to a prepared method and waits for the response.
+   *
+   * Same as SendMethodCall(), but the constant part of the request is only
+   * serialized once, when the method is prepared.
+   *
+   * @param method The prepared method to call.
+   * @param params Optional parameters to pass to the method.
+   * @param timeout How long to wait for the response. Defaults to the
+   * client's default timeout.
+   * @return The JSON response received from the server.
+   * @throws TimeoutError if the response does not arrive in time.
+   */
+  auto SendMethodCall(
+      const PreparedMethod &method,
+      std::optional<nlohmann::json> params = std::nullopt,
+      std::optional<std::chrono::milliseconds> timeout = std::nullopt)
+      -> nlohmann::json;
+
+  /**
+   * @brief Sends a call to a prepared method asynchronously.
+   *
+   * @param method The prepared method to call.
+   * @param params Optional parameters to pass to the method.
+   * @param timeout How long to wait for the response. Defaults to the
+   * client's default timeout. On expiry the future holds a TimeoutError.
+   * @return A future that will hold the JSON response from the server.
+   */
+  auto SendMethodCallAsync(
+      const PreparedMethod &method,
+      std::optional<nlohmann::json> params = std::nullopt,
+      std::optional<std::chrono::milliseconds> timeout = std::nullopt)
+      -> std::future<nlohmann::json>;
+
+  /**
+   * @brief Sends a JSON-RPC method call whose response is parsed on demand.
+   *
+   * The listener thread only scans the response for its ID, so large
+   * results are parsed by whichever thread calls RawResponse::GetResult().
+   *
+   * @param method The name of the method to call.
+   * @param params Optional parameters to pass to the method.
+   * @param timeout How long to wait for the response. Defaults to the
+   * client's default timeout.
+   * @return A future that will hold the unparsed response.
+   */
+  auto SendMethodCallRaw(
+      const std::string &method,
+      std::optional<nlohmann::json> params = std::nullopt,
+      std::optional<std::chrono::milliseconds> timeout = std::nullopt)
+      -> std::future<RawResponse>;
+
+  /**
+   * @brief Makes a JSON-RPC method call from a coroutine.
+   *
+   * `co_await client.Call("method", params)` sends the call and suspends the
+   * coroutine without blocking a thread. The coroutine resumes with the
+   * response, or with the call's exception, directly from the response path.
+   *
+   * @param method The name of the method to call.
+   * @param params Optional parameters to pass to the method.
+   * @param executor Executor to resume the coroutine on. Null resumes it on
+   * the thread that completes the call, usually the listener thread, in
+   * which case the coroutine must not block waiting for another response.
+   * @param timeout How long to wait for the response. Defaults to the
+   * client's default timeout.
+   * @return An awaitable yielding the JSON response from the server.
+   */
+  auto Call(
+      const std::string &method,
+      std::optional<nlohmann::json> params = std::nullopt,
+      std::shared_ptr<executor::Executor> executor = nullptr,
+      std::optional<std::chrono::milliseconds> timeout = std::nullopt)
+      -> CallAwaitable;
+
+  /**
+   * @brief Sends a JSON-RPC method call whose outcome goes to a waiter.
+   *
+   * Lower-level building block for callers that manage completion
+   * themselves, such as ClientPool's hedged calls.
+   *
+   * @param waiter The waiter to notify. Must stay alive until notified or
+   * until CancelCall() returns true for the call.
+   * @param method The name of the method to call.
+   * @param params Optional parameters to pass to the method.
+   * @param timeout How long to wait for the response. Defaults to the
+   * client's default timeout.
+   * @return The request ID of the call.
+   * @throws std::runtime_error if sending fails; the waiter is then not
+   * notified.
+   */
+  auto SendMethodCallTo(
+      CallWaiter &waiter, const std::string &method,
+      std::optional<nlohmann::json> params = std::nullopt,
+      std::optional<std::chrono::milliseconds> timeout = std::nullopt) -> int;
+
+  /**
+   * @brief Abandons a pending call. Its response, if any, is discarded.
+   *
+   * @param request_id The request ID of the call.
+   * @return True if the call was pending and will not be completed.
+   */
+  auto CancelCall(int request_id) -> bool;
+
   /**
    * @brief Sends a JSON-RPC notification.
    *
@@ -108,6 +287,39 @@ class Client {
       const std::string &method,
       std::optional<nlohmann::json> params = std::nullopt);
 
+  /**
+   * @brief Sends a notification to a prepared method.
+   *
+   * @param method The prepared method to notify.
+   * @param params Optional parameters to pass to the method.
+   */
+  void SendNotification(
+      const PreparedMethod &method,
+      std::optional<nlohmann::json> params = std::nullopt);
+
+  /**
+   * @brief Sends a batch of method calls and notifications as one message.
+   *
+   * The futures returned by Batch::AddMethodCall are resolved as the matching
+   * responses arrive. Calls the server leaves out of its batch response fail
+   * with std::runtime_error, as does every call of a batch that the server
+   * rejects as a whole. The client's default timeout applies to every call
+   * in the batch.
+   *
+   * @param batch The batch to send. It is consumed by this call.
+   * @throws std::runtime_error if sending fails. The batch's calls fail with
+   * the same error.
+   */
+  void SendBatch(Batch batch);
+
+  /**
+   * @brief Sends buffered auto-batched messages without waiting for the
+   * batching window to expire.
+   *
+   * Does nothing if auto-batching is disabled or the buffer is empty.
+   */
+  void Flush();
+
   /**
    * @brief Checks if there are any pending requests.
    *
@@ -115,32 +327,165 @@ class Client {
    */
   auto HasPendingRequests() const -> bool;
 
+  /**
+   * @brief Gets the number of calls waiting for a response.
+   *
+   * @return The number of pending calls.
+   */
+  [[nodiscard]] auto GetPendingRequestCount() const -> std::size_t;
+
+  /**
+   * @brief Gets the number of batches waiting for a response.
+   *
+   * @return The number of pending batches.
+   */
+  [[nodiscard]] auto GetPendingBatchCount() const -> std::size_t;
+
  private:
-  /// @brief Listener thread function for receiving responses from the transport
-  /// layer.
+  /**
+   * @brief Batches waiting for a response, keyed by their first request ID.
+   *
+   * Shared with the timeouts of the batches so that timer callbacks never
+   * outlive it.
+   */
+  class PendingBatches {
+   public:
+    /// @brief The request IDs of a batch: the first ID and the call count.
+    using Range = std::pair<int, int>;
+
+    /// @brief Registers a batch.
+    void Add(Range range);
+
+    /// @brief Removes the batch containing any of the IDs.
+    auto Take(const std::vector<int> &request_ids) -> std::optional<Range>;
+
+    /// @brief Removes the batch that was sent first.
+    auto TakeOldest() -> std::optional<Range>;
+
+    /// @brief Removes every batch.
+    void Clear();
+
+    /// @brief Checks if there are no batches, without locking.
+    [[nodiscard]] auto IsEmpty() const -> bool;
+
+    /// @brief Gets the number of batches.
+    [[nodiscard]] auto Size() const -> std::size_t;
+
+    /// @brief Gets the number of calls in all batches.
+    [[nodiscard]] auto CallCount() -> std::size_t;
+
+   private:
+    /// Mutex to protect access to the batches.
+    std::mutex mutex_;
+
+    /// Call count of each batch, by first request ID.
+    std::map<int, int> batches_;
+
+    /// Total call count of the batches.
+    std::size_t calls_ = 0;
+
+    /// Number of batches, readable without the mutex.
+    std::atomic<std::size_t> size_{0};
+  };
+
+  /**
+   * @brief Listener thread function for receiving responses from the transport
+   * layer.
+   *
+   * Blocks in the transport until a message arrives, so it uses no CPU while
+   * idle. Exits when the client is stopped or the transport fails.
+   */
   void Listener();
 
+  /**
+   * @brief Flusher thread function for auto-batching.
+   *
+   * Sends the buffered messages once the oldest one has waited for the
+   * configured window.
+   */
+  void Flusher();
+
+  /**
+   * @brief Serializes and sends a request, buffering it if auto-batching is
+   * on.
+   *
+   * @param request The request or notification to send.
+   */
+  void Send(const Request &request);
+
+  /**
+   * @brief Sends the buffered messages.
+   *
+   * A single buffered message is sent on its own rather than as a batch. If
+   * the transport fails, the buffered calls are failed with its exception;
+   * the lock is released meanwhile so that their callers can send again.
+   *
+   * @param lock A held lock on the outbox mutex.
+   */
+  void FlushOutboxLocked(std::unique_lock<std::mutex> &lock);
+
   /**
    * @brief Helper function to send a request and wait for a response.
    *
    * This function sends a JSON-RPC method call and waits for the response
-   * synchronously. It wraps the asynchronous request handling with
-   * blocking logic to return the result.
+   * synchronously. The listener thread only scans the response, and it is
+   * parsed on the calling thread.
    *
    * @param request The JSON-RPC request to be sent.
+   * @param timeout How long to wait for the response.
    * @return The JSON response received from the server.
    */
-  auto SendRequest(const Request &request) -> nlohmann::json;
+  auto SendRequest(
+      const Request &request,
+      std::optional<std::chrono::milliseconds> timeout) -> nlohmann::json;
+
+  /**
+   * @brief Sends a request whose response is delivered unparsed.
+   *
+   * @param request The JSON-RPC request to be sent.
+   * @param timeout How long to wait for the response.
+   * @return A future that will hold the scanned response.
+   * @throws std::runtime_error if sending fails before the call completes.
+   */
+  auto SendRequestRaw(
+      const Request &request, std::optional<std::chrono::milliseconds> timeout)
+      -> std::future<RawResponse>;
 
   /**
    * @brief Sends a request asynchronously.
    *
-   * This method handles the logic for sending asynchronous requests.
+   * The response is parsed on the thread that completes the call, since a
+   * std::future cannot defer work to its consumer.
    *
    * @param request The JSON-RPC request to be sent.
+   * @param timeout How long to wait for the response.
    * @return A future that will hold the JSON response from the server.
    */
-  auto SendRequestAsync(const Request &request) -> std::future<nlohmann::json>;
+  auto SendRequestAsync(
+      const Request &request, std::optional<std::chrono::milliseconds> timeout)
+      -> std::future<nlohmann::json>;
+
+  /**
+   * @brief Sends a request whose outcome is delivered to a waiter.
+   *
+   * @param request The JSON-RPC request to be sent.
+   * @param waiter The waiter to notify when the call completes.
+   * @param timeout How long to wait for the response.
+   * @throws std::runtime_error if sending fails before the call completes.
+   */
+  void SendRequestTo(
+      const Request &request, CallWaiter *waiter,
+      std::optional<std::chrono::milliseconds> timeout);
+
+  /**
+   * @brief Fails a pending call with TimeoutError once its timeout expires.
+   *
+   * @param request_id The ID of the pending call.
+   * @param timeout The call's own timeout, or std::nullopt to use the
+   * default. Does nothing if neither is set.
+   */
+  void ArmTimeout(
+      int request_id, std::optional<std::chrono::milliseconds> timeout);
 
   /**
    * @brief Generates the next unique request ID.
@@ -152,22 +497,80 @@ class Client {
   /**
    * @brief Handles a JSON-RPC response received from the transport layer.
    *
-   * Parses the response and resolves the associated promise with the response
-   * data.
+   * Scans the response for its ID without parsing the result and completes
+   * the associated call. Malformed, unsolicited and unknown messages are
+   * logged and dropped.
    *
    * @param response The JSON-RPC response as a string.
    */
-  void HandleResponse(const std::string &response);
+  void HandleResponse(std::string response);
+
+  /**
+   * @brief Handles a JSON-RPC batch response.
+   *
+   * Routes each element to its pending call, then fails any call of the same
+   * batch that the server did not answer.
+   *
+   * @param message The batch response.
+   * @param elements The byte ranges of the batch elements.
+   */
+  void HandleBatchResponse(
+      const std::shared_ptr<const std::string> &message,
+      const std::vector<RawResponse::Range> &elements);
+
+  /**
+   * @brief Routes a single scanned response to its pending call.
+   *
+   * @param response The scanned response.
+   * @return The request ID the response was routed to, or std::nullopt if it
+   * was dropped.
+   */
+  auto RouteResponse(RawResponse response) -> std::optional<int>;
+
+  /**
+   * @brief Forgets the batch a response belongs to and fails its unanswered
+   * calls.
+   *
+   * A response none of whose elements carries a request ID is taken as the
+   * rejection of the oldest batch, whose calls all fail.
+   *
+   * @param answered_ids IDs of the response's elements.
+   * @param message The response, reported to the calls of a rejected batch.
+   */
+  void ResolveBatch(std::vector<int> answered_ids, const std::string &message);
 
   /**
-   * @brief Validates a JSON-RPC response.
+   * @brief Checks whether a single response without a request ID rejects a
+   * whole batch.
+   *
+   * That is only assumed for an Invalid Request error with a null ID while
+   * every pending call belongs to a batch, since a single call's errors may
+   * carry a null ID as well.
    *
-   * Ensures that the response conforms to the JSON-RPC 2.0 specification.
+   * @param response The response, whose ID is not an integer.
+   */
+  [[nodiscard]] auto IsBatchRejection(const RawResponse &response) const
+      -> bool;
+
+  /**
+   * @brief Forgets the oldest batch and fails all of its calls.
    *
-   * @param response The JSON-RPC response as a JSON object.
-   * @return True if the response is valid, false otherwise.
+   * @param message The rejection, reported to the calls.
    */
-  static auto ValidateResponse(const nlohmann::json &response) -> bool;
+  void RejectOldestBatch(const std::string &message);
+
+  /**
+   * @brief Fails the calls of a batch that are still pending.
+   *
+   * @param range The request IDs of the batch.
+   * @param answered_ids Sorted IDs of the calls that must not be failed.
+   * @param message The error message reported to waiting callers.
+   */
+  void FailBatchCalls(
+      PendingBatches::Range range, const std::vector<int> &answered_ids,
+      const std::string &message);
+
+  friend class CallAwaitable;
 
   /// Transport layer for communication.
   std::unique_ptr<transport::Transport> transport_;
@@ -175,14 +578,45 @@ class Client {
   /// Counter for generating unique request IDs.
   std::atomic<int> req_id_counter_{0};
 
-  /// Number of expected responses.
-  std::atomic<int> expected_count_{0};
+  /// Lock-free table of pending requests and their associated promises.
+  /// Shared so that timer callbacks never outlive it.
+  std::shared_ptr<PendingCallTable> pending_calls_;
+
+  /// Timeout applied to calls that do not set their own.
+  std::optional<std::chrono::milliseconds> default_timeout_;
+
+  /// Timer wheel that expires timed-out calls.
+  std::shared_ptr<TimerWheel> timer_wheel_;
+
+  /// Outstanding batches. Shared so that timer callbacks never outlive it.
+  std::shared_ptr<PendingBatches> pending_batches_;
+
+  /// Auto-batching configuration.
+  AutoBatchOptions auto_batch_;
+
+  /// Buffered messages, as a JSON array that is not yet closed.
+  std::string outbox_;
+
+  /// Number of messages in the outbox.
+  std::size_t outbox_count_ = 0;
+
+  /// IDs of the calls in the outbox, failed if sending the batch fails.
+  std::vector<int> outbox_ids_;
+
+  /// Time by which the outbox must be sent.
+  std::chrono::steady_clock::time_point outbox_deadline_;
+
+  /// Mutex to protect the outbox and serialize batched sends.
+  std::mutex outbox_mutex_;
+
+  /// Wakes the flusher thread when the outbox fills or the client stops.
+  std::condition_variable outbox_cv_;
 
-  /// Map of pending requests and their associated promises.
-  std::unordered_map<int, std::promise<nlohmann::json>> requests_map_;
+  /// Set to stop the flusher thread.
+  bool flusher_stopping_ = false;
 
-  /// Mutex to protect access to the pending requests map.
-  mutable std::mutex requests_mutex_;
+  /// Flusher thread that sends the outbox when the window expires.
+  std::thread flusher_;
 
   /// Listener thread for receiving responses.
   std::thread listener_;
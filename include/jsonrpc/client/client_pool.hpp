@@ -0,0 +1,238 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "jsonrpc/client/client.hpp"
+#include "jsonrpc/client/hedging.hpp"
+#include "jsonrpc/client/timer_wheel.hpp"
+#include "jsonrpc/transport/transport.hpp"
+
+namespace jsonrpc::client {
+
+/// @brief Strategy used by ClientPool to pick a connection for each call.
+enum class LoadBalancing {
+  /// Cycle through the connections in order.
+  kRoundRobin,
+  /// Pick the connection with the fewest pending calls.
+  kLeastOutstanding,
+  /// Pick the less loaded of two connections chosen at random.
+  kPowerOfTwoChoices
+};
+
+/**
+ * @brief Configuration for a ClientPool.
+ */
+struct ClientPoolOptions {
+  /// @brief How calls are spread across the connections.
+  LoadBalancing load_balancing = LoadBalancing::kRoundRobin;
+
+  /// @brief Options applied to the client of every connection.
+  ClientOptions client;
+
+  /// @brief Hedging and retrying of idempotent method calls.
+  HedgingOptions hedging;
+};
+
+/**
+ * @brief A JSON-RPC client spread over several connections.
+ *
+ * Holds one Client, and therefore one listener thread, per transport. The
+ * transports may lead to the same endpoint or to replicas of a service. Each
+ * call is sent over a single connection picked by the configured load
+ * balancing strategy, and its response is matched on that connection.
+ *
+ * Method calls to methods listed in HedgingOptions::idempotent_methods may be
+ * sent again on another connection, either as a hedge when the call is slow
+ * or as a retry when it fails. The first response wins and the remaining
+ * attempts are abandoned. Coroutine calls, batches and notifications are
+ * never hedged or retried.
+ */
+class ClientPool {
+ public:
+  /**
+   * @brief Constructs a ClientPool.
+   *
+   * @param transports The connections to spread calls over.
+   * @param options The pool configuration.
+   * @throws std::invalid_argument if no transports are given.
+   */
+  explicit ClientPool(
+      std::vector<std::unique_ptr<transport::Transport>> transports,
+      ClientPoolOptions options = {});
+
+  /// @brief Destructor. Stops every client that is still running.
+  ~ClientPool();
+
+  ClientPool(const ClientPool &) = delete;
+  auto operator=(const ClientPool &) -> ClientPool & = delete;
+
+  ClientPool(ClientPool &&) = delete;
+  auto operator=(ClientPool &&) -> ClientPool & = delete;
+
+  /// @brief Starts the listener thread of every connection.
+  void Start();
+
+  /// @brief Stops every connection. See Client::Stop().
+  void Stop();
+
+  /// @brief Checks if the connections are running.
+  [[nodiscard]] auto IsRunning() const -> bool;
+
+  /// @brief Gets the number of connections.
+  [[nodiscard]] auto Size() const -> std::size_t;
+
+  /// @brief See Client::SendMethodCall().
+  auto SendMethodCall(
+      const std::string &method,
+      std::optional<nlohmann::json> params = std::nullopt,
+      std::optional<std::chrono::milliseconds> timeout = std::nullopt)
+      -> nlohmann::json;
+
+  /// @brief See Client::SendMethodCallAsync().
+  auto SendMethodCallAsync(
+      const std::string &method,
+      std::optional<nlohmann::json> params = std::nullopt,
+      std::optional<std::chrono::milliseconds> timeout = std::nullopt)
+      -> std::future<nlohmann::json>;
+
+  /// @brief See Client::Call().
+  auto Call(
+      const std::string &method,
+      std::optional<nlohmann::json> params = std::nullopt,
+      std::shared_ptr<executor::Executor> executor = nullptr,
+      std::optional<std::chrono::milliseconds> timeout = std::nullopt)
+      -> CallAwaitable;
+
+  /// @brief See Client::SendNotification().
+  void SendNotification(
+      const std::string &method,
+      std::optional<nlohmann::json> params = std::nullopt);
+
+  /// @brief See Client::SendBatch(). The whole batch uses one connection.
+  void SendBatch(Batch batch);
+
+  /// @brief Checks if any connection has pending requests.
+  [[nodiscard]] auto HasPendingRequests() const -> bool;
+
+ private:
+  struct HedgedCall;
+  struct Attempt;
+
+  /**
+   * @brief Picks the connection for the next call.
+   *
+   * @return The index of the selected client.
+   */
+  auto SelectIndex() -> std::size_t;
+
+  /**
+   * @brief Picks the connection for the next call.
+   *
+   * @return The selected client.
+   */
+  auto SelectClient() -> Client &;
+
+  /**
+   * @brief Checks if calls to a method may be hedged or retried.
+   *
+   * @param method The name of the method.
+   * @return True if the method is idempotent and extra attempts are allowed.
+   */
+  [[nodiscard]] auto IsHedged(const std::string &method) const -> bool;
+
+  /**
+   * @brief Sends a call that may be hedged or retried.
+   *
+   * @param method The name of the method to call.
+   * @param params Optional parameters to pass to the method.
+   * @param timeout How long each attempt waits for its response.
+   * @return A future holding the first response of any attempt.
+   */
+  auto SendHedged(
+      const std::string &method, std::optional<nlohmann::json> params,
+      std::optional<std::chrono::milliseconds> timeout)
+      -> std::future<nlohmann::json>;
+
+  /**
+   * @brief Sends one more attempt of a call, preferring an unused connection.
+   *
+   * @param call The call to send.
+   */
+  void LaunchAttempt(const std::shared_ptr<HedgedCall> &call);
+
+  /**
+   * @brief Arms the timer that sends a hedge if the call is still running.
+   *
+   * @param call The call to hedge.
+   */
+  void ScheduleHedge(const std::shared_ptr<HedgedCall> &call);
+
+  /**
+   * @brief Completes a call with the first response of any attempt.
+   *
+   * @param call The call the attempt belongs to.
+   * @param attempt The attempt that received the response.
+   * @param response The response.
+   */
+  void OnAttemptResponse(
+      const std::shared_ptr<HedgedCall> &call, Attempt &attempt,
+      RawResponse response);
+
+  /**
+   * @brief Retries a call or fails it once its last attempt has failed.
+   *
+   * @param call The call the attempt belongs to.
+   * @param attempt The attempt that failed.
+   * @param error The exception describing the failure.
+   */
+  void OnAttemptError(
+      const std::shared_ptr<HedgedCall> &call, Attempt &attempt,
+      std::exception_ptr error);
+
+  /**
+   * @brief Cancels a pending hedge timer while the pool is alive.
+   *
+   * @param timer The timer to cancel, if any.
+   */
+  void CancelHedge(std::optional<TimerWheel::TimerId> timer);
+
+  /// @brief One client per connection.
+  std::vector<std::unique_ptr<Client>> clients_;
+
+  /// @brief How calls are spread across the connections.
+  LoadBalancing load_balancing_;
+
+  /// @brief Rotating cursor for round-robin and tie breaking.
+  std::atomic<std::size_t> next_{0};
+
+  /// @brief Hedging and retry configuration.
+  HedgingOptions hedging_;
+
+  /// @brief Budget shared by all hedges and retries.
+  RetryBudget budget_;
+
+  /// @brief Recent call latencies, used to pick the hedge delay.
+  LatencyTracker latencies_;
+
+  /// @brief Held shared while using the hedge timer wheel, and exclusively
+  /// by the destructor to mark the pool as stopping.
+  std::shared_mutex lifetime_mutex_;
+
+  /// @brief Set once the pool is being destroyed.
+  std::atomic<bool> stopping_{false};
+
+  /// @brief Fine-grained timer wheel for hedge delays, if hedging is on.
+  std::unique_ptr<TimerWheel> hedge_timers_;
+};
+
+}  // namespace jsonrpc::client
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace jsonrpc::client {
+
+/**
+ * @brief Configuration for hedged and retried calls in a ClientPool.
+ *
+ * Only methods listed as idempotent are ever sent more than once. A hedge is
+ * a duplicate sent to another connection when a call is slower than the
+ * configured latency percentile; a retry is sent when every attempt so far
+ * has failed. Both draw from the same retry budget.
+ */
+struct HedgingOptions {
+  /// @brief Methods that are safe to send more than once.
+  std::unordered_set<std::string> idempotent_methods;
+
+  /// @brief Maximum attempts per call, counting the first. One disables.
+  std::size_t max_attempts = 2;
+
+  /// @brief Send hedges for slow calls, not only retries for failed ones.
+  bool hedge = true;
+
+  /// @brief Latency percentile, in (0, 1], after which a hedge is sent.
+  double hedge_percentile = 0.95;
+
+  /// @brief Hedge delay used until enough latencies have been observed.
+  std::chrono::milliseconds initial_hedge_delay{10};
+
+  /// @brief Extra attempts earned by each call, e.g. 0.1 for 10%.
+  double budget_ratio = 0.1;
+
+  /// @brief Extra attempts that can be banked, so quiet clients can retry.
+  std::size_t budget_reserve = 10;
+};
+
+/**
+ * @brief Token bucket limiting hedges and retries to a share of traffic.
+ *
+ * Every call deposits a fraction of a token and every extra attempt
+ * withdraws a whole one, so a failing backend cannot be hit with more than
+ * `ratio` times the original load plus the banked reserve.
+ */
+class RetryBudget {
+ public:
+  /**
+   * @brief Constructs a RetryBudget with a full reserve.
+   *
+   * @param ratio Extra attempts earned by each call.
+   * @param reserve Maximum number of banked extra attempts.
+   */
+  RetryBudget(double ratio, std::size_t reserve);
+
+  /// @brief Records a call, earning `ratio` extra attempts.
+  void Deposit();
+
+  /**
+   * @brief Takes one extra attempt from the budget.
+   *
+   * @return True if the budget allowed the attempt.
+   */
+  auto TryWithdraw() -> bool;
+
+ private:
+  /// @brief Tokens are kept in thousandths to stay integral.
+  static constexpr std::int64_t kScale = 1000;
+
+  std::int64_t deposit_;
+  std::int64_t capacity_;
+  std::atomic<std::int64_t> balance_;
+};
+
+/**
+ * @brief Tracks a latency percentile over a window of recent calls.
+ *
+ * The percentile is recomputed every few samples rather than on every
+ * query, so reading it on the call path is cheap.
+ */
+class LatencyTracker {
+ public:
+  /**
+   * @brief Constructs a LatencyTracker.
+   *
+   * @param percentile The percentile to track, in (0, 1].
+   * @param window Number of recent samples kept.
+   */
+  explicit LatencyTracker(double percentile, std::size_t window = 512);
+
+  /**
+   * @brief Records the latency of a completed call.
+   *
+   * @param latency The observed latency.
+   */
+  void Record(std::chrono::microseconds latency);
+
+  /**
+   * @brief Gets the tracked percentile.
+   *
+   * @return The percentile, or std::nullopt until enough samples exist.
+   */
+  [[nodiscard]] auto Get() const -> std::optional<std::chrono::microseconds>;
+
+ private:
+  /// @brief Samples needed before the percentile is reported, and the
+  /// number of samples between recomputations.
+  static constexpr std::size_t kRefreshInterval = 32;
+
+  double percentile_;
+  mutable std::mutex mutex_;
+  std::vector<std::int64_t> samples_;
+  std::size_t next_ = 0;
+  std::size_t count_ = 0;
+  std::optional<std::chrono::microseconds> cached_;
+};
+
+}  // namespace jsonrpc::client
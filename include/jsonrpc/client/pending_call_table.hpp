@@ -0,0 +1,230 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <variant>
+
+#include <nlohmann/json.hpp>
+
+#include "jsonrpc/client/raw_response.hpp"
+
+namespace jsonrpc::client {
+
+/**
+ * @brief Receives the outcome of a call registered without a promise.
+ *
+ * Used by awaitable calls, which keep their result in the coroutine frame
+ * rather than in a std::promise shared state. Exactly one of the two
+ * functions is called, on the thread that completes the call.
+ */
+class CallWaiter {
+ public:
+  CallWaiter() = default;
+  virtual ~CallWaiter() = default;
+
+  CallWaiter(const CallWaiter &) = delete;
+  auto operator=(const CallWaiter &) -> CallWaiter & = delete;
+
+  CallWaiter(CallWaiter &&) = delete;
+  auto operator=(CallWaiter &&) -> CallWaiter & = delete;
+
+  /**
+   * @brief Called with the response when the call completes.
+   *
+   * @param response The scanned response. Parsing it is left to the waiter.
+   */
+  virtual void OnResponse(RawResponse response) = 0;
+
+  /**
+   * @brief Called when the call fails.
+   *
+   * @param error The exception describing the failure.
+   */
+  virtual void OnError(std::exception_ptr error) = 0;
+};
+
+/**
+ * @brief Table of in-flight method calls keyed by sequential request ID.
+ *
+ * Calls live in a fixed ring of slots indexed by `id % capacity`. Each slot is
+ * tagged with the full ID it holds, which doubles as a generation counter:
+ * a slot is claimed and released with a single compare-and-swap, so
+ * registering and completing a call take no lock and allocate nothing.
+ *
+ * If more than `capacity` calls are outstanding and an ID lands on a slot
+ * that is still occupied, the call falls back to a mutex-protected overflow
+ * map. That path is only taken under extreme backlog.
+ */
+class PendingCallTable {
+ public:
+  /// @brief The promise fulfilled when a call completes.
+  using Promise = std::promise<nlohmann::json>;
+
+  /// @brief A promise fulfilled with the unparsed response.
+  using RawPromise = std::promise<RawResponse>;
+
+  /// @brief Default number of slots.
+  static constexpr std::size_t kDefaultCapacity = 1024;
+
+  /**
+   * @brief Constructs a PendingCallTable.
+   *
+   * @param capacity Number of slots, rounded up to a power of two.
+   */
+  explicit PendingCallTable(std::size_t capacity = kDefaultCapacity);
+
+  PendingCallTable(const PendingCallTable &) = delete;
+  auto operator=(const PendingCallTable &) -> PendingCallTable & = delete;
+
+  PendingCallTable(PendingCallTable &&) = delete;
+  auto operator=(PendingCallTable &&) -> PendingCallTable & = delete;
+
+  ~PendingCallTable() = default;
+
+  /**
+   * @brief Registers a pending call.
+   *
+   * @param id The request ID. Must not already be registered.
+   * @param promise The promise to fulfil when the call completes.
+   */
+  void Add(int id, Promise promise);
+
+  /**
+   * @brief Registers a pending call that completes with the raw response.
+   *
+   * @param id The request ID. Must not already be registered.
+   * @param promise The promise to fulfil when the call completes.
+   */
+  void Add(int id, RawPromise promise);
+
+  /**
+   * @brief Registers a pending call that completes through a waiter.
+   *
+   * @param id The request ID. Must not already be registered.
+   * @param waiter The waiter to notify. Must stay alive until notified or
+   * removed.
+   */
+  void Add(int id, CallWaiter *waiter);
+
+  /**
+   * @brief Completes a pending call with its response.
+   *
+   * Calls registered with a Promise receive the parsed response, or the
+   * parse error if it is malformed. Other calls receive it unparsed.
+   *
+   * @param id The request ID.
+   * @param response The response to deliver.
+   * @return True if the call was pending, false if the ID is unknown.
+   */
+  auto Complete(int id, RawResponse response) -> bool;
+
+  /**
+   * @brief Fails a single pending call.
+   *
+   * @param id The request ID.
+   * @param error The exception delivered to the waiting caller.
+   * @return True if the call was pending, false if the ID is unknown.
+   */
+  auto Fail(int id, std::exception_ptr error) -> bool;
+
+  /**
+   * @brief Removes a pending call without completing it.
+   *
+   * @param id The request ID.
+   * @return True if the call was pending, false if the ID is unknown.
+   */
+  auto Remove(int id) -> bool;
+
+  /**
+   * @brief Fails every pending call.
+   *
+   * @param message The error message reported to waiting callers.
+   */
+  void FailAll(const std::string &message);
+
+  /// @brief Checks if there are no pending calls.
+  [[nodiscard]] auto IsEmpty() const -> bool;
+
+  /// @brief Gets the number of pending calls.
+  [[nodiscard]] auto Size() const -> std::size_t;
+
+ private:
+  /// @brief Size of a cache line, used to keep slots from false sharing.
+  static constexpr std::size_t kCacheLineSize = 64;
+
+  /// @brief Slot state: free.
+  static constexpr std::uint64_t kFree = 0;
+
+  /// @brief Slot state: being claimed or released.
+  static constexpr std::uint64_t kBusy = 1;
+
+  /// @brief A pending call: a promise or a waiter to notify.
+  using Entry = std::variant<Promise, RawPromise, CallWaiter *>;
+
+  /// @brief A ring slot holding at most one pending call.
+  struct alignas(kCacheLineSize) Slot {
+    std::atomic<std::uint64_t> state{kFree};
+    std::optional<Entry> entry;
+  };
+
+  /**
+   * @brief Converts a request ID into the tag stored in an occupied slot.
+   *
+   * @param id The request ID.
+   * @return The slot tag.
+   */
+  static auto Tag(int id) -> std::uint64_t;
+
+  /**
+   * @brief Registers a pending call entry.
+   *
+   * @param id The request ID.
+   * @param entry The entry to store.
+   */
+  void AddEntry(int id, Entry entry);
+
+  /**
+   * @brief Removes a pending call and returns its entry.
+   *
+   * @param id The request ID.
+   * @return The entry, or std::nullopt if the ID is unknown.
+   */
+  auto Take(int id) -> std::optional<Entry>;
+
+  /**
+   * @brief Fails an entry that has been taken from the table.
+   *
+   * @param entry The entry to fail.
+   * @param error The exception to deliver.
+   */
+  static void FailEntry(Entry &entry, std::exception_ptr error);
+
+  /// @brief The ring of slots.
+  std::unique_ptr<Slot[]> slots_;
+
+  /// @brief Mask used to map an ID to its slot index.
+  std::size_t mask_;
+
+  /// @brief Number of pending calls, including overflowed ones.
+  std::atomic<std::size_t> size_{0};
+
+  /// @brief Number of overflowed calls, read without the mutex so that a
+  /// lookup that misses its slot only locks while the overflow map is used.
+  std::atomic<std::size_t> overflow_size_{0};
+
+  /// @brief Mutex to protect the overflow map.
+  mutable std::mutex overflow_mutex_;
+
+  /// @brief Calls whose slot was still occupied when they were registered.
+  std::unordered_map<int, Entry> overflow_;
+};
+
+}  // namespace jsonrpc::client
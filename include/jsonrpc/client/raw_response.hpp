@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace jsonrpc::client {
+
+/**
+ * @brief A JSON-RPC response that has been scanned but not parsed.
+ *
+ * Scanning walks the top level of the response object only: it checks the
+ * `jsonrpc` member, reads the ID and records where the `result` or `error`
+ * value starts and ends. The result itself is not parsed until it is asked
+ * for, which lets the client's listener thread route large responses without
+ * building a DOM and leaves the parsing to whichever thread consumes them.
+ *
+ * Responses from one batch share the buffer they were received in.
+ */
+class RawResponse {
+ public:
+  /// @brief A [begin, end) byte range within a message.
+  using Range = std::pair<std::size_t, std::size_t>;
+
+  /**
+   * @brief Scans a response that is a whole message.
+   *
+   * @param message The received message.
+   * @return The scanned response.
+   * @throws std::runtime_error if the message is not a valid response.
+   */
+  static auto Scan(std::string message) -> RawResponse;
+
+  /**
+   * @brief Scans a response stored in part of a shared buffer.
+   *
+   * @param message The buffer holding the response.
+   * @param range The byte range of the response within the buffer.
+   * @return The scanned response.
+   * @throws std::runtime_error if the range is not a valid response.
+   */
+  static auto Scan(std::shared_ptr<const std::string> message, Range range)
+      -> RawResponse;
+
+  /**
+   * @brief Splits a batch response into the ranges of its elements.
+   *
+   * @param message The received message.
+   * @return The element ranges, or std::nullopt if the message is not an
+   * array.
+   * @throws std::runtime_error if the array is malformed.
+   */
+  static auto SplitBatch(std::string_view message)
+      -> std::optional<std::vector<Range>>;
+
+  /// @brief Gets the ID, or std::nullopt if it is not an integer.
+  [[nodiscard]] auto GetId() const -> std::optional<int>;
+
+  /// @brief Gets the ID exactly as it appears in the message.
+  [[nodiscard]] auto GetRawId() const -> std::string_view;
+
+  /// @brief Checks if the response carries an error instead of a result.
+  [[nodiscard]] auto IsError() const -> bool;
+
+  /// @brief Gets the unparsed `result` or `error` value.
+  [[nodiscard]] auto GetRawValue() const -> std::string_view;
+
+  /**
+   * @brief Parses the result.
+   *
+   * @return The `result` value.
+   * @throws std::runtime_error if the response is an error.
+   * @throws nlohmann::json::parse_error if the result is malformed.
+   */
+  [[nodiscard]] auto GetResult() const -> nlohmann::json;
+
+  /**
+   * @brief Gets the error object.
+   *
+   * @return The `error` value, or null if the response is a result.
+   */
+  [[nodiscard]] auto GetError() const -> nlohmann::json;
+
+  /// @brief Gets the whole unparsed response.
+  [[nodiscard]] auto GetRaw() const -> std::string_view;
+
+  /**
+   * @brief Parses the whole response.
+   *
+   * @return The response object.
+   * @throws nlohmann::json::parse_error if the response is malformed.
+   */
+  [[nodiscard]] auto ToJson() const -> nlohmann::json;
+
+ private:
+  RawResponse() = default;
+
+  /// @brief The buffer the response lives in.
+  std::shared_ptr<const std::string> message_;
+
+  /// @brief The range of the whole response.
+  Range range_{0, 0};
+
+  /// @brief The range of the ID value.
+  Range id_range_{0, 0};
+
+  /// @brief The range of the result or error value.
+  Range value_range_{0, 0};
+
+  /// @brief The ID, if it is an integer.
+  std::optional<int> id_;
+
+  /// @brief The error object, parsed while scanning to validate it.
+  std::optional<nlohmann::json> error_;
+};
+
+}  // namespace jsonrpc::client
@@ -8,6 +8,42 @@
 
 namespace jsonrpc::client {
 
+/**
+ * @brief A method name whose request prefix is serialized once.
+ *
+ * Holds the constant `{"jsonrpc":"2.0","method":"..."` start of every request
+ * for the method, so sending a call only appends the params and the ID
+ * instead of building and dumping a JSON object. Create one per method that
+ * is called often and pass it to the Client instead of the method name.
+ */
+class PreparedMethod {
+ public:
+  /**
+   * @brief Prepares a method.
+   *
+   * @param method The name of the method.
+   */
+  explicit PreparedMethod(std::string method);
+
+  /// @brief Gets the name of the method.
+  [[nodiscard]] auto GetName() const -> const std::string &;
+
+  /// @brief Gets the serialized request prefix.
+  [[nodiscard]] auto GetPrefix() const -> const std::string &;
+
+  /**
+   * @brief Appends the request prefix for a method to a buffer.
+   *
+   * @param buffer The buffer to append to.
+   * @param method The name of the method.
+   */
+  static void AppendPrefix(std::string &buffer, const std::string &method);
+
+ private:
+  std::string name_;
+  std::string prefix_;
+};
+
 /**
  * @brief Represents a JSON-RPC request.
  *
@@ -29,6 +65,19 @@ class Request {
       std::string method, std::optional<nlohmann::json> params,
       bool is_notification, const std::function<int()> &id_generator);
 
+  /**
+   * @brief Constructs a new Request object for a prepared method.
+   *
+   * @param method The prepared method. Must outlive the request.
+   * @param params Optional parameters to be passed with the request.
+   * @param is_notification True if this is a notification (no response
+   * expected).
+   * @param id_generator A function to generate unique request IDs.
+   */
+  Request(
+      const PreparedMethod &method, std::optional<nlohmann::json> params,
+      bool is_notification, const std::function<int()> &id_generator);
+
   /// @brief Checks if the request requires a response.
   [[nodiscard]] auto RequiresResponse() const -> bool;
 
@@ -38,8 +87,19 @@ class Request {
   /// @brief Serializes the request to a JSON string.
   [[nodiscard]] auto Dump() const -> std::string;
 
+  /**
+   * @brief Appends the serialized request to a buffer.
+   *
+   * Lets callers reuse one buffer across requests instead of allocating a
+   * string per request.
+   *
+   * @param buffer The buffer to append to.
+   */
+  void DumpTo(std::string &buffer) const;
+
  private:
   std::string method_;
+  const PreparedMethod *prepared_ = nullptr;
   std::optional<nlohmann::json> params_;
   bool is_notification_;
   int id_;
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace jsonrpc::client {
+
+/**
+ * @brief Hashed timer wheel for coarse-grained timeouts.
+ *
+ * Timers are stored in a fixed ring of slots, each covering one tick. A timer
+ * that is further away than one revolution of the ring records how many full
+ * rounds it still has to wait. Scheduling and cancelling are O(1), and a
+ * single background thread advances the wheel one tick at a time, so
+ * thousands of outstanding timeouts cost one thread and no per-timer
+ * allocation of OS resources.
+ *
+ * Each timer is a node linked into its slot's list. Nodes come from a pool
+ * that only grows to the peak number of pending timers, and a callback whose
+ * size is at most kInlineCallbackSize is stored inside its node, so once the
+ * pool is warm, scheduling allocates nothing.
+ *
+ * Timers fire at most one tick late. The background thread is created on the
+ * first scheduled timer and sleeps while no timers are pending. Callbacks run
+ * on that thread and must be short.
+ */
+class TimerWheel {
+ public:
+  /// @brief Identifies a scheduled timer.
+  using TimerId = std::uint64_t;
+
+  /// @brief The callback invoked when a timer expires.
+  using Callback = std::function<void()>;
+
+  /// @brief Default tick duration.
+  static constexpr std::chrono::milliseconds kDefaultTick{10};
+
+  /// @brief Default number of slots.
+  static constexpr std::size_t kDefaultSlotCount = 512;
+
+  /// @brief Largest callback stored in its timer without a std::function.
+  static constexpr std::size_t kInlineCallbackSize = 48;
+
+  /**
+   * @brief Constructs a TimerWheel.
+   *
+   * @param tick The resolution of the wheel.
+   * @param num_slots The number of slots in the ring. Zero is treated as one.
+   */
+  explicit TimerWheel(
+      std::chrono::milliseconds tick = kDefaultTick,
+      std::size_t num_slots = kDefaultSlotCount);
+
+  /// @brief Stops the background thread. Pending timers never fire.
+  ~TimerWheel();
+
+  TimerWheel(const TimerWheel &) = delete;
+  auto operator=(const TimerWheel &) -> TimerWheel & = delete;
+
+  TimerWheel(TimerWheel &&) = delete;
+  auto operator=(TimerWheel &&) -> TimerWheel & = delete;
+
+  /**
+   * @brief Schedules a callback to run after a delay.
+   *
+   * @param delay How long to wait. Rounded up to whole ticks, at least one.
+   * @param callback The callable to run on the wheel's thread.
+   * @return The ID of the timer, usable with Cancel().
+   */
+  template <typename F>
+  auto Schedule(std::chrono::milliseconds delay, F &&callback) -> TimerId {
+    using Stored = std::conditional_t<
+        FitsInline<std::decay_t<F>>, std::decay_t<F>, Callback>;
+    Stored stored(std::forward<F>(callback));
+    return ScheduleStored(delay, &stored, kOps<Stored>);
+  }
+
+  /**
+   * @brief Cancels a pending timer.
+   *
+   * @param id The ID returned by Schedule().
+   * @return True if the timer was pending, false if it already fired or was
+   * cancelled.
+   */
+  auto Cancel(TimerId id) -> bool;
+
+  /// @brief Gets the number of pending timers.
+  [[nodiscard]] auto Size() const -> std::size_t;
+
+  /**
+   * @brief Gets the process-wide shared timer wheel.
+   *
+   * The wheel is created on first use with the default tick and slot count.
+   *
+   * @return The shared timer wheel.
+   */
+  static auto GetShared() -> std::shared_ptr<TimerWheel>;
+
+ private:
+  /// @brief Type-erased operations on a callback stored in a timer.
+  struct CallbackOps {
+    /// Move-constructs the callback at `to` from `from`.
+    void (*move_to)(void *from, void *to) noexcept;
+    /// Runs the callback.
+    void (*invoke)(void *callback);
+    /// Destroys the callback.
+    void (*destroy)(void *callback) noexcept;
+  };
+
+  /// @brief Whether a callable can be stored inside a timer.
+  template <typename Fn>
+  static constexpr bool FitsInline =
+      sizeof(Fn) <= kInlineCallbackSize &&
+      alignof(Fn) <= alignof(std::max_align_t) &&
+      std::is_nothrow_move_constructible_v<Fn>;
+
+  /// @brief The operations for callables of type Fn.
+  template <typename Fn>
+  static constexpr CallbackOps kOps{
+      [](void *from, void *to) noexcept {
+        new (to) Fn(std::move(*static_cast<Fn *>(from)));
+      },
+      [](void *callback) { (*static_cast<Fn *>(callback))(); },
+      [](void *callback) noexcept { static_cast<Fn *>(callback)->~Fn(); },
+  };
+
+  /// @brief A timer node, linked into a slot's list while it is pending.
+  struct Timer {
+    Timer *prev = nullptr;
+    Timer *next = nullptr;
+    /// Slot whose list holds the timer.
+    std::size_t slot = 0;
+    /// Full revolutions left before the timer expires.
+    std::size_t rounds = 0;
+    /// Position of the node in the pool.
+    std::uint32_t index = 0;
+    /// Bumped each time the node is reused, so stale IDs are rejected.
+    std::uint32_t generation = 0;
+    /// Set while the timer is linked into a slot.
+    bool pending = false;
+    /// Operations on the stored callback, or null if there is none.
+    const CallbackOps *ops = nullptr;
+    /// Storage for the callback.
+    alignas(std::max_align_t) std::byte callback[kInlineCallbackSize];
+  };
+
+  /**
+   * @brief Links a timer holding the given callback into the wheel.
+   *
+   * @param delay How long to wait.
+   * @param callback The callback, moved into the timer.
+   * @param ops The operations for the callback's type.
+   * @return The ID of the timer.
+   */
+  auto ScheduleStored(
+      std::chrono::milliseconds delay, void *callback, const CallbackOps &ops)
+      -> TimerId;
+
+  /// @brief Unlinks a timer from its slot. Requires the mutex.
+  void Unlink(Timer &timer);
+
+  /// @brief Destroys a timer's callback and returns the node to the pool.
+  /// Requires the mutex.
+  void Release(Timer &timer);
+
+  /// @brief Main loop of the background thread.
+  void Run();
+
+  /// @brief Duration of one tick.
+  std::chrono::milliseconds tick_;
+
+  /// @brief The ring of slots, each the head of a list of the timers due in
+  /// that tick.
+  std::vector<Timer *> slots_;
+
+  /// @brief Every timer node ever created. A deque keeps nodes in place as
+  /// the pool grows.
+  std::deque<Timer> pool_;
+
+  /// @brief Nodes not in use, linked through `next`.
+  Timer *free_list_ = nullptr;
+
+  /// @brief Number of pending timers.
+  std::size_t size_ = 0;
+
+  /// @brief Slot the wheel last processed.
+  std::size_t cursor_ = 0;
+
+  /// @brief Time at which the wheel advances to the next slot.
+  std::chrono::steady_clock::time_point next_tick_;
+
+  /// @brief Flag to stop the background thread.
+  bool stopping_ = false;
+
+  /// @brief Mutex to protect the wheel state.
+  mutable std::mutex mutex_;
+
+  /// @brief Wakes the background thread when timers arrive or on shutdown.
+  std::condition_variable cv_;
+
+  /// @brief Background thread advancing the wheel.
+  std::thread thread_;
+};
+
+}  // namespace jsonrpc::client
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <functional>
+#include <future>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace jsonrpc::executor {
+
+/// @brief Type alias for a unit of work submitted to an executor.
+using Task = std::function<void()>;
+
+/**
+ * @brief Base class for task executors.
+ *
+ * An executor decides where and when submitted work runs. The dispatcher uses
+ * it to fan out batch requests, which lets several servers share one pool of
+ * threads instead of each owning its own.
+ */
+class Executor {
+ public:
+  Executor() = default;
+  virtual ~Executor() = default;
+
+  Executor(const Executor &) = delete;
+  auto operator=(const Executor &) -> Executor & = delete;
+
+  Executor(Executor &&) = delete;
+  auto operator=(Executor &&) -> Executor & = delete;
+
+  /**
+   * @brief Schedules a task for execution.
+   *
+   * @param task The task to run.
+   */
+  virtual void Execute(Task task) = 0;
+
+  /**
+   * @brief Schedules a callable and returns a future for its result.
+   *
+   * @param func The callable to run. It must be invocable with no arguments.
+   * @return A future that will hold the result of the callable.
+   */
+  template <typename Func>
+  auto Submit(Func &&func)
+      -> std::future<std::invoke_result_t<std::decay_t<Func>>> {
+    using Result = std::invoke_result_t<std::decay_t<Func>>;
+    auto packaged_task = std::make_shared<std::packaged_task<Result()>>(
+        std::forward<Func>(func));
+    auto future = packaged_task->get_future();
+    Execute([packaged_task]() { (*packaged_task)(); });
+    return future;
+  }
+};
+
+}  // namespace jsonrpc::executor
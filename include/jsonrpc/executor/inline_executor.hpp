@@ -0,0 +1,18 @@
+#pragma once
+
+#include "jsonrpc/executor/executor.hpp"
+
+namespace jsonrpc::executor {
+
+/**
+ * @brief Executor that runs every task immediately on the calling thread.
+ *
+ * Useful for single-threaded servers and for tests that need deterministic
+ * ordering.
+ */
+class InlineExecutor : public Executor {
+ public:
+  void Execute(Task task) override;
+};
+
+}  // namespace jsonrpc::executor
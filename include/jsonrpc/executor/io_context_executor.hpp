@@ -0,0 +1,31 @@
+#pragma once
+
+#include <asio.hpp>
+
+#include "jsonrpc/executor/executor.hpp"
+
+namespace jsonrpc::executor {
+
+/**
+ * @brief Executor adapter that posts tasks to an existing asio::io_context.
+ *
+ * Tasks run on whichever threads are driving the io_context. The io_context
+ * must outlive the executor.
+ */
+class IoContextExecutor : public Executor {
+ public:
+  /**
+   * @brief Constructs an IoContextExecutor.
+   *
+   * @param io_context The io_context to post tasks to.
+   */
+  explicit IoContextExecutor(asio::io_context &io_context);
+
+  void Execute(Task task) override;
+
+ private:
+  /// @brief The io_context that runs the tasks.
+  asio::io_context &io_context_;
+};
+
+}  // namespace jsonrpc::executor
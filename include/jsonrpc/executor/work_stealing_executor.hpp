@@ -0,0 +1,183 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "jsonrpc/executor/executor.hpp"
+
+namespace jsonrpc::executor {
+
+/**
+ * @brief Configuration for a WorkStealingExecutor.
+ */
+struct WorkStealingOptions {
+  /// @brief Number of worker threads. Zero is treated as one.
+  std::size_t num_threads = std::thread::hardware_concurrency();
+
+  /// @brief Defer creating the workers until the first task is submitted.
+  bool lazy_start = true;
+
+  /**
+   * @brief CPUs to pin workers to.
+   *
+   * Worker i is pinned to cpu_set[i % cpu_set.size()]. Takes precedence over
+   * numa_node when both are set. Ids outside [0, CPU_SETSIZE) are rejected
+   * with std::invalid_argument.
+   */
+  std::vector<int> cpu_set;
+
+  /// @brief NUMA node whose CPUs the workers are restricted to.
+  std::optional<int> numa_node;
+};
+
+/**
+ * @brief Thread pool executor with per-worker task queues and work stealing.
+ *
+ * Each worker owns a deque. Tasks submitted from outside the pool are spread
+ * across the deques round-robin, and tasks submitted from a worker go to that
+ * worker's own deque. Idle workers steal from the front of other deques, so
+ * batch fan-out never funnels through a single shared queue.
+ *
+ * By default the workers are only created when the first task arrives, so a
+ * server that never receives a batch pays nothing for the pool. A single
+ * instance is meant to be shared by all dispatchers in a process; see
+ * GetShared().
+ *
+ * CPU and NUMA pinning are only supported on Linux. Elsewhere the options are
+ * accepted and ignored with a warning.
+ */
+class WorkStealingExecutor : public Executor {
+ public:
+  /**
+   * @brief Constructs a lazily started WorkStealingExecutor.
+   *
+   * @param num_threads Number of worker threads. Zero is treated as one.
+   */
+  explicit WorkStealingExecutor(
+      std::size_t num_threads = std::thread::hardware_concurrency());
+
+  /**
+   * @brief Constructs a WorkStealingExecutor from options.
+   *
+   * @param options The pool configuration.
+   * @throws std::invalid_argument if the NUMA node does not exist.
+   */
+  explicit WorkStealingExecutor(const WorkStealingOptions &options);
+
+  /// @brief Runs all queued tasks to completion and joins the workers.
+  ~WorkStealingExecutor() override;
+
+  WorkStealingExecutor(const WorkStealingExecutor &) = delete;
+  auto operator=(const WorkStealingExecutor &)
+      -> WorkStealingExecutor & = delete;
+
+  WorkStealingExecutor(WorkStealingExecutor &&) = delete;
+  auto operator=(WorkStealingExecutor &&) -> WorkStealingExecutor & = delete;
+
+  void Execute(Task task) override;
+
+  /// @brief Gets the number of worker threads.
+  [[nodiscard]] auto GetThreadCount() const -> std::size_t;
+
+  /// @brief Checks if the worker threads have been created.
+  [[nodiscard]] auto IsStarted() const -> bool;
+
+  /**
+   * @brief Gets the process-wide shared executor.
+   *
+   * The executor is created on first use with default options, and its
+   * workers start on the first submitted task.
+   *
+   * @return The shared executor.
+   */
+  static auto GetShared() -> std::shared_ptr<WorkStealingExecutor>;
+
+ private:
+  /// @brief A worker-owned task deque.
+  struct WorkerQueue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  /// @brief Creates the queues and worker threads exactly once.
+  void EnsureStarted();
+
+  /**
+   * @brief Main loop of a worker thread.
+   *
+   * @param index The index of the worker's own queue.
+   */
+  void WorkerLoop(std::size_t index);
+
+  /**
+   * @brief Applies the configured CPU affinity to the calling worker.
+   *
+   * @param index The index of the worker.
+   */
+  void ApplyAffinity(std::size_t index) const;
+
+  /**
+   * @brief Pops the most recently pushed task from a worker's own queue.
+   *
+   * @param index The index of the worker's own queue.
+   * @return The task, or std::nullopt if the queue is empty.
+   */
+  auto TryPop(std::size_t index) -> std::optional<Task>;
+
+  /**
+   * @brief Steals the oldest task from another worker's queue.
+   *
+   * @param index The index of the stealing worker's own queue.
+   * @return The task, or std::nullopt if every other queue is empty.
+   */
+  auto TrySteal(std::size_t index) -> std::optional<Task>;
+
+  /// @brief Wakes one sleeping worker, if any.
+  void NotifyWorker();
+
+  /// @brief Number of worker threads to create.
+  std::size_t num_threads_;
+
+  /// @brief CPUs the workers may run on. Empty means no pinning.
+  std::vector<int> affinity_cpus_;
+
+  /// @brief Pin each worker to a single CPU rather than the whole set.
+  bool pin_individually_ = false;
+
+  /// @brief Guards the one-time creation of queues and workers.
+  std::once_flag start_flag_;
+
+  /// @brief Flag set once the queues and workers exist.
+  std::atomic<bool> started_{false};
+
+  /// @brief One task deque per worker.
+  std::vector<std::unique_ptr<WorkerQueue>> queues_;
+
+  /// @brief Worker threads.
+  std::vector<std::thread> workers_;
+
+  /// @brief Round-robin cursor for tasks submitted from outside the pool.
+  std::atomic<std::size_t> next_queue_{0};
+
+  /// @brief Number of tasks queued but not yet picked up.
+  std::atomic<std::size_t> pending_{0};
+
+  /// @brief Number of workers blocked waiting for work.
+  std::atomic<std::size_t> sleeping_{0};
+
+  /// @brief Flag to stop the workers once the queues drain.
+  std::atomic<bool> stopping_{false};
+
+  /// @brief Mutex and condition variable used only to park idle workers.
+  std::mutex sleep_mutex_;
+  std::condition_variable sleep_cv_;
+};
+
+}  // namespace jsonrpc::executor
@@ -1,13 +1,15 @@
 #pragma once
 
+#include <memory>
 #include <optional>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
-#include <BS_thread_pool.hpp>
 #include <nlohmann/json.hpp>
 
+#include "jsonrpc/executor/executor.hpp"
 #include "jsonrpc/server/request.hpp"
 #include "jsonrpc/server/response.hpp"
 #include "jsonrpc/server/types.hpp"
@@ -18,14 +20,18 @@ namespace jsonrpc::server {
  * @brief Dispatcher for JSON-RPC requests.
  *
  * Dispatcher manages the registration and execution of method call and
- * notification handlers for JSON-RPC requests. It can operate in
- * single-threaded or multi-threaded mode.
+ * notification handlers for JSON-RPC requests. Batch requests are fanned out
+ * through an executor, which may be shared with other dispatchers.
  */
 class Dispatcher {
  public:
   /**
    * @brief Constructs a Dispatcher.
    *
+   * Creates a private work-stealing executor when multi-threading is enabled,
+   * or an inline executor otherwise. The executor's threads are only started
+   * when the first batch request arrives.
+   *
    * @param enableMultithreading Enable multi-threading support.
    * @param numThreads Number of threads to use if multi-threading is enabled.
    */
@@ -33,6 +39,15 @@ class Dispatcher {
       bool enable_multithreading = true,
       size_t num_threads = std::thread::hardware_concurrency());
 
+  /**
+   * @brief Constructs a Dispatcher that runs batch requests on an executor.
+   *
+   * @param executor The executor to use. It may be shared with other
+   * dispatchers.
+   * @throws std::invalid_argument if the executor is null.
+   */
+  explicit Dispatcher(std::shared_ptr<executor::Executor> executor);
+
   Dispatcher(const Dispatcher &) = delete;
   Dispatcher(Dispatcher &&) = delete;
   auto operator=(const Dispatcher &) -> Dispatcher & = delete;
@@ -53,6 +68,17 @@ class Dispatcher {
   auto DispatchRequest(const std::string &request)
       -> std::optional<std::string>;
 
+  /**
+   * @brief Processes a JSON-RPC request that has already been parsed.
+   *
+   * @param request The request, or a discarded value if it was not valid
+   * JSON, which is answered with a parse error.
+   * @return The response from the handler as a JSON string, or std::nullopt if
+   * no response is needed.
+   */
+  auto DispatchRequest(const nlohmann::json &request)
+      -> std::optional<std::string>;
+
   /**
    * @brief Registers a method call handler.
    *
@@ -116,8 +142,8 @@ class Dispatcher {
    * @brief Dispatches a batch request to the appropriate handlers and returns a
    * JSON string.
    *
-   * Handles a batch of JSON-RPC requests, processing each one concurrently if
-   * multithreading is enabled.
+   * Handles a batch of JSON-RPC requests, processing each one on the
+   * dispatcher's executor.
    *
    * @param requestJson The parsed JSON batch request.
    * @return The batch response as a JSON string, or std::nullopt if no
@@ -130,8 +156,8 @@ class Dispatcher {
    * @brief Internal method to dispatch a batch request to the appropriate
    * handlers and returns a vector of JSON objects.
    *
-   * Processes each request in the batch, potentially using multithreading to
-   * handle multiple requests concurrently.
+   * Submits each request in the batch to the executor, which may handle
+   * multiple requests concurrently.
    *
    * @param requestJson The parsed JSON batch request.
    * @return A vector of JSON objects representing the responses.
@@ -208,11 +234,8 @@ class Dispatcher {
   /// @brief A map of method names to method call handlers.
   std::unordered_map<std::string, Handler> handlers_;
 
-  /// @brief Flag to enable multi-threading support.
-  bool enable_multithreading_;
-
-  /// @brief Thread pool for multi-threading.
-  BS::thread_pool thread_pool_;
+  /// @brief Executor used to run batch requests.
+  std::shared_ptr<executor::Executor> executor_;
 };
 
 }  // namespace jsonrpc::server
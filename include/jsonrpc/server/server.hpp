@@ -4,6 +4,7 @@
 #include <memory>
 #include <string>
 
+#include "jsonrpc/executor/executor.hpp"
 #include "jsonrpc/server/dispatcher.hpp"
 #include "jsonrpc/server/types.hpp"
 #include "jsonrpc/transport/transport.hpp"
@@ -21,11 +22,28 @@ class Server {
   /**
    * @brief Constructs a Server with the specified transport.
    *
+   * Batch requests run on the process-wide shared executor, whose threads are
+   * only started when the first batch arrives.
+   *
    * @param transport A unique pointer to the transport layer to use for
    * communication.
    */
   explicit Server(std::unique_ptr<transport::Transport> transport);
 
+  /**
+   * @brief Constructs a Server that runs batch requests on an executor.
+   *
+   * Passing the same executor to several servers lets them share one pool of
+   * worker threads.
+   *
+   * @param transport A unique pointer to the transport layer to use for
+   * communication.
+   * @param executor The executor used by the dispatcher.
+   */
+  Server(
+      std::unique_ptr<transport::Transport> transport,
+      std::shared_ptr<executor::Executor> executor);
+
   /// @brief Starts the server to handle incoming JSON-RPC requests.
   void Start();
 
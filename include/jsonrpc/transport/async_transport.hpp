@@ -0,0 +1,142 @@
+#pragma once
+
+#include <asio.hpp>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "jsonrpc/transport/transport.hpp"
+
+namespace jsonrpc::transport {
+
+/**
+ * @brief Transport that can also send and receive asynchronously.
+ *
+ * Asynchronous operations run on the transport's executor, usually an
+ * `asio::io_context` supplied by the caller, and accept any Asio completion
+ * token: a callback, `asio::use_future`, `asio::use_awaitable` and so on.
+ * Completion handlers are invoked through their associated executor.
+ *
+ * The blocking SendMessage and ReceiveMessage share the receive buffer and
+ * write queue with the asynchronous operations, so sends of both kinds may be
+ * mixed freely. Receives of both kinds must not be outstanding at once, and
+ * at most one asynchronous receive may be outstanding. The transport must
+ * outlive its pending operations.
+ *
+ * A transport constructed without an io_context runs on one of its own that
+ * is never run, and rejects asynchronous operations.
+ */
+class AsyncTransport : public Transport {
+ public:
+  /// @brief Type-erased handler for asynchronous sends.
+  using SendHandler = std::function<void(const asio::error_code &ec)>;
+
+  /// @brief Type-erased handler for asynchronous receives.
+  using ReceiveHandler =
+      std::function<void(const asio::error_code &ec, std::string message)>;
+
+  /// @brief Gets the executor that asynchronous operations run on.
+  [[nodiscard]] virtual auto GetExecutor() -> asio::any_io_executor = 0;
+
+  /**
+   * @brief Sends a message asynchronously.
+   *
+   * Completes once the message has been written, with signature
+   * `void(asio::error_code)`.
+   *
+   * @param message The JSON-RPC message as a string.
+   * @param token The completion token.
+   * @throws std::logic_error if the transport does not support asynchronous
+   * operations.
+   */
+  template <typename CompletionToken>
+  auto AsyncSendMessage(std::string message, CompletionToken &&token) {
+    RequireAsyncSupport();
+    return asio::async_initiate<CompletionToken, void(asio::error_code)>(
+        [this](auto handler, std::string message) {
+          DoAsyncSendMessage(
+              std::move(message), WrapHandler(std::move(handler)));
+        },
+        token, std::move(message));
+  }
+
+  /**
+   * @brief Receives a message asynchronously.
+   *
+   * Completes with signature `void(asio::error_code, std::string)`.
+   *
+   * @param token The completion token.
+   * @throws std::logic_error if the transport does not support asynchronous
+   * operations.
+   */
+  template <typename CompletionToken>
+  auto AsyncReceiveMessage(CompletionToken &&token) {
+    RequireAsyncSupport();
+    return asio::async_initiate<
+        CompletionToken, void(asio::error_code, std::string)>(
+        [this](auto handler) {
+          DoAsyncReceiveMessage(WrapHandler(std::move(handler)));
+        },
+        token);
+  }
+
+ protected:
+  /**
+   * @brief Whether anything runs the executor asynchronous operations would
+   * complete on.
+   *
+   * False for transports that created their own io_context, since no handler
+   * posted there would ever be invoked.
+   */
+  [[nodiscard]] virtual auto SupportsAsync() const -> bool {
+    return true;
+  }
+
+  /**
+   * @brief Starts an asynchronous send.
+   *
+   * @param message The message to send.
+   * @param handler Called once, from any thread, when the send completes.
+   */
+  virtual void DoAsyncSendMessage(
+      std::string message, SendHandler handler) = 0;
+
+  /**
+   * @brief Starts an asynchronous receive.
+   *
+   * @param handler Called once, from any thread, when the receive completes.
+   */
+  virtual void DoAsyncReceiveMessage(ReceiveHandler handler) = 0;
+
+ private:
+  void RequireAsyncSupport() const {
+    if (!SupportsAsync()) {
+      throw std::logic_error(
+          "Asynchronous operations require a transport created with an "
+          "io_context");
+    }
+  }
+
+  /**
+   * @brief Wraps a possibly move-only completion handler in a copyable
+   * callable that invokes it through its associated executor.
+   */
+  template <typename Handler>
+  auto WrapHandler(Handler handler) {
+    auto executor = asio::get_associated_executor(handler, GetExecutor());
+    auto shared = std::make_shared<Handler>(std::move(handler));
+    return [executor, shared](auto &&...args) {
+      asio::dispatch(
+          executor,
+          [shared, ... args = std::decay_t<decltype(args)>(
+                       std::forward<decltype(args)>(args))]() mutable {
+            std::move(*shared)(std::move(args)...);
+          });
+    };
+  }
+};
+
+}  // namespace jsonrpc::transport
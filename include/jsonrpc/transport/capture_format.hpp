@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace jsonrpc::transport {
+
+/// @brief Whether a captured message was sent or received by the capturing
+/// side.
+enum class CaptureDirection : std::uint8_t {
+  kSent = 0,
+  kReceived = 1,
+};
+
+/// @brief How messages were framed on the wire of the captured transport.
+enum class CaptureFraming : std::uint8_t {
+  /// @brief Not recorded, e.g. a transport without byte-level framing.
+  kNone = 0,
+
+  /// @brief One message per line.
+  kLine = 1,
+
+  /// @brief Content-Length headers.
+  kContentLength = 2,
+};
+
+/**
+ * @brief Layout of a capture file.
+ *
+ * A capture file starts with a 16-byte file header: the magic bytes, a
+ * 32-bit version and the framing of the captured transport. It is followed
+ * by records, each a 16-byte record header and the message bytes, without
+ * framing. Integers are in host byte order, so captures are read on a
+ * machine of the same endianness.
+ *
+ * | Offset | File header       | Record header              |
+ * |--------|-------------------|----------------------------|
+ * | 0      | magic "JRPCCAP\0" | timestamp, ns since epoch  |
+ * | 8      | version (u32)     | message size (u32)         |
+ * | 12     | framing (u8)      | direction (u8)             |
+ */
+namespace capture_format {
+
+inline constexpr std::string_view kMagic{"JRPCCAP\0", 8};
+inline constexpr std::uint32_t kVersion = 1;
+inline constexpr std::size_t kFileHeaderSize = 16;
+inline constexpr std::size_t kRecordHeaderSize = 16;
+
+inline constexpr std::size_t kVersionOffset = 8;
+inline constexpr std::size_t kFramingOffset = 12;
+
+inline constexpr std::size_t kTimestampOffset = 0;
+inline constexpr std::size_t kSizeOffset = 8;
+inline constexpr std::size_t kDirectionOffset = 12;
+
+}  // namespace capture_format
+
+}  // namespace jsonrpc::transport
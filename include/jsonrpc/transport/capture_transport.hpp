@@ -0,0 +1,66 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "jsonrpc/transport/capture_format.hpp"
+#include "jsonrpc/transport/transport.hpp"
+
+namespace jsonrpc::transport {
+
+/**
+ * @brief Transport decorator that records every message to a capture file.
+ *
+ * Each message sent or received through the wrapped transport is appended to
+ * the file with its wall-clock time and direction; see capture_format for
+ * the layout. Sent messages are recorded just before they are handed to the
+ * wrapped transport. Every record is appended with a single write to a file
+ * opened with O_APPEND, so concurrent senders and processes sharing the file
+ * never interleave records, and a capture cut short by a crash loses at most
+ * its last record. ReplayTransport plays a capture back.
+ */
+class CaptureTransport : public Transport {
+ public:
+  /**
+   * @brief Constructs a CaptureTransport.
+   *
+   * An existing capture file is appended to.
+   *
+   * @param transport The transport to record.
+   * @param path The capture file.
+   * @param framing How the wrapped transport frames messages, for reference.
+   * @throws std::runtime_error if the file cannot be opened or is not a
+   * capture file.
+   */
+  CaptureTransport(
+      std::unique_ptr<Transport> transport, const std::string &path,
+      CaptureFraming framing = CaptureFraming::kNone);
+
+  ~CaptureTransport() override;
+
+  CaptureTransport(const CaptureTransport &) = delete;
+  auto operator=(const CaptureTransport &) -> CaptureTransport & = delete;
+
+  CaptureTransport(CaptureTransport &&) = delete;
+  auto operator=(CaptureTransport &&) -> CaptureTransport & = delete;
+
+  void SendMessage(const std::string &message) override;
+  void SendMessage(std::string &&message) override;
+  auto ReceiveMessage() -> std::string override;
+  void Close() override;
+
+ private:
+  /// @brief Writes the file header to an empty file or checks an existing
+  /// one.
+  void PrepareFile(CaptureFraming framing);
+
+  /// @brief Appends one record. Failures are logged, not thrown, so that
+  /// capturing never breaks the session.
+  void Record(CaptureDirection direction, const std::string &message);
+
+  std::unique_ptr<Transport> transport_;
+  std::string path_;
+  int fd_ = -1;
+};
+
+}  // namespace jsonrpc::transport
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <asio.hpp>
+#include <cstddef>
+#include <string_view>
+#include <utility>
+
+namespace jsonrpc::transport {
+
+/**
+ * @brief Finds the first occurrence of a delimiter in a block of bytes.
+ *
+ * On x86-64 candidates are located 32 (AVX2, when the CPU has it) or 16
+ * (SSE2) bytes at a time by comparing the delimiter's first and last bytes;
+ * other targets use std::string_view::find.
+ *
+ * @param data The bytes to search.
+ * @param size The number of bytes.
+ * @param delimiter The non-empty delimiter.
+ * @return The offset of the delimiter, or std::string_view::npos.
+ */
+auto FindDelimiter(
+    const char *data, std::size_t size, std::string_view delimiter)
+    -> std::size_t;
+
+/**
+ * @brief Match condition for asio::read_until that searches with
+ * FindDelimiter.
+ *
+ * Only for buffers whose readable bytes are contiguous, such as
+ * asio::streambuf. Like Asio's own delimiter search, bytes already searched
+ * are not searched again when more data arrives.
+ */
+class DelimiterMatch {
+ public:
+  /// @brief Marks this type as a match condition for Asio.
+  using result_type = std::pair<  // NOLINT(readability-identifier-naming)
+      asio::buffers_iterator<asio::streambuf::const_buffers_type>, bool>;
+
+  /// @param delimiter The non-empty delimiter, which must outlive the match.
+  constexpr explicit DelimiterMatch(std::string_view delimiter)
+      : delimiter_(delimiter) {
+  }
+
+  template <typename Iterator>
+  auto operator()(Iterator begin, Iterator end) const
+      -> std::pair<Iterator, bool> {
+    auto size = static_cast<std::size_t>(end - begin);
+    if (size == 0) {
+      return {end, false};
+    }
+    std::size_t pos = FindDelimiter(&*begin, size, delimiter_);
+    if (pos != std::string_view::npos) {
+      return {begin + static_cast<std::ptrdiff_t>(pos + delimiter_.size()),
+              true};
+    }
+    // A delimiter split across reads starts in the last few bytes.
+    std::size_t keep = std::min(size, delimiter_.size() - 1);
+    return {end - static_cast<std::ptrdiff_t>(keep), false};
+  }
+
+ private:
+  std::string_view delimiter_;
+};
+
+}  // namespace jsonrpc::transport
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <array>
+#include <asio.hpp>
+#include <cstddef>
+#include <sys/uio.h>
+
+namespace jsonrpc::transport {
+
+/**
+ * @brief Blocking byte stream over a file descriptor it does not own.
+ *
+ * Satisfies Asio's SyncReadStream and SyncWriteStream requirements with
+ * plain read and writev calls, retrying on EINTR, so standard input and
+ * output can be used with asio::read_until, asio::write and the framed
+ * receive helpers. End of input is reported as asio::error::eof.
+ *
+ * An interruptible stream waits for input with poll() on the descriptor and
+ * an internal pipe, so that Interrupt() can end a blocked read from another
+ * thread.
+ */
+class FdStream {
+ public:
+  /**
+   * @param fd The descriptor; it is left open when the stream is destroyed.
+   * @param interruptible Whether reads can be ended with Interrupt().
+   * @throws std::runtime_error if the interrupt pipe cannot be created.
+   */
+  explicit FdStream(int fd, bool interruptible = false);
+
+  ~FdStream();
+
+  FdStream(const FdStream &) = delete;
+  auto operator=(const FdStream &) -> FdStream & = delete;
+
+  FdStream(FdStream &&) = delete;
+  auto operator=(FdStream &&) -> FdStream & = delete;
+
+  /**
+   * @brief Ends a blocked read and fails all later ones with
+   * asio::error::operation_aborted. Only for interruptible streams; safe to
+   * call from any thread.
+   */
+  void Interrupt();
+
+  /// @brief Gets the descriptor.
+  [[nodiscard]] auto NativeHandle() const -> int {
+    return fd_;
+  }
+
+  /// @brief Reads at least one byte, blocking until data or end of input.
+  template <typename MutableBufferSequence>
+  auto read_some(  // NOLINT(readability-identifier-naming)
+      const MutableBufferSequence &buffers, asio::error_code &ec)
+      -> std::size_t {
+    for (auto it = asio::buffer_sequence_begin(buffers);
+         it != asio::buffer_sequence_end(buffers); ++it) {
+      asio::mutable_buffer buffer(*it);
+      if (buffer.size() > 0) {
+        return ReadSome(buffer.data(), buffer.size(), ec);
+      }
+    }
+    ec = {};
+    return 0;
+  }
+
+  /// @brief Reads at least one byte, throwing on failure.
+  template <typename MutableBufferSequence>
+  auto read_some(  // NOLINT(readability-identifier-naming)
+      const MutableBufferSequence &buffers) -> std::size_t {
+    asio::error_code ec;
+    std::size_t size = read_some(buffers, ec);
+    if (ec) {
+      throw asio::system_error(ec);
+    }
+    return size;
+  }
+
+  /// @brief Writes at least one byte of the buffer sequence.
+  template <typename ConstBufferSequence>
+  auto write_some(  // NOLINT(readability-identifier-naming)
+      const ConstBufferSequence &buffers, asio::error_code &ec)
+      -> std::size_t {
+    std::array<iovec, kMaxIovecs> iovecs{};
+    std::size_t count = 0;
+    for (auto it = asio::buffer_sequence_begin(buffers);
+         it != asio::buffer_sequence_end(buffers) && count < kMaxIovecs;
+         ++it) {
+      asio::const_buffer buffer(*it);
+      iovecs[count++] = {const_cast<void *>(buffer.data()), buffer.size()};
+    }
+    return WriteSome(iovecs.data(), count, ec);
+  }
+
+  /// @brief Writes at least one byte of the buffer sequence, throwing on
+  /// failure.
+  template <typename ConstBufferSequence>
+  auto write_some(  // NOLINT(readability-identifier-naming)
+      const ConstBufferSequence &buffers) -> std::size_t {
+    asio::error_code ec;
+    std::size_t size = write_some(buffers, ec);
+    if (ec) {
+      throw asio::system_error(ec);
+    }
+    return size;
+  }
+
+ private:
+  /// @brief Buffers gathered into one writev.
+  static constexpr std::size_t kMaxIovecs = 64;
+
+  auto ReadSome(void *data, std::size_t size, asio::error_code &ec)
+      -> std::size_t;
+  auto WriteSome(const iovec *iovecs, std::size_t count, asio::error_code &ec)
+      -> std::size_t;
+
+  /// @brief Waits until the descriptor is readable or the stream is
+  /// interrupted.
+  auto WaitReadable(asio::error_code &ec) -> bool;
+
+  int fd_;
+
+  /// @brief Read and write ends of the interrupt pipe, or -1.
+  int interrupt_read_fd_ = -1;
+  int interrupt_write_fd_ = -1;
+};
+
+}  // namespace jsonrpc::transport
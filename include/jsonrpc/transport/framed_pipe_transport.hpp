@@ -5,6 +5,7 @@
 #include <string>
 
 #include "jsonrpc/transport/framed_transport.hpp"
+#include "jsonrpc/transport/json_receiver.hpp"
 #include "jsonrpc/transport/pipe_transport.hpp"
 
 namespace jsonrpc::transport {
@@ -13,12 +14,31 @@ namespace jsonrpc::transport {
  * @brief Transport layer using Asio Unix domain sockets for JSON-RPC
  * communication with framing.
  */
-class FramedPipeTransport : public PipeTransport, protected FramedTransport {
+class FramedPipeTransport : public PipeTransport,
+                            public JsonReceiver,
+                            protected FramedTransport {
  public:
-  FramedPipeTransport(const std::string &socket_path, bool is_server);
+  FramedPipeTransport(
+      const std::string &socket_path, bool is_server,
+      const SocketOptions &options = {},
+      const FramedOptions &framed_options = {});
+
+  /// @brief Constructs a transport whose socket runs on the given io_context.
+  FramedPipeTransport(
+      asio::io_context &io_context, const std::string &socket_path,
+      bool is_server, const SocketOptions &options = {},
+      const FramedOptions &framed_options = {});
 
   void SendMessage(const std::string &message) override;
+  void SendMessage(std::string &&message) override;
   auto ReceiveMessage() -> std::string override;
+
+  [[nodiscard]] auto IsStreaming() const -> bool override;
+  auto ReceiveJson() -> nlohmann::json override;
+
+ protected:
+  void DoAsyncSendMessage(std::string message, SendHandler handler) override;
+  void DoAsyncReceiveMessage(ReceiveHandler handler) override;
 };
 
 }  // namespace jsonrpc::transport
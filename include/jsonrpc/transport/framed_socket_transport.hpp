@@ -6,6 +6,7 @@
 #include <string>
 
 #include "jsonrpc/transport/framed_transport.hpp"
+#include "jsonrpc/transport/json_receiver.hpp"
 #include "jsonrpc/transport/socket_transport.hpp"
 
 namespace jsonrpc::transport {
@@ -15,12 +16,30 @@ namespace jsonrpc::transport {
  * communication with framing.
  */
 class FramedSocketTransport : public SocketTransport,
+                              public JsonReceiver,
                               protected FramedTransport {
  public:
-  FramedSocketTransport(const std::string &host, uint16_t port, bool is_server);
+  FramedSocketTransport(
+      const std::string &host, uint16_t port, bool is_server,
+      const SocketOptions &options = {},
+      const FramedOptions &framed_options = {});
+
+  /// @brief Constructs a transport whose socket runs on the given io_context.
+  FramedSocketTransport(
+      asio::io_context &io_context, const std::string &host, uint16_t port,
+      bool is_server, const SocketOptions &options = {},
+      const FramedOptions &framed_options = {});
 
   void SendMessage(const std::string &message) override;
+  void SendMessage(std::string &&message) override;
   auto ReceiveMessage() -> std::string override;
+
+  [[nodiscard]] auto IsStreaming() const -> bool override;
+  auto ReceiveJson() -> nlohmann::json override;
+
+ protected:
+  void DoAsyncSendMessage(std::string message, SendHandler handler) override;
+  void DoAsyncReceiveMessage(ReceiveHandler handler) override;
 };
 
 }  // namespace jsonrpc::transport
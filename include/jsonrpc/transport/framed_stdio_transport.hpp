@@ -3,7 +3,8 @@
 #include <string>
 
 #include "jsonrpc/transport/framed_transport.hpp"
-#include "jsonrpc/transport/transport.hpp"
+#include "jsonrpc/transport/json_receiver.hpp"
+#include "jsonrpc/transport/stdio_transport.hpp"
 
 namespace jsonrpc::transport {
 
@@ -12,12 +13,21 @@ namespace jsonrpc::transport {
  * communication.
  *
  * This class uses framed transport to send and receive JSON-RPC messages over
- * standard I/O.
+ * standard I/O, with the buffering and flush policies of StdioTransport.
  */
-class FramedStdioTransport : public Transport, protected FramedTransport {
+class FramedStdioTransport : public StdioTransport,
+                             public JsonReceiver,
+                             protected FramedTransport {
  public:
+  explicit FramedStdioTransport(
+      StdioOptions options = {}, FramedOptions framed_options = {});
+
   void SendMessage(const std::string &message) override;
+  void SendMessage(std::string &&message) override;
   auto ReceiveMessage() -> std::string override;
+
+  [[nodiscard]] auto IsStreaming() const -> bool override;
+  auto ReceiveJson() -> nlohmann::json override;
 };
 
 }  // namespace jsonrpc::transport
@@ -1,71 +1,473 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <asio.hpp>
 #include <cstddef>
 #include <istream>
-#include <ostream>
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+#include <streambuf>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+
+#include "jsonrpc/transport/delimiter_search.hpp"
+#include "jsonrpc/transport/transport.hpp"
 
 namespace jsonrpc::transport {
 
 class FramedTransportTest;
 
+/// @brief Options for receiving framed messages.
+struct FramedOptions {
+  /// @brief Largest Content-Length accepted. A larger message is skipped
+  /// without its content being stored, and reported as an error.
+  std::size_t max_message_size = 64 * 1024 * 1024;
+
+  /// @brief Parse message content while it is read instead of receiving it
+  /// into a string first. Used by Server through JsonReceiver.
+  bool stream_content = false;
+};
+
 /**
  * @brief Base class for framed transport mechanisms.
  *
  * Provides modular functionality for sending and receiving framed messages.
  */
 class FramedTransport {
-  /// @brief A map of headers to their values.
-  using HeaderMap = std::unordered_map<std::string, std::string>;
-
  protected:
+  explicit FramedTransport(FramedOptions options = {});
+
+  /// @brief Gets the options for receiving messages.
+  [[nodiscard]] auto GetFramedOptions() const -> const FramedOptions &;
+
   /// @brief The delimiter used to separate headers from the message content.
   static constexpr const char *kHeaderDelimiter = "\r\n\r\n";
 
+  /// @brief Finds the end of the headers in a receive buffer.
+  static constexpr DelimiterMatch kHeaderMatch{kHeaderDelimiter};
+
+  /// @brief Upper bound on the size of the headers written by this class.
+  static constexpr std::size_t kMaxHeaderSize = 128;
+
+  /// @brief Upper bound on the size of received headers.
+  static constexpr std::size_t kMaxReceivedHeaderSize = 8192;
+
+  /// @brief Headers for one message, formatted without allocating.
+  struct FrameHeader {
+    std::array<char, kMaxHeaderSize> data;
+    std::size_t size;
+
+    /// @brief Gets the formatted headers as a string view.
+    [[nodiscard]] auto View() const -> std::string_view {
+      return {data.data(), size};
+    }
+  };
+
   /**
-   * @brief Constructs a framed message.
+   * @brief Formats the headers for a message of the given length.
    *
-   * Constructs a JSON message as a string with additional headers for
-   * Content-Length and Content-Type, similar to HTTP.
+   * @param content_length The length of the message content.
+   * @return The headers, including the terminating blank line.
+   */
+  static auto MakeFrameHeader(std::size_t content_length) -> FrameHeader;
+
+  /**
+   * @brief Scans headers for the content length without allocating.
    *
-   * @param output The output stream to write the framed message.
-   * @param message The message to be framed.
+   * Header names are matched case-insensitively. Content-Type carries
+   * nothing the transport acts on and, like unknown headers, is skipped.
+   * Scanning stops at the first empty line or the end of the input.
+   *
+   * @param headers The headers, with or without the terminating blank line.
+   * @return The value of the Content-Length header.
+   * @throws std::runtime_error if there are no headers or Content-Length is
+   * missing or invalid.
    */
-  static void FrameMessage(std::ostream &output, const std::string &message);
+  static auto ParseHeaders(std::string_view headers) -> std::size_t;
 
-  static auto ReadHeadersFromStream(std::istream &input) -> HeaderMap;
-  static auto ReadContentLengthFromStream(std::istream &input) -> int;
+  /**
+   * @brief Receives a framed message through a persistent buffer.
+   *
+   * Complete messages already held in the buffer are returned without reading
+   * from the stream. Otherwise only as many bytes as the next message needs
+   * are awaited; anything read beyond it stays buffered for the next call.
+   * Only the headers are searched for a delimiter: the content is taken by
+   * its length without being scanned.
+   *
+   * @param stream The stream to read from.
+   * @param buffer The receive buffer, kept by the caller across calls.
+   * @return The received message content.
+   * @throws MessageTooLargeError if the message exceeds the maximum size. Its
+   * content has been skipped and the next message can be received.
+   * @throws std::runtime_error if reading fails or the headers are malformed
+   * or longer than kMaxReceivedHeaderSize. The stream is then unusable.
+   */
+  template <typename SyncReadStream>
+  auto ReceiveFramedMessage(SyncReadStream &stream, asio::streambuf &buffer)
+      -> std::string {
+    std::size_t content_length = ReadFramedHeaders(stream, buffer);
+
+    if (buffer.size() < content_length) {
+      std::size_t missing = content_length - buffer.size();
+      asio::error_code ec;
+      asio::read(stream, buffer, asio::transfer_exactly(missing), ec);
+      if (ec) {
+        throw std::runtime_error(
+            "Failed to read message content: " + ec.message());
+      }
+    }
+
+    return TakeContent(buffer, content_length);
+  }
 
   /**
-   * @brief Reads content from the input stream based on the content length.
+   * @brief Receives a framed message and parses it as it is read.
+   *
+   * The content is fed to the parser straight from the receive buffer, which
+   * is refilled in chunks of at most kReadChunkSize bytes, so a large
+   * message is never held in memory as a whole and parsing proceeds while
+   * the rest of it is still arriving.
    *
-   * @param input The input stream to read the content from.
-   * @param content_length The length of the content to be read.
-   * @return The content as a string.
+   * @param stream The stream to read from.
+   * @param buffer The receive buffer, kept by the caller across calls.
+   * @return The parsed message, or a discarded value if the content is not
+   * valid JSON.
+   * @throws MessageTooLargeError, std::runtime_error as for
+   * ReceiveFramedMessage.
    */
-  static auto ReadContent(std::istream &input, std::size_t content_length)
-      -> std::string;
+  template <typename SyncReadStream>
+  auto ReceiveFramedJson(SyncReadStream &stream, asio::streambuf &buffer)
+      -> nlohmann::json {
+    std::size_t content_length = ReadFramedHeaders(stream, buffer);
+    ContentStreambuf<SyncReadStream> content(stream, buffer, content_length);
+    std::istream input(&content);
+    nlohmann::json message = nlohmann::json::parse(input, nullptr, false);
+    // Invalid JSON stops the parser early; skip the rest of the message.
+    content.Finish();
+    return message;
+  }
 
   /**
-   * @brief Receives a framed message.
+   * @brief Receives a framed message asynchronously through a persistent
+   * buffer.
    *
-   * Reads headers to determine the content length, then reads the message
-   * content based on that length.
+   * Behaves like the blocking overload. Malformed or overlong headers
+   * complete with asio::error::invalid_argument. An oversized message is
+   * skipped and completes with asio::error::message_size, after which the
+   * next message can be received.
    *
-   * @param input The input stream to read the framed message.
-   * @return The received message content.
+   * @param stream The stream to read from.
+   * @param buffer The receive buffer, kept by the caller across calls.
+   * @param handler Called with the error code and the message content.
    */
-  static auto ReceiveFramedMessage(std::istream &input) -> std::string;
+  template <typename AsyncReadStream, typename Handler>
+  void AsyncReceiveFramedMessage(
+      AsyncReadStream &stream, asio::streambuf &buffer, Handler handler) {
+    AsyncReadFramedHeaders(
+        stream, buffer,
+        [this, &stream, &buffer, handler = std::move(handler)](
+            const asio::error_code &ec, std::size_t header_size) mutable {
+          if (ec) {
+            handler(ec, std::string());
+            return;
+          }
+
+          std::size_t content_length = 0;
+          try {
+            content_length = TakeHeaders(buffer, header_size);
+          } catch (const std::runtime_error &) {
+            handler(asio::error::invalid_argument, std::string());
+            return;
+          }
+          if (content_length > options_.max_message_size) {
+            AsyncSkipContent(
+                stream, buffer, content_length,
+                [handler = std::move(handler)](
+                    const asio::error_code &ec) mutable {
+                  handler(
+                      ec ? ec : asio::error::message_size, std::string());
+                });
+            return;
+          }
+
+          if (buffer.size() >= content_length) {
+            handler(ec, TakeContent(buffer, content_length));
+            return;
+          }
+          std::size_t missing = content_length - buffer.size();
+          asio::async_read(
+              stream, buffer, asio::transfer_exactly(missing),
+              [&buffer, content_length, handler = std::move(handler)](
+                  const asio::error_code &ec, std::size_t) mutable {
+                if (ec) {
+                  handler(ec, std::string());
+                  return;
+                }
+                handler(ec, TakeContent(buffer, content_length));
+              });
+        });
+  }
 
  private:
+  /// @brief Largest read issued into the receive buffer for headers or
+  /// streamed content.
+  static constexpr std::size_t kReadChunkSize = 64 * 1024;
+
+  /**
+   * @brief Presents message content in a receive buffer as a std::streambuf,
+   * reading more from the stream only when the reader runs out.
+   *
+   * Buffered bytes are exposed in place rather than copied, and consumed
+   * from the receive buffer as the reader moves past them.
+   */
+  template <typename SyncReadStream>
+  class ContentStreambuf : public std::streambuf {
+   public:
+    ContentStreambuf(
+        SyncReadStream &stream, asio::streambuf &buffer,
+        std::size_t content_length)
+        : stream_(stream), buffer_(buffer), remaining_(content_length) {
+      Expose();
+    }
+
+    /**
+     * @brief Consumes whatever content the reader left, so that the receive
+     * buffer starts at the next message.
+     *
+     * @throws std::runtime_error if the stream fails first.
+     */
+    void Finish() {
+      Release();
+      while (remaining_ > 0) {
+        if (buffer_.size() == 0 && !Read()) {
+          throw std::runtime_error(
+              "Failed to read message content: " + error_.message());
+        }
+        std::size_t size = std::min(buffer_.size(), remaining_);
+        buffer_.consume(size);
+        remaining_ -= size;
+      }
+    }
+
+   protected:
+    auto underflow() -> int_type override {
+      Release();
+      if (remaining_ == 0 || !Read()) {
+        return traits_type::eof();
+      }
+      Expose();
+      return traits_type::to_int_type(*gptr());
+    }
+
+   private:
+    /// @brief Makes the buffered part of the content readable.
+    void Expose() {
+      auto *data =
+          const_cast<char *>(static_cast<const char *>(buffer_.data().data()));
+      setg(data, data, data + std::min(buffer_.size(), remaining_));
+    }
+
+    /// @brief Consumes the bytes the reader has taken.
+    void Release() {
+      auto size = static_cast<std::size_t>(gptr() - eback());
+      buffer_.consume(size);
+      remaining_ -= size;
+      setg(nullptr, nullptr, nullptr);
+    }
+
+    /// @brief Reads the next chunk of content into the empty buffer.
+    auto Read() -> bool {
+      std::size_t size = stream_.read_some(
+          buffer_.prepare(std::min(remaining_, kReadChunkSize)), error_);
+      buffer_.commit(size);
+      return !error_;
+    }
+
+    SyncReadStream &stream_;
+    asio::streambuf &buffer_;
+    std::size_t remaining_;
+    asio::error_code error_;
+  };
+
+  /**
+   * @brief Reads and removes the headers of the next message.
+   *
+   * An oversized message is skipped before MessageTooLargeError is thrown.
+   *
+   * @param stream The stream to read from.
+   * @param buffer The receive buffer.
+   * @return The content length, within the maximum message size.
+   */
+  template <typename SyncReadStream>
+  auto ReadFramedHeaders(SyncReadStream &stream, asio::streambuf &buffer)
+      -> std::size_t {
+    std::size_t searched = 0;
+    std::size_t header_size = FindHeaderEnd(buffer, searched);
+    while (header_size == 0) {
+      asio::error_code ec;
+      std::size_t size = stream.read_some(buffer.prepare(kReadChunkSize), ec);
+      buffer.commit(size);
+      if (ec) {
+        throw std::runtime_error(
+            "Failed to read message headers: " + ec.message());
+      }
+      header_size = FindHeaderEnd(buffer, searched);
+    }
+
+    std::size_t content_length = TakeHeaders(buffer, header_size);
+    if (content_length > options_.max_message_size) {
+      ContentStreambuf<SyncReadStream>(stream, buffer, content_length)
+          .Finish();
+      throw MessageTooLarge(content_length);
+    }
+    return content_length;
+  }
+
+  /**
+   * @brief Reads until the receive buffer holds the headers of the next
+   * message.
+   *
+   * @param stream The stream to read from.
+   * @param buffer The receive buffer.
+   * @param handler Called with the error code and the size of the headers,
+   * including the delimiter.
+   */
+  template <typename AsyncReadStream, typename Handler>
+  static void AsyncReadFramedHeaders(
+      AsyncReadStream &stream, asio::streambuf &buffer, Handler handler) {
+    std::size_t searched = 0;
+    std::size_t header_size = 0;
+    asio::error_code ec;
+    try {
+      header_size = FindHeaderEnd(buffer, searched);
+    } catch (const std::runtime_error &) {
+      ec = asio::error::invalid_argument;
+    }
+    if (header_size == 0 && !ec) {
+      AsyncReadMoreHeaders(stream, buffer, searched, std::move(handler));
+      return;
+    }
+    // Complete through the executor, as a read would have.
+    asio::post(
+        stream.get_executor(),
+        [handler = std::move(handler), ec, header_size]() mutable {
+          handler(ec, header_size);
+        });
+  }
+
+  /// @brief Continues AsyncReadFramedHeaders once the buffer is searched.
+  template <typename AsyncReadStream, typename Handler>
+  static void AsyncReadMoreHeaders(
+      AsyncReadStream &stream, asio::streambuf &buffer, std::size_t searched,
+      Handler handler) {
+    stream.async_read_some(
+        buffer.prepare(kReadChunkSize),
+        [&stream, &buffer, searched, handler = std::move(handler)](
+            const asio::error_code &ec, std::size_t size) mutable {
+          buffer.commit(size);
+          std::size_t header_size = 0;
+          try {
+            header_size = FindHeaderEnd(buffer, searched);
+          } catch (const std::runtime_error &) {
+            handler(asio::error::invalid_argument, 0);
+            return;
+          }
+          if (header_size != 0 || ec) {
+            handler(header_size != 0 ? asio::error_code() : ec, header_size);
+            return;
+          }
+          AsyncReadMoreHeaders(stream, buffer, searched, std::move(handler));
+        });
+  }
+
+  /**
+   * @brief Discards message content without storing it.
+   *
+   * @param stream The stream to read from.
+   * @param buffer The receive buffer, starting at the content.
+   * @param remaining The number of content bytes to discard.
+   * @param handler Called with the error code once the content is skipped.
+   */
+  template <typename AsyncReadStream, typename Handler>
+  static void AsyncSkipContent(
+      AsyncReadStream &stream, asio::streambuf &buffer, std::size_t remaining,
+      Handler handler) {
+    std::size_t size = std::min(buffer.size(), remaining);
+    buffer.consume(size);
+    remaining -= size;
+    if (remaining == 0) {
+      handler(asio::error_code());
+      return;
+    }
+    stream.async_read_some(
+        buffer.prepare(std::min(remaining, kReadChunkSize)),
+        [&stream, &buffer, remaining, handler = std::move(handler)](
+            const asio::error_code &ec, std::size_t size) mutable {
+          buffer.commit(size);
+          if (ec) {
+            handler(ec);
+            return;
+          }
+          AsyncSkipContent(stream, buffer, remaining, std::move(handler));
+        });
+  }
+
+  /**
+   * @brief Searches the receive buffer for the end of the headers.
+   *
+   * Only the first kMaxReceivedHeaderSize bytes are searched, so a peer that
+   * never ends its headers cannot grow the buffer without bound.
+   *
+   * @param buffer The receive buffer.
+   * @param searched Number of bytes known not to start the delimiter,
+   * advanced by the search.
+   * @return The size of the headers, including the delimiter, or zero if
+   * the buffer does not hold all of them yet.
+   * @throws std::runtime_error if the headers are longer than
+   * kMaxReceivedHeaderSize.
+   */
+  static auto FindHeaderEnd(
+      const asio::streambuf &buffer, std::size_t &searched) -> std::size_t;
+
+  /**
+   * @brief Creates the error reported for an oversized message.
+   *
+   * @param content_length The message's content length.
+   */
+  [[nodiscard]] auto MessageTooLarge(std::size_t content_length) const
+      -> MessageTooLargeError;
+
+  /**
+   * @brief Parses and removes the headers at the front of a receive buffer.
+   *
+   * @param buffer The receive buffer.
+   * @param header_size The size of the headers, including the delimiter.
+   * @return The content length.
+   */
+  static auto TakeHeaders(asio::streambuf &buffer, std::size_t header_size)
+      -> std::size_t;
+
+  /**
+   * @brief Removes message content from the front of a receive buffer.
+   *
+   * @param buffer The receive buffer, holding at least content_length bytes.
+   * @param content_length The length of the content.
+   * @return The content.
+   */
+  static auto TakeContent(asio::streambuf &buffer, std::size_t content_length)
+      -> std::string;
+
   /**
    * @brief Parses the content length from the header value.
    *
    * @param header_value The header value containing the content length.
    * @return The parsed content length.
    */
-  static auto ParseContentLength(const std::string &header_value) -> int;
+  static auto ParseContentLength(std::string_view header_value)
+      -> std::size_t;
+
+  FramedOptions options_;
 
   friend class FramedTransportTest;
 };
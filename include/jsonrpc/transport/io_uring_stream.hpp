@@ -0,0 +1,140 @@
+#pragma once
+
+#include <array>
+#include <asio.hpp>
+#include <cstddef>
+#include <memory>
+#include <sys/uio.h>
+
+namespace jsonrpc::transport {
+
+/// @brief Options for an IoUringStream.
+struct IoUringOptions {
+  /// @brief Number of receive buffers handed to the kernel, a power of two.
+  unsigned buffer_count = 64;
+
+  /// @brief Size of each receive buffer.
+  std::size_t buffer_size = 16 * 1024;
+};
+
+/**
+ * @brief Blocking byte stream over a connected socket, driven by io_uring.
+ *
+ * Receiving uses one multishot receive that stays armed for the life of the
+ * stream and fills buffers from a ring registered with the kernel, so
+ * consecutive reads cost at most one io_uring_enter and no re-submission.
+ * Writes gather the whole buffer sequence into one send submission.
+ *
+ * Satisfies Asio's SyncReadStream and SyncWriteStream requirements, so it
+ * can be passed to asio::read_until and asio::write in place of the socket.
+ * Reads and writes use separate rings: one thread may read while another
+ * writes, but reads, like writes, must not overlap each other.
+ *
+ * Only available on Linux when the library is built with
+ * JSONRPC_USE_IO_URING. Otherwise, or if the kernel lacks io_uring or
+ * multishot receive, Create() returns nullptr and callers keep using Asio. If
+ * the kernel accepts the buffer ring but cannot fill it, each read is instead
+ * a single-shot receive into the caller's buffer.
+ */
+class IoUringStream {
+ public:
+  /**
+   * @brief Creates a stream over a connected socket.
+   *
+   * From then on the stream owns all reads from the socket. The socket stays
+   * owned by the caller and must outlive the stream.
+   *
+   * @param fd The socket descriptor.
+   * @param options Receive buffer sizing.
+   * @return The stream, or nullptr if io_uring cannot be used.
+   */
+  static auto Create(int fd, IoUringOptions options = {})
+      -> std::unique_ptr<IoUringStream>;
+
+  ~IoUringStream();
+
+  IoUringStream(const IoUringStream &) = delete;
+  auto operator=(const IoUringStream &) -> IoUringStream & = delete;
+
+  IoUringStream(IoUringStream &&) = delete;
+  auto operator=(IoUringStream &&) -> IoUringStream & = delete;
+
+  /// @brief Reads at least one byte, blocking until data or end of stream.
+  template <typename MutableBufferSequence>
+  auto read_some(  // NOLINT(readability-identifier-naming)
+      const MutableBufferSequence &buffers, asio::error_code &ec)
+      -> std::size_t {
+    for (auto it = asio::buffer_sequence_begin(buffers);
+         it != asio::buffer_sequence_end(buffers); ++it) {
+      asio::mutable_buffer buffer(*it);
+      if (buffer.size() > 0) {
+        return ReadSome(buffer.data(), buffer.size(), ec);
+      }
+    }
+    ec = {};
+    return 0;
+  }
+
+  /// @brief Reads at least one byte, throwing on failure.
+  template <typename MutableBufferSequence>
+  auto read_some(  // NOLINT(readability-identifier-naming)
+      const MutableBufferSequence &buffers) -> std::size_t {
+    asio::error_code ec;
+    std::size_t size = read_some(buffers, ec);
+    if (ec) {
+      throw asio::system_error(ec);
+    }
+    return size;
+  }
+
+  /// @brief Writes at least one byte of the buffer sequence.
+  template <typename ConstBufferSequence>
+  auto write_some(  // NOLINT(readability-identifier-naming)
+      const ConstBufferSequence &buffers, asio::error_code &ec)
+      -> std::size_t {
+    std::array<iovec, kMaxIovecs> iovecs{};
+    std::size_t count = 0;
+    for (auto it = asio::buffer_sequence_begin(buffers);
+         it != asio::buffer_sequence_end(buffers) && count < kMaxIovecs;
+         ++it) {
+      asio::const_buffer buffer(*it);
+      iovecs[count++] = {const_cast<void *>(buffer.data()), buffer.size()};
+    }
+    return WriteSome(iovecs.data(), count, ec);
+  }
+
+  /// @brief Writes at least one byte of the buffer sequence, throwing on
+  /// failure.
+  template <typename ConstBufferSequence>
+  auto write_some(  // NOLINT(readability-identifier-naming)
+      const ConstBufferSequence &buffers) -> std::size_t {
+    asio::error_code ec;
+    std::size_t size = write_some(buffers, ec);
+    if (ec) {
+      throw asio::system_error(ec);
+    }
+    return size;
+  }
+
+ private:
+  /// @brief Buffers gathered into one send.
+  static constexpr std::size_t kMaxIovecs = 64;
+
+  struct State;
+
+  explicit IoUringStream(std::unique_ptr<State> state);
+
+  auto ReadSome(void *data, std::size_t size, asio::error_code &ec)
+      -> std::size_t;
+
+  /// @brief Receives directly into the caller's buffer, for kernels that
+  /// cannot fill buffers from the ring.
+  auto ReceiveSome(void *data, std::size_t size, asio::error_code &ec)
+      -> std::size_t;
+  auto WriteSome(const iovec *iovecs, std::size_t count, asio::error_code &ec)
+      -> std::size_t;
+
+  std::unique_ptr<State> state_;
+};
+
+}  // namespace jsonrpc::transport
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+namespace jsonrpc::transport {
+
+/**
+ * @brief Interface for transports that can parse a message while receiving
+ * it.
+ *
+ * A transport implementing this may hand the server parsed JSON instead of a
+ * string, so that decoding a large message overlaps with reading it and the
+ * raw message is never held in memory as a whole.
+ */
+class JsonReceiver {
+ public:
+  JsonReceiver() = default;
+  virtual ~JsonReceiver() = default;
+
+  JsonReceiver(const JsonReceiver &) = default;
+  auto operator=(const JsonReceiver &) -> JsonReceiver & = default;
+
+  JsonReceiver(JsonReceiver &&) = delete;
+  auto operator=(JsonReceiver &&) -> JsonReceiver & = delete;
+
+  /// @brief Whether messages should be received with ReceiveJson rather than
+  /// as strings.
+  [[nodiscard]] virtual auto IsStreaming() const -> bool = 0;
+
+  /**
+   * @brief Receives the next message, parsing it as it is read.
+   *
+   * @return The message, or a discarded value if it is not valid JSON. The
+   * whole message is consumed either way.
+   * @throws std::runtime_error if the transport fails.
+   */
+  virtual auto ReceiveJson() -> nlohmann::json = 0;
+};
+
+}  // namespace jsonrpc::transport
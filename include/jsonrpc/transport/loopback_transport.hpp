@@ -0,0 +1,115 @@
+#pragma once
+
+#include <asio.hpp>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "jsonrpc/transport/async_transport.hpp"
+
+namespace jsonrpc::transport {
+
+/**
+ * @brief One end of an in-process transport pair, for a client and server in
+ * the same process.
+ *
+ * Each end receives from a lock-free multi-producer single-consumer queue
+ * that the other end sends into. A message is moved into the queue and out
+ * again, so a string handed over with SendMessage(std::string &&) reaches
+ * the receiver without being copied, framed or passing through the kernel.
+ * Sends never block. A receiver waiting for an empty queue sleeps on an
+ * atomic that senders only notify while someone is waiting.
+ *
+ * Any number of threads may send. Blocking receivers are serialized, and
+ * asynchronous receives follow the rules of AsyncTransport. Close() on either
+ * end ends the pair for both: pending messages can still be received, after
+ * which ReceiveMessage() throws and asynchronous receives complete with
+ * asio::error::eof.
+ */
+class LoopbackTransport : public AsyncTransport {
+ public:
+  /// @brief The two connected ends.
+  using Pair = std::pair<
+      std::unique_ptr<LoopbackTransport>, std::unique_ptr<LoopbackTransport>>;
+
+  /**
+   * @brief Creates a connected pair for blocking use.
+   *
+   * Only the blocking interface is usable; asynchronous operations throw
+   * std::logic_error.
+   */
+  static auto CreatePair() -> Pair;
+
+  /**
+   * @brief Creates a connected pair whose asynchronous operations complete
+   * on the given io_context.
+   */
+  static auto CreatePair(asio::io_context &io_context) -> Pair;
+
+  /// @brief Closes the pair.
+  ~LoopbackTransport() override;
+
+  LoopbackTransport(const LoopbackTransport &) = delete;
+  auto operator=(const LoopbackTransport &) -> LoopbackTransport & = delete;
+
+  LoopbackTransport(LoopbackTransport &&) = delete;
+  auto operator=(LoopbackTransport &&) -> LoopbackTransport & = delete;
+
+  /**
+   * @brief Copies a message into the peer's queue.
+   *
+   * @throws std::runtime_error if the pair is closed.
+   */
+  void SendMessage(const std::string &message) override;
+
+  /**
+   * @brief Moves a message into the peer's queue.
+   *
+   * @throws std::runtime_error if the pair is closed.
+   */
+  void SendMessage(std::string &&message) override;
+
+  /**
+   * @brief Takes the next message from this end's queue, blocking while it
+   * is empty.
+   *
+   * @throws std::runtime_error once the pair is closed and the queue is
+   * empty.
+   */
+  auto ReceiveMessage() -> std::string override;
+
+  /// @brief Closes the pair and wakes receivers on both ends.
+  void Close() override;
+
+  [[nodiscard]] auto GetExecutor() -> asio::any_io_executor override;
+
+ protected:
+  [[nodiscard]] auto SupportsAsync() const -> bool override;
+  void DoAsyncSendMessage(std::string message, SendHandler handler) override;
+  void DoAsyncReceiveMessage(ReceiveHandler handler) override;
+
+ private:
+  class Inbox;
+
+  LoopbackTransport(
+      std::shared_ptr<asio::io_context> owned_io_context,
+      asio::any_io_executor executor, std::shared_ptr<Inbox> inbox,
+      std::shared_ptr<Inbox> peer_inbox);
+
+  /// @brief Creates both ends around a pair of queues.
+  static auto CreatePair(
+      std::shared_ptr<asio::io_context> owned_io_context,
+      asio::any_io_executor executor) -> Pair;
+
+  /// @brief Shared by both ends of a pair created without an io_context.
+  std::shared_ptr<asio::io_context> owned_io_context_;
+  asio::any_io_executor executor_;
+
+  /// @brief The queue this end receives from.
+  std::shared_ptr<Inbox> inbox_;
+
+  /// @brief The queue this end sends into.
+  std::shared_ptr<Inbox> peer_inbox_;
+};
+
+}  // namespace jsonrpc::transport
@@ -1,9 +1,11 @@
 #pragma once
 
 #include <asio.hpp>
+#include <memory>
 #include <string>
 
-#include "jsonrpc/transport/transport.hpp"
+#include "jsonrpc/transport/socket_options.hpp"
+#include "jsonrpc/transport/stream_transport.hpp"
 
 namespace jsonrpc::transport {
 
@@ -14,15 +16,38 @@ namespace jsonrpc::transport {
  * supporting both client and server modes for inter-process communication
  * on the same machine.
  */
-class PipeTransport : public Transport {
+class PipeTransport : public StreamTransport<asio::local::stream_protocol> {
  public:
   /**
    * @brief Constructs a PipeTransport.
+   *
+   * Only blocking I/O is available; asynchronous operations throw.
+   *
    * @param socketPath Path to the Unix domain socket.
    * @param isServer True if the transport acts as a server; false if it acts as
    * a client.
+   * @param options Socket settings; TCP-only ones are ignored.
    */
-  PipeTransport(const std::string &socket_path, bool is_server);
+  PipeTransport(
+      const std::string &socket_path, bool is_server,
+      const SocketOptions &options = {});
+
+  /**
+   * @brief Constructs a PipeTransport whose socket runs on the given
+   * io_context.
+   *
+   * Connecting or accepting still blocks. Asynchronous operations complete
+   * when the caller runs the io_context.
+   *
+   * @param io_context The io_context to run asynchronous operations on.
+   * @param socket_path Path to the Unix domain socket.
+   * @param is_server True if the transport acts as a server; false if it acts
+   * as a client.
+   * @param options Socket settings; TCP-only ones are ignored.
+   */
+  PipeTransport(
+      asio::io_context &io_context, const std::string &socket_path,
+      bool is_server, const SocketOptions &options = {});
 
   ~PipeTransport() override;
 
@@ -32,21 +57,19 @@ class PipeTransport : public Transport {
   PipeTransport(PipeTransport &&) = delete;
   auto operator=(PipeTransport &&) -> PipeTransport & = delete;
 
-  void SendMessage(const std::string &message) override;
-  auto ReceiveMessage() -> std::string override;
-
- protected:
-  auto GetSocket() -> asio::local::stream_protocol::socket &;
-
  private:
+  PipeTransport(
+      std::unique_ptr<asio::io_context> owned_io_context,
+      asio::io_context *io_context, const std::string &socket_path,
+      bool is_server, const SocketOptions &options);
+
   void RemoveExistingSocketFile();
   void Connect();
   void BindAndListen();
 
-  asio::io_context io_context_;
-  asio::local::stream_protocol::socket socket_;
   std::string socket_path_;
   bool is_server_;
+  SocketOptions options_;
 };
 
 }  // namespace jsonrpc::transport
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+
+#include "jsonrpc/transport/capture_format.hpp"
+#include "jsonrpc/transport/transport.hpp"
+
+namespace jsonrpc::transport {
+
+/// @brief How quickly a ReplayTransport delivers captured messages.
+enum class ReplayPacing {
+  /// @brief Keep the gaps between messages that were recorded.
+  kRecorded,
+
+  /// @brief Deliver each message as soon as it is asked for.
+  kAsFastAsPossible,
+};
+
+/// @brief Options for a ReplayTransport.
+struct ReplayOptions {
+  /// @brief How quickly messages are delivered.
+  ReplayPacing pacing = ReplayPacing::kAsFastAsPossible;
+
+  /**
+   * @brief Which captured messages ReceiveMessage() delivers.
+   *
+   * kReceived replays what a captured server received, i.e. the requests.
+   * For a capture taken on the client side, use kSent.
+   */
+  CaptureDirection direction = CaptureDirection::kReceived;
+};
+
+/**
+ * @brief Transport that plays back a capture file written by
+ * CaptureTransport.
+ *
+ * The file is memory-mapped and read in order, so a Server given this
+ * transport handles a recorded session as if the original peer were
+ * connected. Messages are returned without copying more than once. Once the
+ * capture is exhausted, ReceiveMessage() throws, which stops a Server.
+ * Messages sent to the transport are counted and discarded. A record cut
+ * short at the end of the file is ignored.
+ */
+class ReplayTransport : public Transport {
+ public:
+  /**
+   * @brief Maps a capture file for playback.
+   *
+   * @param path The capture file.
+   * @param options Pacing and the direction to replay.
+   * @throws std::runtime_error if the file cannot be mapped or is not a
+   * capture file.
+   */
+  explicit ReplayTransport(const std::string &path, ReplayOptions options = {});
+
+  ~ReplayTransport() override;
+
+  ReplayTransport(const ReplayTransport &) = delete;
+  auto operator=(const ReplayTransport &) -> ReplayTransport & = delete;
+
+  ReplayTransport(ReplayTransport &&) = delete;
+  auto operator=(ReplayTransport &&) -> ReplayTransport & = delete;
+
+  using Transport::SendMessage;
+
+  /// @brief Counts and discards a message.
+  void SendMessage(const std::string &message) override;
+
+  /**
+   * @brief Returns the next captured message in the replayed direction.
+   *
+   * With ReplayPacing::kRecorded, waits until the message is due relative to
+   * the first one delivered.
+   *
+   * @throws std::runtime_error once the capture is exhausted or the transport
+   * is closed.
+   */
+  auto ReceiveMessage() -> std::string override;
+
+  /// @brief Ends the replay, waking a ReceiveMessage() waiting for a message
+  /// to become due.
+  void Close() override;
+
+  /// @brief Gets the framing recorded in the capture file.
+  [[nodiscard]] auto GetFraming() const -> CaptureFraming;
+
+  /// @brief Gets the number of messages delivered so far.
+  [[nodiscard]] auto GetReceivedCount() const -> std::size_t;
+
+  /// @brief Gets the number of messages sent to the transport so far.
+  [[nodiscard]] auto GetSentCount() const -> std::size_t;
+
+ private:
+  /// @brief A record located in the mapping.
+  struct Record {
+    std::int64_t timestamp;
+    CaptureDirection direction;
+    const char *data;
+    std::size_t size;
+  };
+
+  /// @brief Reads the record at the cursor and advances past it.
+  auto NextRecord() -> std::optional<Record>;
+
+  /// @brief Waits until a record is due. Returns false if closed first.
+  auto WaitUntilDue(const Record &record) -> bool;
+
+  ReplayOptions options_;
+  const char *data_ = nullptr;
+  std::size_t size_ = 0;
+  std::size_t cursor_ = 0;
+  CaptureFraming framing_ = CaptureFraming::kNone;
+
+  /// @brief Timestamp of the first delivered record and when it was
+  /// delivered, for recorded pacing.
+  std::optional<std::int64_t> first_timestamp_;
+  std::chrono::steady_clock::time_point start_;
+
+  std::atomic<std::size_t> received_count_ = 0;
+  std::atomic<std::size_t> sent_count_ = 0;
+
+  std::mutex mutex_;
+  std::condition_variable closed_cv_;
+  bool closed_ = false;
+};
+
+}  // namespace jsonrpc::transport
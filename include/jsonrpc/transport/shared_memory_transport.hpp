@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+
+#include "jsonrpc/transport/transport.hpp"
+
+namespace jsonrpc::transport {
+
+/// @brief Options for a SharedMemoryTransport.
+struct SharedMemoryOptions {
+  /// @brief Bytes per direction, rounded up to a power of two. Only the
+  /// server's value is used; the client adopts the size of the mapping.
+  std::size_t ring_capacity = 1024 * 1024;
+
+  /// @brief Polls of the ring before a waiting side sleeps on a futex.
+  int spin_iterations = 2000;
+};
+
+/**
+ * @brief Transport over a pair of single-producer single-consumer rings in
+ * POSIX shared memory, for a client and server on the same host.
+ *
+ * The server creates the shared memory object `name` (as for shm_open, e.g.
+ * "/my-service") and the client maps it. Each direction has its own ring, so
+ * a message costs two copies, into and out of the ring, and no system call
+ * unless the other side is asleep. A side waiting for data or space first
+ * polls the ring, then sleeps on a futex in the shared mapping that the other
+ * side wakes after publishing.
+ *
+ * Concurrent senders within a process are serialized, as are concurrent
+ * receivers. Close() on either side ends the session for both: pending
+ * messages can still be received, after which ReceiveMessage() throws. A peer
+ * that exits without closing is not detected.
+ *
+ * Linux only.
+ */
+class SharedMemoryTransport : public Transport {
+ public:
+  /**
+   * @brief Constructs a SharedMemoryTransport.
+   *
+   * The server replaces any existing object with the same name and returns
+   * without waiting for a client. The client fails if the object does not
+   * exist.
+   *
+   * @param name Name of the shared memory object.
+   * @param is_server True to create the object; false to open it.
+   * @param options Ring size and wait strategy.
+   * @throws std::runtime_error if the object cannot be created or opened.
+   */
+  SharedMemoryTransport(
+      const std::string &name, bool is_server,
+      SharedMemoryOptions options = {});
+
+  /// @brief Closes the session and unmaps the rings. The server also removes
+  /// the shared memory object.
+  ~SharedMemoryTransport() override;
+
+  SharedMemoryTransport(const SharedMemoryTransport &) = delete;
+  auto operator=(const SharedMemoryTransport &)
+      -> SharedMemoryTransport & = delete;
+
+  SharedMemoryTransport(SharedMemoryTransport &&) = delete;
+  auto operator=(SharedMemoryTransport &&) -> SharedMemoryTransport & = delete;
+
+  using Transport::SendMessage;
+
+  /**
+   * @brief Copies a message into the outgoing ring.
+   *
+   * Blocks while the ring lacks space for it.
+   *
+   * @throws std::runtime_error if the message is larger than the ring or the
+   * session is closed.
+   */
+  void SendMessage(const std::string &message) override;
+
+  /**
+   * @brief Takes the next message from the incoming ring.
+   *
+   * @throws std::runtime_error once the session is closed and the ring is
+   * empty.
+   */
+  auto ReceiveMessage() -> std::string override;
+
+  /// @brief Closes the session and wakes both sides.
+  void Close() override;
+
+ private:
+  struct Region;
+  struct Ring;
+
+  void Create(std::size_t ring_capacity);
+  void Open();
+
+  /**
+   * @brief Maps the shared memory object.
+   *
+   * @param fd The open shared memory object.
+   * @param size The number of bytes to map.
+   */
+  void Map(int fd, std::size_t size);
+
+  /// @brief Locates the rings once the mapping is initialized.
+  void AttachRings();
+
+  std::string name_;
+  bool is_server_;
+  SharedMemoryOptions options_;
+
+  void *mapping_ = nullptr;
+  std::size_t mapping_size_ = 0;
+
+  Region *region_ = nullptr;
+  Ring *send_ring_ = nullptr;
+  Ring *receive_ring_ = nullptr;
+  char *send_data_ = nullptr;
+  char *receive_data_ = nullptr;
+
+  /// @brief Size of each ring's storage, a power of two.
+  std::size_t capacity_ = 0;
+
+  std::mutex send_mutex_;
+  std::mutex receive_mutex_;
+};
+
+}  // namespace jsonrpc::transport
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <asio.hpp>
+#include <chrono>
+#include <optional>
+
+namespace jsonrpc::transport {
+
+/**
+ * @brief Socket settings for the socket and pipe transports.
+ *
+ * TCP-only settings are ignored by the Unix domain socket transports.
+ * Settings the platform rejects are logged and skipped.
+ */
+struct SocketOptions {
+  /// @brief Disables Nagle's algorithm (TCP_NODELAY), so that small
+  /// messages are sent at once. TCP only.
+  bool no_delay = true;
+
+  /// @brief Kernel send buffer size (SO_SNDBUF); the system default if unset.
+  std::optional<int> send_buffer_size;
+
+  /// @brief Kernel receive buffer size (SO_RCVBUF); the system default if
+  /// unset. Servers set it on the listening socket too, so that it applies
+  /// from the handshake on.
+  std::optional<int> receive_buffer_size;
+
+  /// @brief Enables TCP keepalive probes (SO_KEEPALIVE). TCP only.
+  bool keep_alive = false;
+
+  /// @brief Lets several servers listen on the same port (SO_REUSEPORT).
+  /// TCP only.
+  bool reuse_port = false;
+
+  /// @brief Length of the queue of pending connections for servers.
+  int listen_backlog = asio::socket_base::max_listen_connections;
+
+  /// @brief How long clients wait for a connection to be established.
+  std::chrono::milliseconds connect_timeout = std::chrono::seconds(3);
+};
+
+/**
+ * @brief Applies the per-connection settings to a connected socket.
+ *
+ * @param socket The socket.
+ * @param options The settings.
+ */
+void ApplySocketOptions(
+    asio::ip::tcp::socket &socket, const SocketOptions &options);
+void ApplySocketOptions(
+    asio::local::stream_protocol::socket &socket,
+    const SocketOptions &options);
+
+/**
+ * @brief Applies the settings that must precede bind to an open acceptor.
+ *
+ * @param acceptor The acceptor, open but not yet bound.
+ * @param options The settings.
+ */
+void ApplyAcceptorOptions(
+    asio::ip::tcp::acceptor &acceptor, const SocketOptions &options);
+void ApplyAcceptorOptions(
+    asio::local::stream_protocol::acceptor &acceptor,
+    const SocketOptions &options);
+
+}  // namespace jsonrpc::transport
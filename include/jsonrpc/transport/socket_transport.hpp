@@ -1,9 +1,11 @@
 #pragma once
 
 #include <asio.hpp>
+#include <memory>
 #include <string>
 
-#include "jsonrpc/transport/transport.hpp"
+#include "jsonrpc/transport/socket_options.hpp"
+#include "jsonrpc/transport/stream_transport.hpp"
 
 namespace jsonrpc::transport {
 
@@ -13,16 +15,40 @@ namespace jsonrpc::transport {
  * This class provides transport functionality over TCP/IP sockets,
  * supporting both client and server modes for communication over a network.
  */
-class SocketTransport : public Transport {
+class SocketTransport : public StreamTransport<asio::ip::tcp> {
  public:
   /**
    * @brief Constructs a SocketTransport.
+   *
+   * Only blocking I/O is available; asynchronous operations throw.
+   *
    * @param host The host address (IP or domain name).
    * @param port The port number.
    * @param isServer True if the transport acts as a server; false if it acts as
    * a client.
+   * @param options Socket settings.
    */
-  SocketTransport(const std::string &host, uint16_t port, bool is_server);
+  SocketTransport(
+      const std::string &host, uint16_t port, bool is_server,
+      const SocketOptions &options = {});
+
+  /**
+   * @brief Constructs a SocketTransport whose socket runs on the given
+   * io_context.
+   *
+   * Connecting or accepting still blocks. Asynchronous operations complete
+   * when the caller runs the io_context.
+   *
+   * @param io_context The io_context to run asynchronous operations on.
+   * @param host The host address (IP or domain name).
+   * @param port The port number.
+   * @param is_server True if the transport acts as a server; false if it acts
+   * as a client.
+   * @param options Socket settings.
+   */
+  SocketTransport(
+      asio::io_context &io_context, const std::string &host, uint16_t port,
+      bool is_server, const SocketOptions &options = {});
 
   ~SocketTransport() override;
 
@@ -32,21 +58,19 @@ class SocketTransport : public Transport {
   SocketTransport(SocketTransport &&) = delete;
   auto operator=(SocketTransport &&) -> SocketTransport & = delete;
 
-  void SendMessage(const std::string &message) override;
-  auto ReceiveMessage() -> std::string override;
-
- protected:
-  auto GetSocket() -> asio::ip::tcp::socket &;
-
  private:
+  SocketTransport(
+      std::unique_ptr<asio::io_context> owned_io_context,
+      asio::io_context *io_context, const std::string &host, uint16_t port,
+      bool is_server, const SocketOptions &options);
+
   void Connect();
   void BindAndListen();
 
-  asio::io_context io_context_;
-  asio::ip::tcp::socket socket_;
   std::string host_;
   uint16_t port_;
   bool is_server_;
+  SocketOptions options_;
 };
 
 }  // namespace jsonrpc::transport
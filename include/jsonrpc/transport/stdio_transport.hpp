@@ -1,18 +1,122 @@
 #pragma once
 
+#include <asio.hpp>
+#include <cstddef>
+#include <mutex>
 #include <string>
+#include <string_view>
 
+#include "jsonrpc/transport/fd_stream.hpp"
 #include "jsonrpc/transport/transport.hpp"
+#include "jsonrpc/transport/write_queue.hpp"
 
 namespace jsonrpc::transport {
 
+/// @brief When a stdio transport writes sent messages to its output.
+enum class FlushPolicy {
+  /// @brief Write each message as it is sent, as std::endl used to.
+  kEveryMessage,
+
+  /**
+   * @brief Collect messages in the output buffer and write them together
+   * when it fills up, when Flush() or Close() is called, or before
+   * ReceiveMessage() waits for input.
+   *
+   * Suits a server that answers each request before reading the next. A
+   * client that waits for responses on another thread must call Flush().
+   */
+  kWhenFull,
+};
+
+/// @brief Options for the stdio transports.
+struct StdioOptions {
+  /// @brief Descriptor messages are read from; standard input by default.
+  int input_fd = 0;
+
+  /// @brief Descriptor messages are written to; standard output by default.
+  int output_fd = 1;
+
+  /// @brief Initial size of the receive buffer.
+  std::size_t read_buffer_size = 64 * 1024;
+
+  /// @brief Bytes collected before they are written, for kWhenFull.
+  std::size_t write_buffer_size = 64 * 1024;
+
+  /// @brief When sent messages are written.
+  FlushPolicy flush_policy = FlushPolicy::kEveryMessage;
+};
+
 /**
  * @brief Transport layer using standard I/O for JSON-RPC communication.
+ *
+ * Messages are newline-delimited. Input and output go straight to the file
+ * descriptors through buffers owned by the transport, bypassing iostreams,
+ * so the process must not also use std::cin or std::cout for them.
+ * Concurrent sends are serialized by a WriteQueue and coalesced into one
+ * write when they overlap.
  */
 class StdioTransport : public Transport {
  public:
+  explicit StdioTransport(StdioOptions options = {});
+
+  /// @brief Writes any collected output.
+  ~StdioTransport() override;
+
+  StdioTransport(const StdioTransport &) = delete;
+  auto operator=(const StdioTransport &) -> StdioTransport & = delete;
+
+  StdioTransport(StdioTransport &&) = delete;
+  auto operator=(StdioTransport &&) -> StdioTransport & = delete;
+
   void SendMessage(const std::string &message) override;
+  void SendMessage(std::string &&message) override;
   auto ReceiveMessage() -> std::string override;
+
+  /// @brief Writes any output collected under FlushPolicy::kWhenFull.
+  void Flush();
+
+  /// @brief Writes any collected output and ends a blocked or later
+  /// ReceiveMessage. The descriptors stay open.
+  void Close() override;
+
+ protected:
+  /// @brief Gets the input stream.
+  auto GetInput() -> FdStream &;
+
+  /// @brief Gets the receive buffer.
+  auto GetReadBuffer() -> asio::streambuf &;
+
+  /**
+   * @brief Writes or collects one message according to the flush policy.
+   *
+   * @param prefix Bytes written before the body, at most
+   * WriteQueue::kMaxPrefixSize.
+   * @param body The message.
+   * @param suffix Bytes written after the body.
+   * @throws std::runtime_error if the output cannot be written.
+   */
+  void Write(
+      std::string_view prefix, std::string &&body, std::string_view suffix);
+  void Write(
+      std::string_view prefix, const std::string &body,
+      std::string_view suffix);
+
+  /// @brief Writes collected output before a read that may block.
+  void FlushBeforeRead();
+
+ private:
+  /// @brief Writes the collected output. Requires output_mutex_.
+  void FlushLocked();
+
+  StdioOptions options_;
+  FdStream input_;
+  FdStream output_;
+  asio::streambuf read_buffer_;
+  WriteQueue write_queue_;
+
+  /// @brief Output collected under FlushPolicy::kWhenFull.
+  std::string pending_output_;
+  std::mutex output_mutex_;
 };
 
 }  // namespace jsonrpc::transport
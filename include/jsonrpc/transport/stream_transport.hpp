@@ -0,0 +1,138 @@
+#pragma once
+
+#include <asio.hpp>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "jsonrpc/transport/async_transport.hpp"
+#include "jsonrpc/transport/io_uring_stream.hpp"
+#include "jsonrpc/transport/write_queue.hpp"
+
+namespace jsonrpc::transport {
+
+/**
+ * @brief Newline-delimited transport over a connected stream socket.
+ *
+ * Holds the socket, receive buffer and write queue shared by PipeTransport
+ * and SocketTransport, which only differ in how the socket is connected.
+ * Instantiated for `asio::local::stream_protocol` and `asio::ip::tcp`.
+ *
+ * @tparam Protocol The Asio stream protocol of the socket.
+ */
+template <typename Protocol>
+class StreamTransport : public AsyncTransport {
+ public:
+  /// @brief The socket type.
+  using Socket = typename Protocol::socket;
+
+  /// @brief Closes the socket.
+  ~StreamTransport() override;
+
+  StreamTransport(const StreamTransport &) = delete;
+  auto operator=(const StreamTransport &) -> StreamTransport & = delete;
+
+  StreamTransport(StreamTransport &&) = delete;
+  auto operator=(StreamTransport &&) -> StreamTransport & = delete;
+
+  void SendMessage(const std::string &message) override;
+  void SendMessage(std::string &&message) override;
+  auto ReceiveMessage() -> std::string override;
+
+  /// @brief Shuts down the socket, waking any blocked reader.
+  void Close() override;
+
+  [[nodiscard]] auto GetExecutor() -> asio::any_io_executor override;
+
+ protected:
+  /**
+   * @brief Constructs the transport around an unconnected socket.
+   *
+   * @param owned_io_context The io_context to own, or nullptr if the caller
+   * supplies one.
+   * @param io_context The caller's io_context, or nullptr to use the owned
+   * one.
+   */
+  StreamTransport(
+      std::unique_ptr<asio::io_context> owned_io_context,
+      asio::io_context *io_context);
+
+  auto GetSocket() -> Socket &;
+
+  /**
+   * @brief Gets the receive buffer.
+   *
+   * Bytes read past the end of a message stay in this buffer and are consumed
+   * by the next ReceiveMessage() call before the socket is read again.
+   */
+  auto GetReadBuffer() -> asio::streambuf &;
+
+  /**
+   * @brief Gets the queue that serializes and coalesces writes to the socket.
+   */
+  auto GetWriteQueue() -> WriteQueue &;
+
+  /**
+   * @brief Switches blocking I/O to io_uring once the socket is connected.
+   *
+   * Asynchronous operations stay on Asio, so io_uring is only used when all
+   * I/O is blocking, i.e. when no io_context was supplied.
+   */
+  void EnableIoUring();
+
+  [[nodiscard]] auto SupportsAsync() const -> bool override;
+  void DoAsyncSendMessage(std::string message, SendHandler handler) override;
+  void DoAsyncReceiveMessage(ReceiveHandler handler) override;
+
+  /**
+   * @brief Calls a function with the stream used for blocking I/O.
+   *
+   * That is an io_uring stream when the library is built with io_uring
+   * support, the kernel provides it and the transport owns its io_context;
+   * otherwise it is the socket.
+   *
+   * @param function Called with the stream.
+   * @return What the function returns.
+   */
+  template <typename Function>
+  auto WithStream(Function &&function) -> decltype(auto) {
+    if (uring_stream_ != nullptr) {
+      return function(*uring_stream_);
+    }
+    return function(socket_);
+  }
+
+ private:
+  /**
+   * @brief Removes a complete line from the front of the receive buffer.
+   *
+   * @param length The length of the line, including the newline.
+   * @return The line without its newline.
+   */
+  auto TakeLine(std::size_t length) -> std::string;
+
+  /**
+   * @brief Shuts the socket down in both directions, ending blocked reads.
+   *
+   * The socket stays open until destruction, so that a shutdown never races
+   * with another thread's use of the descriptor.
+   */
+  void ShutdownSocket();
+
+  /// @brief The io_context created when none is supplied by the caller.
+  std::unique_ptr<asio::io_context> owned_io_context_;
+  Socket socket_;
+  asio::streambuf read_buffer_;
+  WriteQueue write_queue_;
+
+  /// @brief Serializes shutdown between Close() and a failed receive.
+  std::mutex shutdown_mutex_;
+
+  /// @brief Set when blocking I/O goes through io_uring.
+  std::unique_ptr<IoUringStream> uring_stream_;
+};
+
+extern template class StreamTransport<asio::local::stream_protocol>;
+extern template class StreamTransport<asio::ip::tcp>;
+
+}  // namespace jsonrpc::transport
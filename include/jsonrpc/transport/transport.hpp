@@ -1,9 +1,22 @@
 #pragma once
 
+#include <stdexcept>
 #include <string>
 
 namespace jsonrpc::transport {
 
+/**
+ * @brief Error thrown when a received message exceeds the transport's size
+ * limit.
+ *
+ * The message has been skipped without being stored, so the transport stays
+ * usable and the next receive returns the message after it.
+ */
+class MessageTooLargeError : public std::runtime_error {
+ public:
+  using std::runtime_error::runtime_error;
+};
+
 /**
  * @brief Base class for JSON-RPC transport.
  *
@@ -26,11 +39,35 @@ class Transport {
    */
   virtual void SendMessage(const std::string &message) = 0;
 
+  /**
+   * @brief Sends a message whose buffer the transport may take over.
+   *
+   * Transports that queue or hand off outgoing data override this to keep the
+   * buffer instead of copying it. The default sends it like any other message.
+   *
+   * @param message The JSON-RPC message as a string.
+   */
+  virtual void SendMessage(std::string &&message) {
+    SendMessage(static_cast<const std::string &>(message));
+  }
+
   /**
    * @brief Receives a message from the transport layer.
    * @return The JSON-RPC response as a string.
+   * @throws MessageTooLargeError if the message was skipped for its size.
    */
   virtual auto ReceiveMessage() -> std::string = 0;
+
+  /**
+   * @brief Unblocks any pending ReceiveMessage call and stops further I/O.
+   *
+   * May be called from a thread other than the one blocked in
+   * ReceiveMessage. Client::Stop relies on this to end its listener thread,
+   * so every transport used with a Client must override it; the default
+   * no-op only suits transports whose reads never block indefinitely.
+   */
+  virtual void Close() {
+  }
 };
 
 }  // namespace jsonrpc::transport
@@ -0,0 +1,298 @@
+#pragma once
+
+#include <array>
+#include <asio.hpp>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace jsonrpc::transport {
+
+/// @brief Options for a WriteQueue.
+struct WriteQueueOptions {
+  /// @brief Bytes gathered into one write before the rest is left queued.
+  std::size_t max_write_bytes = 256 * 1024;
+
+  /// @brief Queued bytes beyond which senders block until the queue drains.
+  std::size_t max_queued_bytes = 4 * 1024 * 1024;
+};
+
+/**
+ * @brief Serializes concurrent sends on a stream and coalesces their writes.
+ *
+ * There is no writer thread. The first sender to find the stream idle
+ * becomes the writer and writes its own message straight from the caller's
+ * buffer. Senders that find a write in progress queue their message; the
+ * first of them waits to take over the writer role, and the rest return.
+ * When a writer finishes, it hands the role to that waiting sender, which
+ * writes everything queued up to then, gathered into as few writes as
+ * `max_write_bytes` allows. A writer therefore only writes what was queued
+ * when it took the role, and a steady stream of other senders never keeps
+ * one caller writing indefinitely.
+ *
+ * Each message is written as an optional short prefix, the body and an
+ * optional suffix, so framing never requires copying the body. When more than
+ * `max_queued_bytes` are waiting, senders block until the writer catches up.
+ *
+ * Asynchronous sends join the same queue. If no one is writing, they start a
+ * chain of asynchronous writes that drains the queue without blocking the
+ * caller; their handlers run once their message has been written. They are
+ * never blocked by the queue limit. Messages queued only by asynchronous
+ * sends behind a blocking writer are handed to such a chain.
+ *
+ * If a write fails, the writer receives the exception, queued messages are
+ * dropped and every later send throws the same error.
+ */
+class WriteQueue {
+ public:
+  /// @brief Longest prefix a message may carry.
+  static constexpr std::size_t kMaxPrefixSize = 128;
+
+  /// @brief Writes a buffer sequence in full or throws.
+  using Writer =
+      std::function<void(const std::vector<asio::const_buffer> &buffers)>;
+
+  /// @brief Completion handler for asynchronous sends and writes.
+  using Handler = std::function<void(const asio::error_code &ec)>;
+
+  /**
+   * @brief Starts writing a buffer sequence in full and calls the handler when
+   * done. The buffers stay valid until then.
+   */
+  using AsyncWriter = std::function<void(
+      const std::vector<asio::const_buffer> &buffers, Handler handler)>;
+
+  /**
+   * @brief Constructs a WriteQueue.
+   *
+   * @param writer Called by the writing sender, never concurrently.
+   * @param options Batching and backpressure limits.
+   */
+  explicit WriteQueue(Writer writer, WriteQueueOptions options = {});
+
+  /**
+   * @brief Constructs a WriteQueue that also supports asynchronous sends.
+   *
+   * @param writer Called by the writing sender, never concurrently.
+   * @param async_writer Used to drain the queue for asynchronous sends.
+   * Never called concurrently with itself or with writer.
+   * @param options Batching and backpressure limits.
+   */
+  WriteQueue(
+      Writer writer, AsyncWriter async_writer, WriteQueueOptions options = {});
+
+  ~WriteQueue() = default;
+
+  WriteQueue(const WriteQueue &) = delete;
+  auto operator=(const WriteQueue &) -> WriteQueue & = delete;
+
+  WriteQueue(WriteQueue &&) = delete;
+  auto operator=(WriteQueue &&) -> WriteQueue & = delete;
+
+  /**
+   * @brief Sends a message, copying it only if it has to be queued.
+   *
+   * @param prefix Bytes written before the body, at most kMaxPrefixSize.
+   * @param body The message body.
+   * @param suffix Bytes written after the body. Must refer to static storage.
+   */
+  void Send(
+      std::string_view prefix, const std::string &body,
+      std::string_view suffix = {});
+
+  /**
+   * @brief Sends a message, keeping its buffer if it has to be queued.
+   *
+   * @param prefix Bytes written before the body, at most kMaxPrefixSize.
+   * @param body The message body.
+   * @param suffix Bytes written after the body. Must refer to static storage.
+   */
+  void Send(
+      std::string_view prefix, std::string &&body,
+      std::string_view suffix = {});
+
+  /**
+   * @brief Queues a message and returns without waiting for it to be written.
+   *
+   * The handler runs once the message has been written or dropped, on
+   * whichever thread completed the write; transports forward it to their
+   * executor. Requires a queue constructed with an AsyncWriter.
+   *
+   * @param prefix Bytes written before the body, at most kMaxPrefixSize.
+   * @param body The message body.
+   * @param suffix Bytes written after the body. Must refer to static storage.
+   * @param handler Called with the outcome of the write.
+   */
+  void AsyncSend(
+      std::string_view prefix, std::string body, std::string_view suffix,
+      Handler handler);
+
+  /**
+   * @brief Fails later sends and wakes senders blocked on backpressure.
+   *
+   * A write already in progress is not interrupted.
+   */
+  void Close();
+
+  /// @brief Gets the number of bytes waiting to be written.
+  [[nodiscard]] auto GetQueuedBytes() const -> std::size_t;
+
+ private:
+  /// @brief A queued message.
+  struct Entry {
+    std::array<char, kMaxPrefixSize> prefix;
+    std::size_t prefix_size = 0;
+    std::string body;
+    std::string_view suffix;
+
+    /// @brief Set for asynchronous sends.
+    Handler handler;
+
+    [[nodiscard]] auto Size() const -> std::size_t;
+    void AppendBuffers(std::vector<asio::const_buffer> &buffers) const;
+  };
+
+  /**
+   * @brief Sends a message whose body is stored by the caller.
+   *
+   * @param prefix Bytes written before the body.
+   * @param body The message body.
+   * @param suffix Bytes written after the body.
+   * @param movable_body The body again if it may be moved into the queue, or
+   * nullptr if it has to be copied.
+   */
+  void SendImpl(
+      std::string_view prefix, const std::string &body,
+      std::string_view suffix, std::string *movable_body);
+
+  /**
+   * @brief Appends a message to the queue.
+   *
+   * @return The queued entry.
+   */
+  auto EnqueueLocked(
+      std::string_view prefix, std::string body, std::string_view suffix)
+      -> Entry &;
+
+  /**
+   * @brief Moves the next batch of queued messages into a vector.
+   *
+   * @param batch Cleared, then filled with at least one entry.
+   * @param limit The most entries to take, at least one.
+   */
+  void TakeBatchLocked(std::vector<Entry> &batch, std::size_t limit);
+
+  /**
+   * @brief Queues a message behind a blocking writer and, if no other sender
+   * is waiting to, waits to take over the writer role.
+   *
+   * @param lock A lock on mutex_, held on entry and on return.
+   */
+  void EnqueueBehindWriterLocked(
+      std::unique_lock<std::mutex> &lock, std::string_view prefix,
+      std::string body, std::string_view suffix);
+
+  /**
+   * @brief Writes the first queued messages, then hands on the writer role.
+   *
+   * @param lock A lock on mutex_, held on entry and on return.
+   * @param count The number of messages to write.
+   */
+  void DrainLocked(std::unique_lock<std::mutex> &lock, std::size_t count);
+
+  /**
+   * @brief Gives up the writer role: to the waiting sender if there is one,
+   * to an asynchronous chain if only asynchronous sends are queued, or not at
+   * all if the queue is empty.
+   *
+   * @param lock A lock on mutex_, held on entry and on return.
+   */
+  void ReleaseWriterLocked(std::unique_lock<std::mutex> &lock);
+
+  /**
+   * @brief Starts an asynchronous write of the next batch, or releases the
+   * writer role if the queue is empty.
+   *
+   * @param lock A lock on mutex_, released on return.
+   */
+  void WriteNextAsyncLocked(std::unique_lock<std::mutex> &lock);
+
+  /**
+   * @brief Completes an asynchronous write and continues draining.
+   *
+   * @param ec The outcome of the write.
+   */
+  void OnAsyncWriteDone(const asio::error_code &ec);
+
+  /**
+   * @brief Records a write failure and drops queued messages.
+   *
+   * @param error The exception thrown by the writer.
+   * @return The dropped messages, whose handlers are still to be called.
+   */
+  auto FailLocked(std::exception_ptr error) -> std::vector<Entry>;
+
+  /**
+   * @brief Calls the handlers of asynchronously sent messages.
+   *
+   * @param entries The written or dropped messages.
+   * @param ec The outcome reported to the handlers.
+   */
+  static void NotifyWritten(
+      std::vector<Entry> &entries, const asio::error_code &ec);
+
+  /**
+   * @brief Converts a stored write failure into an error code.
+   *
+   * @param error The exception thrown by the writer.
+   * @return The error code carried by the exception, or a generic failure.
+   */
+  static auto ToErrorCode(const std::exception_ptr &error) -> asio::error_code;
+
+  /// @brief Throws if the queue is closed or a write has failed.
+  void ThrowIfUnusableLocked() const;
+
+  Writer writer_;
+  AsyncWriter async_writer_;
+  WriteQueueOptions options_;
+
+  mutable std::mutex mutex_;
+
+  /// @brief Signalled when queued bytes drop or the queue becomes unusable.
+  std::condition_variable space_cv_;
+
+  std::deque<Entry> queue_;
+  std::size_t queued_bytes_ = 0;
+
+  /// @brief The batch being written asynchronously, and its buffers.
+  std::vector<Entry> in_flight_;
+  std::vector<asio::const_buffer> in_flight_buffers_;
+
+  /// @brief Whether a sender or an asynchronous chain holds the writer role.
+  bool writing_ = false;
+
+  /// @brief Whether the writer role is held by an asynchronous chain, which
+  /// drains the whole queue.
+  bool async_writing_ = false;
+
+  /// @brief Senders that have waited for the writer role, counting the one
+  /// waiting now, if any.
+  std::uint64_t successors_ = 0;
+
+  /// @brief Senders that have been handed the writer role.
+  std::uint64_t handoffs_ = 0;
+
+  /// @brief Number of queued messages the last handed-off sender writes.
+  std::size_t handoff_count_ = 0;
+  bool closed_ = false;
+  std::exception_ptr error_;
+};
+
+}  // namespace jsonrpc::transport
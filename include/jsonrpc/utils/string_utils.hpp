@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cctype>
+#include <cstddef>
 #include <ranges>
 #include <string>
 #include <string_view>
@@ -13,4 +14,32 @@ auto Trim(std::string_view in) -> std::string {
   return {view.begin(), view.end()};
 }
 
+/// @brief Strips leading and trailing spaces and tabs without copying.
+inline auto TrimView(std::string_view in) -> std::string_view {
+  constexpr std::string_view kBlank = " \t";
+  std::size_t begin = in.find_first_not_of(kBlank);
+  if (begin == std::string_view::npos) {
+    return {};
+  }
+  std::size_t end = in.find_last_not_of(kBlank);
+  return in.substr(begin, end - begin + 1);
+}
+
+/// @brief Compares two ASCII strings, ignoring case.
+inline auto EqualsIgnoreCase(std::string_view lhs, std::string_view rhs)
+    -> bool {
+  if (lhs.size() != rhs.size()) {
+    return false;
+  }
+  auto lower = [](char c) {
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+  };
+  for (std::size_t i = 0; i < lhs.size(); ++i) {
+    if (lower(lhs[i]) != lower(rhs[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
 }  // namespace jsonrpc::utils
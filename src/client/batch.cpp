@@ -0,0 +1,28 @@
+#include "jsonrpc/client/batch.hpp"
+
+namespace jsonrpc::client {
+
+auto Batch::AddMethodCall(
+    const std::string &method,
+    std::optional<nlohmann::json> params) -> std::future<nlohmann::json> {
+  std::promise<nlohmann::json> promise;
+  auto future = promise.get_future();
+  entries_.push_back(Entry{method, std::move(params), std::move(promise)});
+  num_calls_++;
+  return future;
+}
+
+void Batch::AddNotification(
+    const std::string &method, std::optional<nlohmann::json> params) {
+  entries_.push_back(Entry{method, std::move(params), std::nullopt});
+}
+
+auto Batch::Size() const -> std::size_t {
+  return entries_.size();
+}
+
+auto Batch::IsEmpty() const -> bool {
+  return entries_.empty();
+}
+
+}  // namespace jsonrpc::client
@@ -0,0 +1,58 @@
+#include "jsonrpc/client/call_awaitable.hpp"
+
+#include "jsonrpc/client/client.hpp"
+
+namespace jsonrpc::client {
+
+CallAwaitable::CallAwaitable(
+    Client &client, std::string method, std::optional<nlohmann::json> params,
+    std::shared_ptr<executor::Executor> executor,
+    std::optional<std::chrono::milliseconds> timeout)
+    : client_(client),
+      method_(std::move(method)),
+      params_(std::move(params)),
+      executor_(std::move(executor)),
+      timeout_(timeout) {
+}
+
+auto CallAwaitable::await_ready() const noexcept -> bool {
+  return false;
+}
+
+void CallAwaitable::await_suspend(std::coroutine_handle<> handle) {
+  handle_ = handle;
+  Request request(std::move(method_), std::move(params_), false, [this]() {
+    return client_.GetNextRequestId();
+  });
+  client_.SendRequestTo(request, this, timeout_);
+}
+
+auto CallAwaitable::await_resume() -> nlohmann::json {
+  if (error_) {
+    std::rethrow_exception(error_);
+  }
+  return response_->ToJson();
+}
+
+void CallAwaitable::OnResponse(RawResponse response) {
+  response_ = std::move(response);
+  Resume();
+}
+
+void CallAwaitable::OnError(std::exception_ptr error) {
+  error_ = std::move(error);
+  Resume();
+}
+
+void CallAwaitable::Resume() {
+  // The coroutine may destroy this awaitable as soon as it resumes, so
+  // nothing may touch members afterwards.
+  auto handle = handle_;
+  if (executor_) {
+    executor_->Execute([handle]() { handle.resume(); });
+  } else {
+    handle.resume();
+  }
+}
+
+}  // namespace jsonrpc::client
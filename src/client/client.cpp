@@ -1,23 +1,67 @@
 #include "jsonrpc/client/client.hpp"
 
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
 #include <spdlog/spdlog.h>
 
 namespace jsonrpc::client {
 
+namespace {
+
+/// The JSON-RPC error code for an invalid request.
+constexpr int kInvalidRequestCode = -32600;
+
+}  // namespace
+
 Client::Client(std::unique_ptr<transport::Transport> transport)
-    : transport_(std::move(transport)) {
+    : Client(std::move(transport), ClientOptions{}) {
+}
+
+Client::Client(
+    std::unique_ptr<transport::Transport> transport, ClientOptions options)
+    : transport_(std::move(transport)),
+      pending_calls_(std::make_shared<PendingCallTable>()),
+      default_timeout_(options.default_timeout),
+      timer_wheel_(
+          options.timer_wheel ? std::move(options.timer_wheel)
+                              : TimerWheel::GetShared()),
+      pending_batches_(std::make_shared<PendingBatches>()),
+      auto_batch_(options.auto_batch) {
   spdlog::info("Initializing JSON-RPC client");
 }
 
+Client::~Client() {
+  if (listener_.joinable() || flusher_.joinable()) {
+    Stop();
+  }
+}
+
 void Client::Start() {
   spdlog::info("Starting JSON-RPC client");
   is_running_.store(true);
   listener_ = std::thread(&Client::Listener, this);
+  if (auto_batch_.enabled) {
+    flusher_stopping_ = false;
+    flusher_ = std::thread(&Client::Flusher, this);
+  }
 }
 
 void Client::Stop() {
   spdlog::info("Stopping JSON-RPC client");
+  {
+    std::lock_guard<std::mutex> lock(outbox_mutex_);
+    flusher_stopping_ = true;
+  }
+  outbox_cv_.notify_all();
+  if (flusher_.joinable()) {
+    flusher_.join();
+  }
+  Flush();
+
   is_running_.store(false);
+  transport_->Close();
   if (listener_.joinable()) {
     listener_.join();
   }
@@ -28,52 +72,326 @@ auto Client::IsRunning() const -> bool {
 }
 
 auto Client::HasPendingRequests() const -> bool {
-  std::lock_guard<std::mutex> lock(requests_mutex_);
-  return !requests_map_.empty();
+  return !pending_calls_->IsEmpty();
+}
+
+auto Client::GetPendingRequestCount() const -> std::size_t {
+  return pending_calls_->Size();
+}
+
+auto Client::GetPendingBatchCount() const -> std::size_t {
+  return pending_batches_->Size();
 }
 
 void Client::Listener() {
   spdlog::info("Starting JSON-RPC client listener thread");
   while (is_running_) {
-    if (expected_count_ > 0) {
-      std::string response = transport_->ReceiveMessage();
-      HandleResponse(response);
-      expected_count_--;
+    std::string response;
+    try {
+      response = transport_->ReceiveMessage();
+    } catch (const transport::MessageTooLargeError &e) {
+      // The response was skipped; its call fails when it times out.
+      spdlog::error("Dropping response: {}", e.what());
+      continue;
+    } catch (const std::exception &e) {
+      if (is_running_) {
+        spdlog::error(
+            "Client listener stopped on transport error: {}", e.what());
+      }
+      break;
+    }
+    if (response.empty()) {
+      continue;
+    }
+    HandleResponse(std::move(response));
+  }
+  pending_calls_->FailAll("Client stopped before a response was received");
+  pending_batches_->Clear();
+}
+
+void Client::Flusher() {
+  std::unique_lock<std::mutex> lock(outbox_mutex_);
+  while (true) {
+    outbox_cv_.wait(
+        lock, [this]() { return flusher_stopping_ || outbox_count_ > 0; });
+    if (flusher_stopping_) {
+      return;
+    }
+    // The outbox may be sent early by a threshold and refilled before the
+    // deadline; flushing the refilled outbox early is harmless.
+    outbox_cv_.wait_until(lock, outbox_deadline_, [this]() {
+      return flusher_stopping_ || outbox_count_ == 0;
+    });
+    FlushOutboxLocked(lock);
+  }
+}
+
+void Client::Send(const Request &request) {
+  if (!auto_batch_.enabled) {
+    // Reuse one encoding buffer per thread instead of a string per request.
+    thread_local std::string buffer;
+    buffer.clear();
+    request.DumpTo(buffer);
+    transport_->SendMessage(buffer);
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(outbox_mutex_);
+  std::size_t rollback_size = outbox_.size();
+  try {
+    if (outbox_count_ > 0) {
+      outbox_ += ',';
+    } else {
+      outbox_ = '[';
+    }
+    request.DumpTo(outbox_);
+  } catch (...) {
+    outbox_.resize(rollback_size);
+    throw;
+  }
+  if (outbox_count_ == 0) {
+    outbox_deadline_ = std::chrono::steady_clock::now() + auto_batch_.window;
+  }
+  outbox_count_++;
+  if (request.RequiresResponse()) {
+    outbox_ids_.push_back(request.GetKey());
+  }
+
+  if (outbox_count_ >= auto_batch_.max_messages ||
+      outbox_.size() >= auto_batch_.max_bytes) {
+    FlushOutboxLocked(lock);
+  } else if (outbox_count_ == 1) {
+    outbox_cv_.notify_one();
+  }
+}
+
+void Client::Flush() {
+  if (!auto_batch_.enabled) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(outbox_mutex_);
+  FlushOutboxLocked(lock);
+}
+
+void Client::FlushOutboxLocked(std::unique_lock<std::mutex> &lock) {
+  if (outbox_count_ == 0) {
+    return;
+  }
+
+  std::string message;
+  if (outbox_count_ == 1) {
+    message = outbox_.substr(1);
+  } else {
+    outbox_ += ']';
+    message = std::move(outbox_);
+  }
+  std::vector<int> request_ids = std::move(outbox_ids_);
+  outbox_.clear();
+  outbox_ids_.clear();
+  outbox_count_ = 0;
+
+  try {
+    transport_->SendMessage(std::move(message));
+  } catch (const std::exception &e) {
+    spdlog::error("Failed to send batched messages: {}", e.what());
+    auto error = std::current_exception();
+    lock.unlock();
+    for (int request_id : request_ids) {
+      pending_calls_->Fail(request_id, error);
     }
+    lock.lock();
   }
 }
 
 auto Client::SendMethodCall(
-    const std::string &method,
-    std::optional<nlohmann::json> params) -> nlohmann::json {
+    const std::string &method, std::optional<nlohmann::json> params,
+    std::optional<std::chrono::milliseconds> timeout) -> nlohmann::json {
+  Request request(method, std::move(params), false, [this]() {
+    return GetNextRequestId();
+  });
+  return SendRequest(request, timeout);
+}
+
+auto Client::SendMethodCallAsync(
+    const std::string &method, std::optional<nlohmann::json> params,
+    std::optional<std::chrono::milliseconds> timeout)
+    -> std::future<nlohmann::json> {
+  Request request(method, std::move(params), false, [this]() {
+    return GetNextRequestId();
+  });
+  return SendRequestAsync(request, timeout);
+}
+
+auto Client::SendMethodCall(
+    const PreparedMethod &method, std::optional<nlohmann::json> params,
+    std::optional<std::chrono::milliseconds> timeout) -> nlohmann::json {
   Request request(method, std::move(params), false, [this]() {
     return GetNextRequestId();
   });
-  return SendRequest(request);
+  return SendRequest(request, timeout);
 }
 
 auto Client::SendMethodCallAsync(
-    const std::string &method,
-    std::optional<nlohmann::json> params) -> std::future<nlohmann::json> {
+    const PreparedMethod &method, std::optional<nlohmann::json> params,
+    std::optional<std::chrono::milliseconds> timeout)
+    -> std::future<nlohmann::json> {
+  Request request(method, std::move(params), false, [this]() {
+    return GetNextRequestId();
+  });
+  return SendRequestAsync(request, timeout);
+}
+
+auto Client::SendMethodCallRaw(
+    const std::string &method, std::optional<nlohmann::json> params,
+    std::optional<std::chrono::milliseconds> timeout)
+    -> std::future<RawResponse> {
+  Request request(method, std::move(params), false, [this]() {
+    return GetNextRequestId();
+  });
+  return SendRequestRaw(request, timeout);
+}
+
+auto Client::Call(
+    const std::string &method, std::optional<nlohmann::json> params,
+    std::shared_ptr<executor::Executor> executor,
+    std::optional<std::chrono::milliseconds> timeout) -> CallAwaitable {
+  return CallAwaitable(
+      *this, method, std::move(params), std::move(executor), timeout);
+}
+
+auto Client::SendMethodCallTo(
+    CallWaiter &waiter, const std::string &method,
+    std::optional<nlohmann::json> params,
+    std::optional<std::chrono::milliseconds> timeout) -> int {
   Request request(method, std::move(params), false, [this]() {
     return GetNextRequestId();
   });
-  return SendRequestAsync(request);
+  SendRequestTo(request, &waiter, timeout);
+  return request.GetKey();
+}
+
+auto Client::CancelCall(int request_id) -> bool {
+  return pending_calls_->Remove(request_id);
 }
 
 void Client::SendNotification(
     const std::string &method, std::optional<nlohmann::json> params) {
   Request request(
       method, std::move(params), true, [this]() { return GetNextRequestId(); });
-  transport_->SendMessage(request.Dump());
+  Send(request);
 }
 
-auto Client::SendRequest(const Request &request) -> nlohmann::json {
-  auto future_response = SendRequestAsync(request);
-  return future_response.get();
+void Client::SendNotification(
+    const PreparedMethod &method, std::optional<nlohmann::json> params) {
+  Request request(
+      method, std::move(params), true, [this]() { return GetNextRequestId(); });
+  Send(request);
 }
 
-auto Client::SendRequestAsync(const Request &request)
+void Client::SendBatch(Batch batch) {
+  if (batch.IsEmpty()) {
+    spdlog::warn("Ignoring empty batch");
+    return;
+  }
+
+  // Reserve a contiguous ID range so the batch can be found from any of its
+  // responses.
+  int num_calls = static_cast<int>(batch.num_calls_);
+  int first_id = req_id_counter_.fetch_add(num_calls);
+  int next_id = first_id;
+  bool registered = false;
+
+  try {
+    std::string message = "[";
+    for (auto &entry : batch.entries_) {
+      bool is_notification = !entry.promise.has_value();
+      Request request(
+          std::move(entry.method), std::move(entry.params), is_notification,
+          [&next_id]() { return next_id++; });
+      if (!is_notification) {
+        pending_calls_->Add(request.GetKey(), std::move(*entry.promise));
+      }
+      request.DumpTo(message);
+      message += ',';
+    }
+    message.back() = ']';
+
+    // Registered only once all its calls are, so that the batch never counts
+    // calls the table does not hold yet.
+    if (num_calls > 0) {
+      pending_batches_->Add({first_id, num_calls});
+      registered = true;
+    }
+    transport_->SendMessage(std::move(message));
+  } catch (...) {
+    // Calls that already completed, for example because the listener took
+    // the batch for a rejection, have been notified and are left alone.
+    if (!registered || pending_batches_->Take({first_id}).has_value()) {
+      auto error = std::current_exception();
+      for (int request_id = first_id; request_id < next_id; ++request_id) {
+        pending_calls_->Fail(request_id, error);
+      }
+    }
+    throw;
+  }
+
+  if (num_calls > 0 && default_timeout_.has_value()) {
+    // The calls of a batch share one deadline, so a single timer expires
+    // them all and forgets the batch.
+    timer_wheel_->Schedule(
+        *default_timeout_,
+        [table = std::weak_ptr<PendingCallTable>(pending_calls_),
+         batches = std::weak_ptr<PendingBatches>(pending_batches_),
+         first_id, num_calls]() {
+          auto pending_calls = table.lock();
+          auto pending_batches = batches.lock();
+          if (!pending_calls || !pending_batches ||
+              !pending_batches->Take({first_id}).has_value()) {
+            return;
+          }
+          auto error =
+              std::make_exception_ptr(TimeoutError("Request timed out"));
+          for (int request_id = first_id; request_id < first_id + num_calls;
+               ++request_id) {
+            if (pending_calls->Fail(request_id, error)) {
+              spdlog::warn("Request ID {} timed out", request_id);
+            }
+          }
+        });
+  }
+}
+
+auto Client::SendRequest(
+    const Request &request,
+    std::optional<std::chrono::milliseconds> timeout) -> nlohmann::json {
+  // Parsing here rather than on the listener thread keeps the listener free
+  // to route other responses while this one is decoded.
+  return SendRequestRaw(request, timeout).get().ToJson();
+}
+
+auto Client::SendRequestRaw(
+    const Request &request, std::optional<std::chrono::milliseconds> timeout)
+    -> std::future<RawResponse> {
+  PendingCallTable::RawPromise response_promise;
+  auto future_response = response_promise.get_future();
+  pending_calls_->Add(request.GetKey(), std::move(response_promise));
+  ArmTimeout(request.GetKey(), timeout);
+
+  try {
+    Send(request);
+  } catch (...) {
+    // A call that already completed, for example by timing out, delivers its
+    // outcome through the future instead.
+    if (pending_calls_->Remove(request.GetKey())) {
+      throw;
+    }
+  }
+
+  return future_response;
+}
+
+auto Client::SendRequestAsync(
+    const Request &request, std::optional<std::chrono::milliseconds> timeout)
     -> std::future<nlohmann::json> {
   assert(
       request.RequiresResponse() &&
@@ -83,77 +401,254 @@ auto Client::SendRequestAsync(const Request &request)
   std::promise<nlohmann::json> response_promise;
   auto future_response = response_promise.get_future();
 
-  {
-    std::lock_guard<std::mutex> lock(requests_mutex_);
-    requests_map_[request.GetKey()] = std::move(response_promise);
-  }
-  expected_count_++;
+  pending_calls_->Add(request.GetKey(), std::move(response_promise));
+  ArmTimeout(request.GetKey(), timeout);
 
-  transport_->SendMessage(request.Dump());
+  try {
+    Send(request);
+  } catch (...) {
+    // A call that already completed, for example by timing out, delivers its
+    // outcome through the future instead.
+    if (pending_calls_->Remove(request.GetKey())) {
+      throw;
+    }
+  }
 
   return future_response;
 }
 
+void Client::SendRequestTo(
+    const Request &request, CallWaiter *waiter,
+    std::optional<std::chrono::milliseconds> timeout) {
+  pending_calls_->Add(request.GetKey(), waiter);
+  ArmTimeout(request.GetKey(), timeout);
+
+  try {
+    Send(request);
+  } catch (...) {
+    // If the call already completed, for example by timing out, the waiter
+    // has been notified and must not also see the exception.
+    if (pending_calls_->Remove(request.GetKey())) {
+      throw;
+    }
+  }
+}
+
+void Client::ArmTimeout(
+    int request_id, std::optional<std::chrono::milliseconds> timeout) {
+  if (!timeout.has_value()) {
+    timeout = default_timeout_;
+  }
+  if (!timeout.has_value()) {
+    return;
+  }
+
+  // The timer is not cancelled when the response arrives, which would take
+  // the wheel's lock a second time per call; completing the call first
+  // simply makes the expiry a failed lookup. The callback fits in the
+  // timer's node, so an expired-but-dead timer costs no allocation.
+  timer_wheel_->Schedule(
+      *timeout,
+      [table = std::weak_ptr<PendingCallTable>(pending_calls_), request_id]() {
+        auto pending_calls = table.lock();
+        if (!pending_calls) {
+          return;
+        }
+        if (pending_calls->Fail(
+                request_id, std::make_exception_ptr(TimeoutError(
+                                "Request timed out")))) {
+          spdlog::warn("Request ID {} timed out", request_id);
+        }
+      });
+}
+
 auto Client::GetNextRequestId() -> int {
   return req_id_counter_++;
 }
 
-void Client::HandleResponse(const std::string &response) {
-  nlohmann::json json_response;
+void Client::HandleResponse(std::string response) {
+  auto message = std::make_shared<const std::string>(std::move(response));
+  std::optional<std::vector<RawResponse::Range>> elements;
+  std::optional<int> request_id;
+  bool may_reject_batch = false;
   try {
-    json_response = nlohmann::json::parse(response);
+    elements = RawResponse::SplitBatch(*message);
+    if (!elements.has_value()) {
+      auto single = RawResponse::Scan(message, {0, message->size()});
+      request_id = single.GetId();
+      may_reject_batch = !request_id.has_value() && IsBatchRejection(single);
+      RouteResponse(std::move(single));
+    }
   } catch (const std::exception &e) {
-    spdlog::error("Failed to parse JSON response: {}", e.what());
-    throw std::runtime_error(
-        "Failed to parse JSON response: " + std::string(e.what()));
+    spdlog::warn("Ignoring invalid or unsolicited message: {}", e.what());
+    return;
+  }
+  if (elements.has_value()) {
+    HandleBatchResponse(message, *elements);
+  } else if (request_id.has_value()) {
+    if (!pending_batches_->IsEmpty()) {
+      ResolveBatch({*request_id}, *message);
+    }
+  } else if (may_reject_batch) {
+    RejectOldestBatch(*message);
   }
+}
 
-  if (ValidateResponse(json_response)) {
-    int request_id = json_response["id"].get<int>();
+auto Client::IsBatchRejection(const RawResponse &response) const -> bool {
+  if (pending_batches_->IsEmpty() || response.GetRawId() != "null" ||
+      !response.IsError()) {
+    return false;
+  }
+  // Parse errors and errors for single calls carry a null ID as well. Only
+  // an Invalid Request error that no single call can have caused is taken
+  // for the rejection of a whole batch.
+  auto error = response.GetError();
+  return error.is_object() && error.value("code", 0) == kInvalidRequestCode &&
+         pending_calls_->Size() <= pending_batches_->CallCount();
+}
 
-    std::lock_guard<std::mutex> lock(requests_mutex_);
-    auto req_iter = requests_map_.find(request_id);
-    if (req_iter != requests_map_.end()) {
-      req_iter->second.set_value(json_response);
-      requests_map_.erase(req_iter);
-    } else {
-      spdlog::error("Received response for unknown request ID: {}", request_id);
-      throw std::runtime_error(
-          "Received response for unknown request ID: " +
-          std::to_string(request_id));
+void Client::RejectOldestBatch(const std::string &message) {
+  if (auto range = pending_batches_->TakeOldest()) {
+    spdlog::warn(
+        "Batch of request IDs {} to {} was rejected", range->first,
+        range->first + range->second - 1);
+    FailBatchCalls(*range, {}, "Batch rejected by the server: " + message);
+  }
+}
+
+void Client::HandleBatchResponse(
+    const std::shared_ptr<const std::string> &message,
+    const std::vector<RawResponse::Range> &elements) {
+  // IDs of every element, routed or not, so that a late answer still
+  // identifies its batch.
+  std::vector<int> answered_ids;
+  answered_ids.reserve(elements.size());
+  for (const auto &element : elements) {
+    try {
+      auto response = RawResponse::Scan(message, element);
+      if (auto request_id = response.GetId()) {
+        answered_ids.push_back(*request_id);
+      }
+      RouteResponse(std::move(response));
+    } catch (const std::exception &e) {
+      spdlog::warn("Ignoring invalid batch response element: {}", e.what());
     }
-  } else {
-    spdlog::error("Invalid JSON-RPC response: {}", json_response.dump());
-    throw std::runtime_error(
-        "Invalid JSON-RPC response: " + json_response.dump());
+  }
+  if (!pending_batches_->IsEmpty()) {
+    ResolveBatch(std::move(answered_ids), *message);
   }
 }
 
-auto Client::ValidateResponse(const nlohmann::json &response) -> bool {
-  if (!response.contains("jsonrpc") || response["jsonrpc"] != "2.0") {
-    return false;
+void Client::ResolveBatch(
+    std::vector<int> answered_ids, const std::string &message) {
+  if (answered_ids.empty()) {
+    // Nothing identifies the batch; a server that cannot process a batch at
+    // all answers it with errors whose ID is null.
+    RejectOldestBatch(message);
+    return;
   }
 
-  if (!response.contains("id")) {
-    return false;
+  if (auto range = pending_batches_->Take(answered_ids)) {
+    std::sort(answered_ids.begin(), answered_ids.end());
+    FailBatchCalls(
+        *range, answered_ids, "Response missing from batch response");
   }
+}
 
-  bool has_result = response.contains("result");
-  bool has_error = response.contains("error");
+void Client::FailBatchCalls(
+    PendingBatches::Range range, const std::vector<int> &answered_ids,
+    const std::string &message) {
+  auto error = std::make_exception_ptr(std::runtime_error(message));
+  auto [first_id, num_calls] = range;
+  for (int request_id = first_id; request_id < first_id + num_calls;
+       ++request_id) {
+    if (std::binary_search(
+            answered_ids.begin(), answered_ids.end(), request_id)) {
+      continue;
+    }
+    if (pending_calls_->Fail(request_id, error)) {
+      spdlog::warn("Request ID {} failed: {}", request_id, message);
+    }
+  }
+}
 
-  if (has_result == has_error) {  // Mutually exclusive
-    return false;
+auto Client::RouteResponse(RawResponse response) -> std::optional<int> {
+  auto request_id = response.GetId();
+  if (!request_id.has_value()) {
+    spdlog::error(
+        "Received response with non-integer ID: {}", response.GetRawId());
+    return std::nullopt;
+  }
+
+  if (!pending_calls_->Complete(*request_id, std::move(response))) {
+    if (*request_id >= 0 && *request_id < req_id_counter_.load()) {
+      spdlog::debug("Discarding late response for request ID {}", *request_id);
+    } else {
+      spdlog::error(
+          "Received response for unknown request ID: {}", *request_id);
+    }
+    return std::nullopt;
   }
+  return request_id;
+}
+
+void Client::PendingBatches::Add(Range range) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  batches_.emplace(range);
+  calls_ += static_cast<std::size_t>(range.second);
+  size_.store(batches_.size(), std::memory_order_relaxed);
+}
 
-  if (has_error) {
-    const nlohmann::json &error = response["error"];
-    if (!error.contains("code") || !error["code"].is_number() ||
-        !error.contains("message") || !error["message"].is_string()) {
-      return false;
+auto Client::PendingBatches::Take(const std::vector<int> &request_ids)
+    -> std::optional<Range> {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (int request_id : request_ids) {
+    auto it = batches_.upper_bound(request_id);
+    if (it == batches_.begin()) {
+      continue;
+    }
+    --it;
+    if (request_id < it->first + it->second) {
+      Range range = *it;
+      batches_.erase(it);
+      calls_ -= static_cast<std::size_t>(range.second);
+      size_.store(batches_.size(), std::memory_order_relaxed);
+      return range;
     }
   }
+  return std::nullopt;
+}
+
+auto Client::PendingBatches::TakeOldest() -> std::optional<Range> {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (batches_.empty()) {
+    return std::nullopt;
+  }
+  Range range = *batches_.begin();
+  batches_.erase(batches_.begin());
+  calls_ -= static_cast<std::size_t>(range.second);
+  size_.store(batches_.size(), std::memory_order_relaxed);
+  return range;
+}
+
+void Client::PendingBatches::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  batches_.clear();
+  calls_ = 0;
+  size_.store(0, std::memory_order_relaxed);
+}
+
+auto Client::PendingBatches::IsEmpty() const -> bool {
+  return Size() == 0;
+}
+
+auto Client::PendingBatches::Size() const -> std::size_t {
+  return size_.load(std::memory_order_relaxed);
+}
 
-  return true;
+auto Client::PendingBatches::CallCount() -> std::size_t {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return calls_;
 }
 
 }  // namespace jsonrpc::client
@@ -0,0 +1,385 @@
+#include "jsonrpc/client/client_pool.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+namespace jsonrpc::client {
+
+/// @brief State of a call that may be sent more than once.
+struct ClientPool::HedgedCall {
+  std::string method;
+  std::optional<nlohmann::json> params;
+  std::optional<std::chrono::milliseconds> timeout;
+  std::promise<nlohmann::json> promise;
+
+  /// Guards every field below and the `finished` flag of each attempt.
+  std::mutex mutex;
+  bool done = false;
+  std::size_t outstanding = 0;
+  std::optional<TimerWheel::TimerId> hedge_timer;
+  std::vector<std::unique_ptr<Attempt>> attempts;
+};
+
+/// @brief One send of a hedged call over a single connection.
+struct ClientPool::Attempt : public CallWaiter {
+  Attempt(
+      ClientPool &pool, std::shared_ptr<HedgedCall> call,
+      std::size_t client_index)
+      : pool(pool), call(std::move(call)), client_index(client_index) {
+  }
+
+  void OnResponse(RawResponse response) override {
+    auto owner = std::move(call);
+    pool.OnAttemptResponse(owner, *this, std::move(response));
+  }
+
+  void OnError(std::exception_ptr error) override {
+    auto owner = std::move(call);
+    pool.OnAttemptError(owner, *this, std::move(error));
+  }
+
+  ClientPool &pool;
+  /// Keeps the call alive until this attempt is notified or cancelled.
+  std::shared_ptr<HedgedCall> call;
+  std::size_t client_index;
+  std::chrono::steady_clock::time_point sent_at;
+  std::atomic<int> request_id{-1};
+  bool finished = false;
+};
+
+ClientPool::ClientPool(
+    std::vector<std::unique_ptr<transport::Transport>> transports,
+    ClientPoolOptions options)
+    : load_balancing_(options.load_balancing),
+      hedging_(std::move(options.hedging)),
+      budget_(hedging_.budget_ratio, hedging_.budget_reserve),
+      latencies_(hedging_.hedge_percentile) {
+  if (transports.empty()) {
+    throw std::invalid_argument("ClientPool requires at least one transport");
+  }
+  clients_.reserve(transports.size());
+  for (auto &transport : transports) {
+    clients_.push_back(
+        std::make_unique<Client>(std::move(transport), options.client));
+  }
+  if (hedging_.hedge && hedging_.max_attempts > 1 &&
+      !hedging_.idempotent_methods.empty()) {
+    hedge_timers_ = std::make_unique<TimerWheel>(std::chrono::milliseconds(1));
+  }
+  spdlog::info("Initializing JSON-RPC client pool of {}", clients_.size());
+}
+
+ClientPool::~ClientPool() {
+  {
+    std::unique_lock<std::shared_mutex> lock(lifetime_mutex_);
+    stopping_ = true;
+  }
+  // Join the hedge timer thread before the clients go away.
+  hedge_timers_.reset();
+  Stop();
+}
+
+void ClientPool::Start() {
+  for (auto &client : clients_) {
+    client->Start();
+  }
+}
+
+void ClientPool::Stop() {
+  for (auto &client : clients_) {
+    client->Stop();
+  }
+}
+
+auto ClientPool::IsRunning() const -> bool {
+  return clients_.front()->IsRunning();
+}
+
+auto ClientPool::Size() const -> std::size_t {
+  return clients_.size();
+}
+
+auto ClientPool::SendMethodCall(
+    const std::string &method, std::optional<nlohmann::json> params,
+    std::optional<std::chrono::milliseconds> timeout) -> nlohmann::json {
+  if (IsHedged(method)) {
+    return SendHedged(method, std::move(params), timeout).get();
+  }
+  return SelectClient().SendMethodCall(method, std::move(params), timeout);
+}
+
+auto ClientPool::SendMethodCallAsync(
+    const std::string &method, std::optional<nlohmann::json> params,
+    std::optional<std::chrono::milliseconds> timeout)
+    -> std::future<nlohmann::json> {
+  if (IsHedged(method)) {
+    return SendHedged(method, std::move(params), timeout);
+  }
+  return SelectClient().SendMethodCallAsync(
+      method, std::move(params), timeout);
+}
+
+auto ClientPool::Call(
+    const std::string &method, std::optional<nlohmann::json> params,
+    std::shared_ptr<executor::Executor> executor,
+    std::optional<std::chrono::milliseconds> timeout) -> CallAwaitable {
+  return SelectClient().Call(
+      method, std::move(params), std::move(executor), timeout);
+}
+
+void ClientPool::SendNotification(
+    const std::string &method, std::optional<nlohmann::json> params) {
+  SelectClient().SendNotification(method, std::move(params));
+}
+
+void ClientPool::SendBatch(Batch batch) {
+  SelectClient().SendBatch(std::move(batch));
+}
+
+auto ClientPool::HasPendingRequests() const -> bool {
+  for (const auto &client : clients_) {
+    if (client->HasPendingRequests()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+auto ClientPool::SelectClient() -> Client & {
+  return *clients_[SelectIndex()];
+}
+
+auto ClientPool::SelectIndex() -> std::size_t {
+  std::size_t num_clients = clients_.size();
+  if (num_clients == 1) {
+    return 0;
+  }
+
+  switch (load_balancing_) {
+    case LoadBalancing::kRoundRobin:
+      break;
+    case LoadBalancing::kLeastOutstanding: {
+      // Start the scan at a rotating offset so ties are spread evenly.
+      std::size_t start = next_.fetch_add(1, std::memory_order_relaxed);
+      std::size_t best = start % num_clients;
+      std::size_t best_load = clients_[best]->GetPendingRequestCount();
+      for (std::size_t i = 1; i < num_clients && best_load > 0; ++i) {
+        std::size_t index = (start + i) % num_clients;
+        std::size_t load = clients_[index]->GetPendingRequestCount();
+        if (load < best_load) {
+          best = index;
+          best_load = load;
+        }
+      }
+      return best;
+    }
+    case LoadBalancing::kPowerOfTwoChoices: {
+      thread_local std::minstd_rand generator(std::random_device{}());
+      std::size_t first = std::uniform_int_distribution<std::size_t>(
+          0, num_clients - 1)(generator);
+      // Draw the second choice from the remaining connections.
+      std::size_t second = std::uniform_int_distribution<std::size_t>(
+          0, num_clients - 2)(generator);
+      if (second >= first) {
+        second++;
+      }
+      return clients_[first]->GetPendingRequestCount() <=
+                     clients_[second]->GetPendingRequestCount()
+                 ? first
+                 : second;
+    }
+  }
+
+  return next_.fetch_add(1, std::memory_order_relaxed) % num_clients;
+}
+
+auto ClientPool::IsHedged(const std::string &method) const -> bool {
+  return hedging_.max_attempts > 1 &&
+         hedging_.idempotent_methods.contains(method);
+}
+
+auto ClientPool::SendHedged(
+    const std::string &method, std::optional<nlohmann::json> params,
+    std::optional<std::chrono::milliseconds> timeout)
+    -> std::future<nlohmann::json> {
+  auto call = std::make_shared<HedgedCall>();
+  call->method = method;
+  call->params = std::move(params);
+  call->timeout = timeout;
+  auto future = call->promise.get_future();
+
+  budget_.Deposit();
+  LaunchAttempt(call);
+  ScheduleHedge(call);
+  return future;
+}
+
+void ClientPool::LaunchAttempt(const std::shared_ptr<HedgedCall> &call) {
+  Attempt *attempt = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(call->mutex);
+    if (call->done || call->attempts.size() >= hedging_.max_attempts) {
+      return;
+    }
+
+    // Prefer a connection this call has not used yet.
+    std::size_t index = SelectIndex();
+    for (std::size_t i = 0; i < clients_.size(); ++i) {
+      bool used = std::any_of(
+          call->attempts.begin(), call->attempts.end(),
+          [index](const auto &other) { return other->client_index == index; });
+      if (!used) {
+        break;
+      }
+      index = (index + 1) % clients_.size();
+    }
+
+    call->attempts.push_back(std::make_unique<Attempt>(*this, call, index));
+    attempt = call->attempts.back().get();
+    call->outstanding++;
+  }
+
+  // The clients outlive every thread that can get here, so only new sends
+  // during shutdown need to be refused.
+  std::exception_ptr error;
+  if (stopping_) {
+    error = std::make_exception_ptr(
+        std::runtime_error("Client pool is shutting down"));
+  } else {
+    attempt->sent_at = std::chrono::steady_clock::now();
+    try {
+      attempt->request_id = clients_[attempt->client_index]->SendMethodCallTo(
+          *attempt, call->method, call->params, call->timeout);
+    } catch (...) {
+      error = std::current_exception();
+    }
+  }
+  if (error) {
+    attempt->OnError(error);
+  }
+}
+
+void ClientPool::ScheduleHedge(const std::shared_ptr<HedgedCall> &call) {
+  std::shared_lock<std::shared_mutex> lifetime(lifetime_mutex_);
+  if (stopping_ || !hedge_timers_) {
+    return;
+  }
+
+  auto delay = std::chrono::ceil<std::chrono::milliseconds>(
+      latencies_.Get().value_or(hedging_.initial_hedge_delay));
+  std::lock_guard<std::mutex> lock(call->mutex);
+  if (call->done || call->attempts.size() >= hedging_.max_attempts) {
+    return;
+  }
+  call->hedge_timer = hedge_timers_->Schedule(
+      delay, [this, weak_call = std::weak_ptr<HedgedCall>(call)]() {
+        auto call = weak_call.lock();
+        if (!call) {
+          return;
+        }
+        {
+          std::lock_guard<std::mutex> lock(call->mutex);
+          call->hedge_timer.reset();
+          if (call->done ||
+              call->attempts.size() >= hedging_.max_attempts) {
+            return;
+          }
+        }
+        if (!budget_.TryWithdraw()) {
+          spdlog::debug("Retry budget exhausted, not hedging {}", call->method);
+          return;
+        }
+        LaunchAttempt(call);
+        ScheduleHedge(call);
+      });
+}
+
+void ClientPool::OnAttemptResponse(
+    const std::shared_ptr<HedgedCall> &call, Attempt &attempt,
+    RawResponse response) {
+  std::optional<TimerWheel::TimerId> hedge_timer;
+  std::vector<Attempt *> losers;
+  {
+    std::lock_guard<std::mutex> lock(call->mutex);
+    attempt.finished = true;
+    call->outstanding--;
+    if (call->done) {
+      return;
+    }
+    call->done = true;
+    hedge_timer = std::exchange(call->hedge_timer, std::nullopt);
+    for (auto &other : call->attempts) {
+      if (!other->finished && other->request_id >= 0) {
+        losers.push_back(other.get());
+      }
+    }
+  }
+
+  latencies_.Record(std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - attempt.sent_at));
+  CancelHedge(hedge_timer);
+
+  // Abandon the slower attempts so their connections stop tracking them.
+  for (Attempt *loser : losers) {
+    if (clients_[loser->client_index]->CancelCall(loser->request_id)) {
+      std::lock_guard<std::mutex> lock(call->mutex);
+      loser->finished = true;
+      call->outstanding--;
+      loser->call.reset();
+    }
+  }
+
+  try {
+    call->promise.set_value(response.ToJson());
+  } catch (const nlohmann::json::exception &) {
+    call->promise.set_exception(std::current_exception());
+  }
+}
+
+void ClientPool::OnAttemptError(
+    const std::shared_ptr<HedgedCall> &call, Attempt &attempt,
+    std::exception_ptr error) {
+  bool retry = false;
+  std::optional<TimerWheel::TimerId> hedge_timer;
+  {
+    std::lock_guard<std::mutex> lock(call->mutex);
+    attempt.finished = true;
+    call->outstanding--;
+    if (call->done || call->outstanding > 0) {
+      // Another attempt may still succeed.
+      return;
+    }
+    retry = call->attempts.size() < hedging_.max_attempts &&
+            budget_.TryWithdraw();
+    if (!retry) {
+      call->done = true;
+      hedge_timer = std::exchange(call->hedge_timer, std::nullopt);
+    }
+  }
+
+  if (retry) {
+    spdlog::debug("Retrying {} after a failed attempt", call->method);
+    LaunchAttempt(call);
+    return;
+  }
+
+  CancelHedge(hedge_timer);
+  call->promise.set_exception(std::move(error));
+}
+
+void ClientPool::CancelHedge(std::optional<TimerWheel::TimerId> timer) {
+  if (!timer.has_value()) {
+    return;
+  }
+  std::shared_lock<std::shared_mutex> lifetime(lifetime_mutex_);
+  if (!stopping_) {
+    hedge_timers_->Cancel(*timer);
+  }
+}
+
+}  // namespace jsonrpc::client
@@ -0,0 +1,66 @@
+#include "jsonrpc/client/hedging.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace jsonrpc::client {
+
+RetryBudget::RetryBudget(double ratio, std::size_t reserve)
+    : deposit_(static_cast<std::int64_t>(std::max(ratio, 0.0) * kScale)),
+      capacity_(static_cast<std::int64_t>(std::max<std::size_t>(reserve, 1)) *
+                kScale),
+      balance_(capacity_) {
+}
+
+void RetryBudget::Deposit() {
+  std::int64_t balance = balance_.load(std::memory_order_relaxed);
+  while (balance < capacity_ &&
+         !balance_.compare_exchange_weak(
+             balance, std::min(balance + deposit_, capacity_),
+             std::memory_order_relaxed)) {
+  }
+}
+
+auto RetryBudget::TryWithdraw() -> bool {
+  std::int64_t balance = balance_.load(std::memory_order_relaxed);
+  while (balance >= kScale) {
+    if (balance_.compare_exchange_weak(
+            balance, balance - kScale, std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+LatencyTracker::LatencyTracker(double percentile, std::size_t window)
+    : percentile_(std::clamp(percentile, 0.0, 1.0)),
+      samples_(std::max(window, kRefreshInterval)) {
+}
+
+void LatencyTracker::Record(std::chrono::microseconds latency) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  samples_[next_] = latency.count();
+  next_ = (next_ + 1) % samples_.size();
+  count_++;
+  if (count_ % kRefreshInterval != 0) {
+    return;
+  }
+
+  std::vector<std::int64_t> window(
+      samples_.begin(),
+      samples_.begin() +
+          static_cast<std::ptrdiff_t>(std::min(count_, samples_.size())));
+  auto rank = static_cast<std::size_t>(
+      std::ceil(percentile_ * static_cast<double>(window.size())));
+  auto nth = window.begin() +
+             static_cast<std::ptrdiff_t>(std::max<std::size_t>(rank, 1) - 1);
+  std::nth_element(window.begin(), nth, window.end());
+  cached_ = std::chrono::microseconds(*nth);
+}
+
+auto LatencyTracker::Get() const -> std::optional<std::chrono::microseconds> {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return cached_;
+}
+
+}  // namespace jsonrpc::client
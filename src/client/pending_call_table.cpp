@@ -0,0 +1,173 @@
+#include "jsonrpc/client/pending_call_table.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+#include <spdlog/spdlog.h>
+
+namespace jsonrpc::client {
+
+namespace {
+
+auto SlotCount(std::size_t capacity) -> std::size_t {
+  return std::bit_ceil(std::max<std::size_t>(capacity, 1));
+}
+
+}  // namespace
+
+PendingCallTable::PendingCallTable(std::size_t capacity)
+    : slots_(std::make_unique<Slot[]>(SlotCount(capacity))),
+      mask_(SlotCount(capacity) - 1) {
+}
+
+void PendingCallTable::Add(int id, Promise promise) {
+  AddEntry(id, std::move(promise));
+}
+
+void PendingCallTable::Add(int id, RawPromise promise) {
+  AddEntry(id, std::move(promise));
+}
+
+void PendingCallTable::Add(int id, CallWaiter *waiter) {
+  AddEntry(id, waiter);
+}
+
+void PendingCallTable::AddEntry(int id, Entry entry) {
+  if (id >= 0) {
+    auto &slot = slots_[static_cast<std::size_t>(id) & mask_];
+    std::uint64_t expected = kFree;
+    if (slot.state.compare_exchange_strong(
+            expected, kBusy, std::memory_order_acquire)) {
+      slot.entry.emplace(std::move(entry));
+      size_.fetch_add(1, std::memory_order_relaxed);
+      slot.state.store(Tag(id), std::memory_order_release);
+      return;
+    }
+  }
+
+  spdlog::debug("Pending call slot for request ID {} is occupied", id);
+  std::lock_guard<std::mutex> lock(overflow_mutex_);
+  overflow_.emplace(id, std::move(entry));
+  overflow_size_.fetch_add(1, std::memory_order_release);
+  size_.fetch_add(1, std::memory_order_relaxed);
+}
+
+auto PendingCallTable::Complete(int id, RawResponse response) -> bool {
+  auto entry = Take(id);
+  if (!entry.has_value()) {
+    return false;
+  }
+  if (auto *promise = std::get_if<Promise>(&*entry)) {
+    try {
+      promise->set_value(response.ToJson());
+    } catch (const nlohmann::json::exception &) {
+      promise->set_exception(std::current_exception());
+    }
+  } else if (auto *raw_promise = std::get_if<RawPromise>(&*entry)) {
+    raw_promise->set_value(std::move(response));
+  } else {
+    std::get<CallWaiter *>(*entry)->OnResponse(std::move(response));
+  }
+  return true;
+}
+
+auto PendingCallTable::Fail(int id, std::exception_ptr error) -> bool {
+  auto entry = Take(id);
+  if (!entry.has_value()) {
+    return false;
+  }
+  FailEntry(*entry, std::move(error));
+  return true;
+}
+
+auto PendingCallTable::Remove(int id) -> bool {
+  return Take(id).has_value();
+}
+
+void PendingCallTable::FailAll(const std::string &message) {
+  auto error = std::make_exception_ptr(std::runtime_error(message));
+
+  for (std::size_t i = 0; i <= mask_; ++i) {
+    auto &slot = slots_[i];
+    std::uint64_t state = slot.state.load(std::memory_order_acquire);
+    if (state == kFree || state == kBusy) {
+      continue;
+    }
+    if (!slot.state.compare_exchange_strong(
+            state, kBusy, std::memory_order_acquire)) {
+      continue;
+    }
+    Entry entry = std::move(*slot.entry);
+    slot.entry.reset();
+    size_.fetch_sub(1, std::memory_order_relaxed);
+    slot.state.store(kFree, std::memory_order_release);
+    FailEntry(entry, error);
+  }
+
+  std::unordered_map<int, Entry> overflow;
+  {
+    std::lock_guard<std::mutex> lock(overflow_mutex_);
+    overflow.swap(overflow_);
+    overflow_size_.store(0, std::memory_order_relaxed);
+  }
+  for (auto &[id, entry] : overflow) {
+    FailEntry(entry, error);
+    size_.fetch_sub(1, std::memory_order_relaxed);
+  }
+}
+
+auto PendingCallTable::IsEmpty() const -> bool {
+  return Size() == 0;
+}
+
+auto PendingCallTable::Size() const -> std::size_t {
+  return size_.load(std::memory_order_relaxed);
+}
+
+auto PendingCallTable::Tag(int id) -> std::uint64_t {
+  return static_cast<std::uint64_t>(id) + 2;
+}
+
+auto PendingCallTable::Take(int id) -> std::optional<Entry> {
+  if (id >= 0) {
+    auto &slot = slots_[static_cast<std::size_t>(id) & mask_];
+    std::uint64_t expected = Tag(id);
+    if (slot.state.compare_exchange_strong(
+            expected, kBusy, std::memory_order_acquire)) {
+      Entry entry = std::move(*slot.entry);
+      slot.entry.reset();
+      size_.fetch_sub(1, std::memory_order_relaxed);
+      slot.state.store(kFree, std::memory_order_release);
+      return entry;
+    }
+  }
+
+  // Expired timers and late responses miss their slot routinely, and must
+  // not contend on the mutex while nothing has overflowed.
+  if (overflow_size_.load(std::memory_order_acquire) == 0) {
+    return std::nullopt;
+  }
+  std::lock_guard<std::mutex> lock(overflow_mutex_);
+  auto it = overflow_.find(id);
+  if (it == overflow_.end()) {
+    return std::nullopt;
+  }
+  Entry entry = std::move(it->second);
+  overflow_.erase(it);
+  overflow_size_.fetch_sub(1, std::memory_order_relaxed);
+  size_.fetch_sub(1, std::memory_order_relaxed);
+  return entry;
+}
+
+void PendingCallTable::FailEntry(Entry &entry, std::exception_ptr error) {
+  if (auto *promise = std::get_if<Promise>(&entry)) {
+    promise->set_exception(std::move(error));
+  } else if (auto *raw_promise = std::get_if<RawPromise>(&entry)) {
+    raw_promise->set_exception(std::move(error));
+  } else {
+    std::get<CallWaiter *>(entry)->OnError(std::move(error));
+  }
+}
+
+}  // namespace jsonrpc::client
@@ -0,0 +1,245 @@
+#include "jsonrpc/client/raw_response.hpp"
+
+#include <charconv>
+#include <stdexcept>
+
+namespace jsonrpc::client {
+
+namespace {
+
+auto IsWhitespace(char c) -> bool {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+auto SkipWhitespace(std::string_view text, std::size_t pos) -> std::size_t {
+  while (pos < text.size() && IsWhitespace(text[pos])) {
+    ++pos;
+  }
+  return pos;
+}
+
+// Returns the position just past the string starting at pos.
+auto SkipString(std::string_view text, std::size_t pos) -> std::size_t {
+  ++pos;
+  while (true) {
+    pos = text.find_first_of("\"\\", pos);
+    if (pos == std::string_view::npos) {
+      throw std::runtime_error("Unterminated string");
+    }
+    if (text[pos] == '"') {
+      return pos + 1;
+    }
+    pos += 2;
+  }
+}
+
+// Returns the position just past the value starting at pos. Nested values
+// are only bracket-matched, not validated; they are checked when parsed.
+auto SkipValue(std::string_view text, std::size_t pos) -> std::size_t {
+  if (pos >= text.size()) {
+    throw std::runtime_error("Unexpected end of message");
+  }
+  char first = text[pos];
+  if (first == '"') {
+    return SkipString(text, pos);
+  }
+  if (first == '{' || first == '[') {
+    int depth = 0;
+    while (true) {
+      pos = text.find_first_of("\"{}[]", pos);
+      if (pos == std::string_view::npos) {
+        throw std::runtime_error("Unterminated object or array");
+      }
+      char c = text[pos];
+      if (c == '"') {
+        pos = SkipString(text, pos);
+        continue;
+      }
+      depth += (c == '{' || c == '[') ? 1 : -1;
+      ++pos;
+      if (depth == 0) {
+        return pos;
+      }
+    }
+  }
+
+  auto end = text.find_first_of(",}] \t\r\n", pos);
+  if (end == pos) {
+    throw std::runtime_error("Expected a value");
+  }
+  return end == std::string_view::npos ? text.size() : end;
+}
+
+auto Slice(std::string_view text, RawResponse::Range range)
+    -> std::string_view {
+  return text.substr(range.first, range.second - range.first);
+}
+
+}  // namespace
+
+auto RawResponse::Scan(std::string message) -> RawResponse {
+  auto size = message.size();
+  return Scan(
+      std::make_shared<const std::string>(std::move(message)), {0, size});
+}
+
+auto RawResponse::Scan(
+    std::shared_ptr<const std::string> message, Range range) -> RawResponse {
+  std::string_view text(message->data(), range.second);
+
+  RawResponse response;
+  std::optional<Range> jsonrpc_range;
+  std::optional<Range> id_range;
+  std::optional<Range> result_range;
+  std::optional<Range> error_range;
+
+  std::size_t pos = SkipWhitespace(text, range.first);
+  if (pos >= text.size() || text[pos] != '{') {
+    throw std::runtime_error("Response is not an object");
+  }
+  pos = SkipWhitespace(text, pos + 1);
+  if (pos < text.size() && text[pos] == '}') {
+    throw std::runtime_error("Response is empty");
+  }
+
+  while (true) {
+    if (pos >= text.size() || text[pos] != '"') {
+      throw std::runtime_error("Expected a member name");
+    }
+    std::size_t key_end = SkipString(text, pos);
+    std::string_view key = text.substr(pos + 1, key_end - pos - 2);
+
+    pos = SkipWhitespace(text, key_end);
+    if (pos >= text.size() || text[pos] != ':') {
+      throw std::runtime_error("Expected ':' after member name");
+    }
+    pos = SkipWhitespace(text, pos + 1);
+    std::size_t value_begin = pos;
+    pos = SkipValue(text, pos);
+    Range value{value_begin, pos};
+
+    if (key == "jsonrpc") {
+      jsonrpc_range = value;
+    } else if (key == "id") {
+      id_range = value;
+    } else if (key == "result") {
+      result_range = value;
+    } else if (key == "error") {
+      error_range = value;
+    }
+
+    pos = SkipWhitespace(text, pos);
+    if (pos < text.size() && text[pos] == ',') {
+      pos = SkipWhitespace(text, pos + 1);
+      continue;
+    }
+    if (pos < text.size() && text[pos] == '}') {
+      ++pos;
+      break;
+    }
+    throw std::runtime_error("Expected ',' or '}' in response");
+  }
+  if (SkipWhitespace(text, pos) != text.size()) {
+    throw std::runtime_error("Unexpected data after response");
+  }
+
+  if (!jsonrpc_range || Slice(text, *jsonrpc_range) != R"("2.0")") {
+    throw std::runtime_error("Missing or invalid jsonrpc version");
+  }
+  if (!id_range) {
+    throw std::runtime_error("Response has no id");
+  }
+  if (result_range.has_value() == error_range.has_value()) {
+    throw std::runtime_error("Response needs exactly one of result and error");
+  }
+
+  if (error_range) {
+    auto error = nlohmann::json::parse(Slice(text, *error_range));
+    if (!error.is_object() || !error.contains("code") ||
+        !error["code"].is_number() || !error.contains("message") ||
+        !error["message"].is_string()) {
+      throw std::runtime_error("Malformed error object");
+    }
+    response.error_ = std::move(error);
+  }
+
+  auto id_text = Slice(text, *id_range);
+  int id = 0;
+  auto [end, ec] =
+      std::from_chars(id_text.data(), id_text.data() + id_text.size(), id);
+  if (ec == std::errc() && end == id_text.data() + id_text.size()) {
+    response.id_ = id;
+  }
+
+  response.message_ = std::move(message);
+  response.range_ = range;
+  response.id_range_ = *id_range;
+  response.value_range_ = error_range ? *error_range : *result_range;
+  return response;
+}
+
+auto RawResponse::SplitBatch(std::string_view message)
+    -> std::optional<std::vector<Range>> {
+  std::size_t pos = SkipWhitespace(message, 0);
+  if (pos >= message.size() || message[pos] != '[') {
+    return std::nullopt;
+  }
+
+  std::vector<Range> elements;
+  pos = SkipWhitespace(message, pos + 1);
+  if (pos < message.size() && message[pos] == ']') {
+    return elements;
+  }
+  while (true) {
+    std::size_t begin = pos;
+    pos = SkipValue(message, pos);
+    elements.emplace_back(begin, pos);
+
+    pos = SkipWhitespace(message, pos);
+    if (pos < message.size() && message[pos] == ',') {
+      pos = SkipWhitespace(message, pos + 1);
+      continue;
+    }
+    if (pos < message.size() && message[pos] == ']') {
+      return elements;
+    }
+    throw std::runtime_error("Expected ',' or ']' in batch response");
+  }
+}
+
+auto RawResponse::GetId() const -> std::optional<int> {
+  return id_;
+}
+
+auto RawResponse::GetRawId() const -> std::string_view {
+  return Slice(*message_, id_range_);
+}
+
+auto RawResponse::IsError() const -> bool {
+  return error_.has_value();
+}
+
+auto RawResponse::GetRawValue() const -> std::string_view {
+  return Slice(*message_, value_range_);
+}
+
+auto RawResponse::GetResult() const -> nlohmann::json {
+  if (error_) {
+    throw std::runtime_error("Response is an error");
+  }
+  return nlohmann::json::parse(GetRawValue());
+}
+
+auto RawResponse::GetError() const -> nlohmann::json {
+  return error_.value_or(nlohmann::json());
+}
+
+auto RawResponse::GetRaw() const -> std::string_view {
+  return Slice(*message_, range_);
+}
+
+auto RawResponse::ToJson() const -> nlohmann::json {
+  return nlohmann::json::parse(GetRaw());
+}
+
+}  // namespace jsonrpc::client
@@ -1,7 +1,28 @@
 #include "jsonrpc/client/request.hpp"
 
+#include <array>
+#include <charconv>
+
 namespace jsonrpc::client {
 
+PreparedMethod::PreparedMethod(std::string method) : name_(std::move(method)) {
+  AppendPrefix(prefix_, name_);
+}
+
+auto PreparedMethod::GetName() const -> const std::string & {
+  return name_;
+}
+
+auto PreparedMethod::GetPrefix() const -> const std::string & {
+  return prefix_;
+}
+
+void PreparedMethod::AppendPrefix(
+    std::string &buffer, const std::string &method) {
+  buffer += R"({"jsonrpc":"2.0","method":)";
+  buffer += nlohmann::json(method).dump();
+}
+
 Request::Request(
     std::string method, std::optional<nlohmann::json> params,
     bool is_notification, const std::function<int()> &id_generator)
@@ -14,6 +35,18 @@ Request::Request(
   }
 }
 
+Request::Request(
+    const PreparedMethod &method, std::optional<nlohmann::json> params,
+    bool is_notification, const std::function<int()> &id_generator)
+    : prepared_(&method),
+      params_(std::move(params)),
+      is_notification_(is_notification),
+      id_(0) {
+  if (!is_notification_) {
+    id_ = id_generator();
+  }
+}
+
 auto Request::RequiresResponse() const -> bool {
   return !is_notification_;
 }
@@ -23,16 +56,29 @@ auto Request::GetKey() const -> int {
 }
 
 auto Request::Dump() const -> std::string {
-  nlohmann::json json_request;
-  json_request["jsonrpc"] = "2.0";
-  json_request["method"] = method_;
+  std::string buffer;
+  DumpTo(buffer);
+  return buffer;
+}
+
+void Request::DumpTo(std::string &buffer) const {
+  if (prepared_ != nullptr) {
+    buffer += prepared_->GetPrefix();
+  } else {
+    PreparedMethod::AppendPrefix(buffer, method_);
+  }
   if (params_) {
-    json_request["params"] = *params_;
+    buffer += R"(,"params":)";
+    buffer += params_->dump();
   }
   if (!is_notification_) {
-    json_request["id"] = id_;
+    buffer += R"(,"id":)";
+    std::array<char, 16> digits{};
+    auto [end, ec] =
+        std::to_chars(digits.data(), digits.data() + digits.size(), id_);
+    buffer.append(digits.data(), end);
   }
-  return json_request.dump();
+  buffer += '}';
 }
 
 }  // namespace jsonrpc::client
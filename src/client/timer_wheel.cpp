@@ -0,0 +1,168 @@
+#include "jsonrpc/client/timer_wheel.hpp"
+
+#include <algorithm>
+
+#include <spdlog/spdlog.h>
+
+namespace jsonrpc::client {
+
+TimerWheel::TimerWheel(std::chrono::milliseconds tick, std::size_t num_slots)
+    : tick_(std::max(tick, std::chrono::milliseconds(1))),
+      slots_(std::max<std::size_t>(num_slots, 1), nullptr) {
+}
+
+TimerWheel::~TimerWheel() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  for (auto &timer : pool_) {
+    if (timer.ops != nullptr) {
+      timer.ops->destroy(timer.callback);
+    }
+  }
+}
+
+auto TimerWheel::ScheduleStored(
+    std::chrono::milliseconds delay, void *callback, const CallbackOps &ops)
+    -> TimerId {
+  auto ticks = static_cast<std::size_t>(std::max<std::int64_t>(
+      (delay.count() + tick_.count() - 1) / tick_.count(), 1));
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!thread_.joinable()) {
+    thread_ = std::thread(&TimerWheel::Run, this);
+  }
+
+  Timer *timer = free_list_;
+  if (timer != nullptr) {
+    free_list_ = timer->next;
+  } else {
+    timer = &pool_.emplace_back();
+    timer->index = static_cast<std::uint32_t>(pool_.size() - 1);
+  }
+  ops.move_to(callback, timer->callback);
+  timer->ops = &ops;
+
+  std::size_t slot = (cursor_ + ticks) % slots_.size();
+  timer->slot = slot;
+  timer->rounds = (ticks - 1) / slots_.size();
+  timer->pending = true;
+  timer->prev = nullptr;
+  timer->next = slots_[slot];
+  if (timer->next != nullptr) {
+    timer->next->prev = timer;
+  }
+  slots_[slot] = timer;
+
+  if (++size_ == 1) {
+    cv_.notify_one();
+  }
+  return (static_cast<TimerId>(timer->generation) << 32) | timer->index;
+}
+
+auto TimerWheel::Cancel(TimerId id) -> bool {
+  auto index = static_cast<std::uint32_t>(id);
+  auto generation = static_cast<std::uint32_t>(id >> 32);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (index >= pool_.size()) {
+    return false;
+  }
+  Timer &timer = pool_[index];
+  if (!timer.pending || timer.generation != generation) {
+    return false;
+  }
+  Unlink(timer);
+  Release(timer);
+  return true;
+}
+
+auto TimerWheel::Size() const -> std::size_t {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return size_;
+}
+
+void TimerWheel::Unlink(Timer &timer) {
+  if (timer.prev != nullptr) {
+    timer.prev->next = timer.next;
+  } else {
+    slots_[timer.slot] = timer.next;
+  }
+  if (timer.next != nullptr) {
+    timer.next->prev = timer.prev;
+  }
+  timer.pending = false;
+  size_--;
+}
+
+void TimerWheel::Release(Timer &timer) {
+  timer.ops->destroy(timer.callback);
+  timer.ops = nullptr;
+  timer.generation++;
+  timer.next = free_list_;
+  free_list_ = &timer;
+}
+
+auto TimerWheel::GetShared() -> std::shared_ptr<TimerWheel> {
+  static auto shared = std::make_shared<TimerWheel>();
+  return shared;
+}
+
+void TimerWheel::Run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  next_tick_ = std::chrono::steady_clock::now() + tick_;
+  while (!stopping_) {
+    if (size_ == 0) {
+      // Sleep until a timer arrives instead of ticking an empty wheel.
+      cv_.wait(lock, [this]() { return stopping_ || size_ > 0; });
+      next_tick_ = std::chrono::steady_clock::now() + tick_;
+      continue;
+    }
+    if (cv_.wait_until(lock, next_tick_, [this]() { return stopping_; })) {
+      break;
+    }
+    next_tick_ += tick_;
+    cursor_ = (cursor_ + 1) % slots_.size();
+
+    // Expired timers are unlinked, so Cancel() no longer finds them, but
+    // keep their node until the callback has run outside the lock.
+    Timer *expired = nullptr;
+    Timer *timer = slots_[cursor_];
+    while (timer != nullptr) {
+      Timer *next = timer->next;
+      if (timer->rounds > 0) {
+        timer->rounds--;
+      } else {
+        Unlink(*timer);
+        timer->next = expired;
+        expired = timer;
+      }
+      timer = next;
+    }
+    if (expired == nullptr) {
+      continue;
+    }
+
+    lock.unlock();
+    for (timer = expired; timer != nullptr; timer = timer->next) {
+      try {
+        timer->ops->invoke(timer->callback);
+      } catch (const std::exception &e) {
+        spdlog::error("Timer callback threw an exception: {}", e.what());
+      }
+    }
+    lock.lock();
+    while (expired != nullptr) {
+      Timer *next = expired->next;
+      Release(*expired);
+      expired = next;
+    }
+  }
+}
+
+}  // namespace jsonrpc::client
@@ -0,0 +1,9 @@
+#include "jsonrpc/executor/inline_executor.hpp"
+
+namespace jsonrpc::executor {
+
+void InlineExecutor::Execute(Task task) {
+  task();
+}
+
+}  // namespace jsonrpc::executor
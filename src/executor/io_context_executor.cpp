@@ -0,0 +1,13 @@
+#include "jsonrpc/executor/io_context_executor.hpp"
+
+namespace jsonrpc::executor {
+
+IoContextExecutor::IoContextExecutor(asio::io_context &io_context)
+    : io_context_(io_context) {
+}
+
+void IoContextExecutor::Execute(Task task) {
+  asio::post(io_context_, std::move(task));
+}
+
+}  // namespace jsonrpc::executor
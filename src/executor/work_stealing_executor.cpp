@@ -0,0 +1,256 @@
+#include "jsonrpc/executor/work_stealing_executor.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <spdlog/spdlog.h>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace jsonrpc::executor {
+
+namespace {
+
+// Identifies the pool and queue owned by the current thread, so tasks
+// submitted from inside a worker stay on that worker's deque.
+thread_local const WorkStealingExecutor *current_executor = nullptr;
+thread_local std::size_t current_index = 0;
+
+// Parses a kernel CPU list such as "0-3,8,10-11".
+auto ParseCpuList(const std::string &cpu_list) -> std::vector<int> {
+  std::vector<int> cpus;
+  std::istringstream input(cpu_list);
+  std::string range;
+  while (std::getline(input, range, ',')) {
+    if (range.empty()) {
+      continue;
+    }
+    auto dash_pos = range.find('-');
+    int first = std::stoi(range.substr(0, dash_pos));
+    int last = dash_pos == std::string::npos
+                   ? first
+                   : std::stoi(range.substr(dash_pos + 1));
+    for (int cpu = first; cpu <= last; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+auto ReadNumaNodeCpus(int node) -> std::vector<int> {
+  std::ifstream file(
+      "/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+  std::string cpu_list;
+  if (!file || !std::getline(file, cpu_list)) {
+    throw std::invalid_argument("Unknown NUMA node: " + std::to_string(node));
+  }
+  return ParseCpuList(cpu_list);
+}
+
+// Rejects CPU ids that cpu_set_t cannot represent.
+void CheckCpus(const std::vector<int> &cpus) {
+#ifdef __linux__
+  for (int cpu : cpus) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+      throw std::invalid_argument("Invalid CPU id: " + std::to_string(cpu));
+    }
+  }
+#endif
+}
+
+}  // namespace
+
+WorkStealingExecutor::WorkStealingExecutor(std::size_t num_threads)
+    : WorkStealingExecutor(WorkStealingOptions{.num_threads = num_threads}) {
+}
+
+WorkStealingExecutor::WorkStealingExecutor(const WorkStealingOptions &options)
+    : num_threads_(std::max<std::size_t>(options.num_threads, 1)) {
+  if (!options.cpu_set.empty()) {
+    affinity_cpus_ = options.cpu_set;
+    pin_individually_ = true;
+  } else if (options.numa_node.has_value()) {
+    affinity_cpus_ = ReadNumaNodeCpus(*options.numa_node);
+  }
+  CheckCpus(affinity_cpus_);
+
+  if (!options.lazy_start) {
+    EnsureStarted();
+  }
+}
+
+WorkStealingExecutor::~WorkStealingExecutor() {
+  if (!started_.load()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    stopping_.store(true);
+  }
+  sleep_cv_.notify_all();
+  for (auto &worker : workers_) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+}
+
+void WorkStealingExecutor::Execute(Task task) {
+  EnsureStarted();
+
+  std::size_t index = 0;
+  if (current_executor == this) {
+    index = current_index;
+  } else {
+    index = next_queue_.fetch_add(1, std::memory_order_relaxed) %
+            queues_.size();
+  }
+
+  // Count the task before it becomes visible so that pending_ never drops
+  // below the number of tasks actually sitting in the queues.
+  pending_.fetch_add(1);
+  {
+    auto &queue = *queues_[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.tasks.push_back(std::move(task));
+  }
+  NotifyWorker();
+}
+
+auto WorkStealingExecutor::GetThreadCount() const -> std::size_t {
+  return num_threads_;
+}
+
+auto WorkStealingExecutor::IsStarted() const -> bool {
+  return started_.load();
+}
+
+auto WorkStealingExecutor::GetShared()
+    -> std::shared_ptr<WorkStealingExecutor> {
+  static auto shared = std::make_shared<WorkStealingExecutor>();
+  return shared;
+}
+
+void WorkStealingExecutor::EnsureStarted() {
+  if (started_.load(std::memory_order_acquire)) {
+    return;
+  }
+  std::call_once(start_flag_, [this]() {
+    queues_.reserve(num_threads_);
+    for (std::size_t i = 0; i < num_threads_; ++i) {
+      queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+    workers_.reserve(num_threads_);
+    for (std::size_t i = 0; i < num_threads_; ++i) {
+      workers_.emplace_back(&WorkStealingExecutor::WorkerLoop, this, i);
+    }
+    started_.store(true, std::memory_order_release);
+    spdlog::info("WorkStealingExecutor started with {} threads", num_threads_);
+  });
+}
+
+void WorkStealingExecutor::WorkerLoop(std::size_t index) {
+  current_executor = this;
+  current_index = index;
+  ApplyAffinity(index);
+
+  while (true) {
+    std::optional<Task> task = TryPop(index);
+    if (!task.has_value()) {
+      task = TrySteal(index);
+    }
+    if (task.has_value()) {
+      try {
+        (*task)();
+      } catch (const std::exception &e) {
+        spdlog::error("Unhandled exception in executor task: {}", e.what());
+      }
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    sleeping_.fetch_add(1);
+    sleep_cv_.wait(lock, [this]() {
+      return stopping_.load() || pending_.load() > 0;
+    });
+    sleeping_.fetch_sub(1);
+    if (stopping_.load() && pending_.load() == 0) {
+      return;
+    }
+  }
+}
+
+void WorkStealingExecutor::ApplyAffinity(std::size_t index) const {
+  if (affinity_cpus_.empty()) {
+    return;
+  }
+#ifdef __linux__
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  if (pin_individually_) {
+    CPU_SET(affinity_cpus_[index % affinity_cpus_.size()], &cpu_set);
+  } else {
+    for (int cpu : affinity_cpus_) {
+      CPU_SET(cpu, &cpu_set);
+    }
+  }
+  int result =
+      pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+  if (result != 0) {
+    spdlog::warn(
+        "WorkStealingExecutor failed to set affinity for worker {}: {}", index,
+        strerror(result));
+  }
+#else
+  spdlog::warn(
+      "WorkStealingExecutor CPU pinning is not supported on this platform");
+#endif
+}
+
+auto WorkStealingExecutor::TryPop(std::size_t index) -> std::optional<Task> {
+  auto &queue = *queues_[index];
+  std::lock_guard<std::mutex> lock(queue.mutex);
+  if (queue.tasks.empty()) {
+    return std::nullopt;
+  }
+  Task task = std::move(queue.tasks.back());
+  queue.tasks.pop_back();
+  pending_.fetch_sub(1);
+  return task;
+}
+
+auto WorkStealingExecutor::TrySteal(std::size_t index) -> std::optional<Task> {
+  for (std::size_t offset = 1; offset < queues_.size(); ++offset) {
+    auto &queue = *queues_[(index + offset) % queues_.size()];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+      continue;
+    }
+    Task task = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+    pending_.fetch_sub(1);
+    return task;
+  }
+  return std::nullopt;
+}
+
+void WorkStealingExecutor::NotifyWorker() {
+  // Workers register as sleeping before re-checking pending_, so a submitter
+  // that sees no sleepers can skip the lock: the worker will see the task.
+  if (sleeping_.load() == 0) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+  }
+  sleep_cv_.notify_one();
+}
+
+}  // namespace jsonrpc::executor
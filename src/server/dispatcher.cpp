@@ -1,22 +1,34 @@
 #include "jsonrpc/server/dispatcher.hpp"
 
+#include <stdexcept>
+
 #include <spdlog/spdlog.h>
 
+#include "jsonrpc/executor/inline_executor.hpp"
+#include "jsonrpc/executor/work_stealing_executor.hpp"
+
 namespace jsonrpc::server {
 
-Dispatcher::Dispatcher(bool enable_multithreading, size_t num_threads)
-    : enable_multithreading_(enable_multithreading),
-      thread_pool_(enable_multithreading ? num_threads : 0) {
-  // Optionally log or perform additional setup if needed
-  if (enable_multithreading_) {
+Dispatcher::Dispatcher(bool enable_multithreading, size_t num_threads) {
+  if (enable_multithreading) {
+    executor_ = std::make_shared<executor::WorkStealingExecutor>(num_threads);
     spdlog::info(
         "Dispatcher initialized with multithreading support using {} threads",
         num_threads);
   } else {
+    executor_ = std::make_shared<executor::InlineExecutor>();
     spdlog::info("Dispatcher initialized without multithreading support");
   }
 }
 
+Dispatcher::Dispatcher(std::shared_ptr<executor::Executor> executor)
+    : executor_(std::move(executor)) {
+  if (!executor_) {
+    throw std::invalid_argument("Dispatcher requires a non-null executor");
+  }
+  spdlog::info("Dispatcher initialized with external executor");
+}
+
 auto Dispatcher::DispatchRequest(const std::string &request_str)
     -> std::optional<std::string> {
   auto request_json = ParseAndValidateJson(request_str);
@@ -24,11 +36,20 @@ auto Dispatcher::DispatchRequest(const std::string &request_str)
     return Response::CreateLibError(LibErrorKind::kParseError).ToStr();
   }
 
-  if (request_json->is_array()) {
-    return DispatchBatchRequest(*request_json);
+  return DispatchRequest(*request_json);
+}
+
+auto Dispatcher::DispatchRequest(const nlohmann::json &request_json)
+    -> std::optional<std::string> {
+  if (request_json.is_discarded()) {
+    return Response::CreateLibError(LibErrorKind::kParseError).ToStr();
+  }
+
+  if (request_json.is_array()) {
+    return DispatchBatchRequest(request_json);
   }
 
-  return DispatchSingleRequest(*request_json);
+  return DispatchSingleRequest(request_json);
 }
 
 auto Dispatcher::ParseAndValidateJson(const std::string &request_str)
@@ -92,20 +113,13 @@ auto Dispatcher::DispatchBatchRequest(const nlohmann::json &request_json)
 auto Dispatcher::DispatchBatchRequestInner(const nlohmann::json &request_json)
     -> std::vector<nlohmann::json> {
   std::vector<std::future<std::optional<nlohmann::json>>> futures;
+  futures.reserve(request_json.size());
 
   for (const auto &element : request_json) {
-    if (enable_multithreading_) {
-      futures.emplace_back(thread_pool_.submit_task(
-          [this, element]() -> std::optional<nlohmann::json> {
-            return DispatchSingleRequestInner(element);
-          }));
-    } else {
-      futures.emplace_back(std::async(
-          std::launch::deferred,
-          [this, element]() -> std::optional<nlohmann::json> {
-            return DispatchSingleRequestInner(element);
-          }));
-    }
+    futures.emplace_back(executor_->Submit(
+        [this, element]() -> std::optional<nlohmann::json> {
+          return DispatchSingleRequestInner(element);
+        }));
   }
 
   std::vector<nlohmann::json> responses;
@@ -2,14 +2,27 @@
 
 #include <spdlog/spdlog.h>
 
+#include "jsonrpc/executor/work_stealing_executor.hpp"
+#include "jsonrpc/server/response.hpp"
+#include "jsonrpc/transport/json_receiver.hpp"
+
 namespace jsonrpc::server {
 
 Server::Server(std::unique_ptr<transport::Transport> transport)
     : transport_(std::move(transport)) {
-  dispatcher_ = std::make_unique<Dispatcher>();
+  dispatcher_ = std::make_unique<Dispatcher>(
+      executor::WorkStealingExecutor::GetShared());
   spdlog::info("Server initialized with transport");
 }
 
+Server::Server(
+    std::unique_ptr<transport::Transport> transport,
+    std::shared_ptr<executor::Executor> executor)
+    : transport_(std::move(transport)) {
+  dispatcher_ = std::make_unique<Dispatcher>(std::move(executor));
+  spdlog::info("Server initialized with transport and executor");
+}
+
 void Server::Start() {
   spdlog::info("Server starting");
   running_.store(true);
@@ -35,12 +48,39 @@ void Server::Listen() {
     return;
   }
 
+  // Transports that can parse while receiving hand over JSON instead.
+  auto *json_receiver =
+      dynamic_cast<transport::JsonReceiver *>(transport_.get());
+  if (json_receiver != nullptr && !json_receiver->IsStreaming()) {
+    json_receiver = nullptr;
+  }
+
   while (IsRunning()) {
-    std::string request = transport_->ReceiveMessage();
-    if (request.empty()) {
+    std::string request;
+    nlohmann::json request_json;
+    try {
+      if (json_receiver != nullptr) {
+        request_json = json_receiver->ReceiveJson();
+      } else {
+        request = transport_->ReceiveMessage();
+      }
+    } catch (const transport::MessageTooLargeError &e) {
+      // The message was skipped; its ID is unknown, as for a parse error.
+      spdlog::warn("Rejecting request: {}", e.what());
+      transport_->SendMessage(
+          Response::CreateLibError(LibErrorKind::kInvalidRequest).ToStr());
+      continue;
+    } catch (const std::exception &e) {
+      spdlog::error("Server stopping on transport error: {}", e.what());
+      running_.store(false);
+      break;
+    }
+    if (json_receiver == nullptr && request.empty()) {
       continue;
     }
-    std::optional<std::string> response = dispatcher_->DispatchRequest(request);
+    std::optional<std::string> response =
+        json_receiver != nullptr ? dispatcher_->DispatchRequest(request_json)
+                                 : dispatcher_->DispatchRequest(request);
     if (response.has_value()) {
       transport_->SendMessage(response.value());
     }
@@ -0,0 +1,155 @@
+#include "jsonrpc/transport/capture_transport.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <limits>
+#include <stdexcept>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+namespace jsonrpc::transport {
+
+namespace {
+
+template <typename T>
+void Put(std::array<char, 16> &header, std::size_t offset, T value) {
+  std::memcpy(header.data() + offset, &value, sizeof(value));
+}
+
+/// Writes all of the buffers, retrying after short writes and EINTR.
+auto WriteAll(int fd, iovec *iovecs, int count) -> bool {
+  while (count > 0) {
+    ssize_t written = ::writev(fd, iovecs, count);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    auto remaining = static_cast<std::size_t>(written);
+    while (count > 0 && remaining >= iovecs->iov_len) {
+      remaining -= iovecs->iov_len;
+      ++iovecs;
+      --count;
+    }
+    if (count > 0) {
+      iovecs->iov_base = static_cast<char *>(iovecs->iov_base) + remaining;
+      iovecs->iov_len -= remaining;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+CaptureTransport::CaptureTransport(
+    std::unique_ptr<Transport> transport, const std::string &path,
+    CaptureFraming framing)
+    : transport_(std::move(transport)), path_(path) {
+  fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+  if (fd_ < 0) {
+    throw std::runtime_error(
+        "Failed to open capture file " + path + ": " + std::strerror(errno));
+  }
+  try {
+    PrepareFile(framing);
+  } catch (...) {
+    ::close(fd_);
+    throw;
+  }
+  spdlog::info("Capturing transport traffic to {}", path);
+}
+
+CaptureTransport::~CaptureTransport() {
+  ::close(fd_);
+}
+
+void CaptureTransport::SendMessage(const std::string &message) {
+  Record(CaptureDirection::kSent, message);
+  transport_->SendMessage(message);
+}
+
+void CaptureTransport::SendMessage(std::string &&message) {
+  Record(CaptureDirection::kSent, message);
+  transport_->SendMessage(std::move(message));
+}
+
+auto CaptureTransport::ReceiveMessage() -> std::string {
+  std::string message = transport_->ReceiveMessage();
+  Record(CaptureDirection::kReceived, message);
+  return message;
+}
+
+void CaptureTransport::Close() {
+  transport_->Close();
+}
+
+void CaptureTransport::PrepareFile(CaptureFraming framing) {
+  namespace format = capture_format;
+
+  // The lock keeps two processes from both writing a header to a new file.
+  if (::flock(fd_, LOCK_EX) != 0) {
+    throw std::runtime_error("Failed to lock capture file " + path_);
+  }
+  struct stat info {};
+  bool ok = ::fstat(fd_, &info) == 0;
+  if (ok && info.st_size == 0) {
+    std::array<char, format::kFileHeaderSize> header{};
+    std::memcpy(header.data(), format::kMagic.data(), format::kMagic.size());
+    Put(header, format::kVersionOffset, format::kVersion);
+    Put(header, format::kFramingOffset, framing);
+    iovec iov{header.data(), header.size()};
+    ok = WriteAll(fd_, &iov, 1);
+  } else if (ok) {
+    std::array<char, format::kFileHeaderSize> header{};
+    int reader = ::open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+    ok = reader >= 0 &&
+         ::pread(reader, header.data(), header.size(), 0) ==
+             static_cast<ssize_t>(header.size()) &&
+         std::string_view(header.data(), format::kMagic.size()) ==
+             format::kMagic;
+    if (reader >= 0) {
+      ::close(reader);
+    }
+  }
+  ::flock(fd_, LOCK_UN);
+  if (!ok) {
+    throw std::runtime_error(path_ + " is not a capture file");
+  }
+}
+
+void CaptureTransport::Record(
+    CaptureDirection direction, const std::string &message) {
+  namespace format = capture_format;
+
+  if (message.size() > std::numeric_limits<std::uint32_t>::max()) {
+    spdlog::error(
+        "Message of {} bytes is too large to capture", message.size());
+    return;
+  }
+  auto timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                       .count();
+  std::array<char, format::kRecordHeaderSize> header{};
+  Put(header, format::kTimestampOffset, static_cast<std::int64_t>(timestamp));
+  Put(header, format::kSizeOffset, static_cast<std::uint32_t>(message.size()));
+  Put(header, format::kDirectionOffset, direction);
+
+  std::array<iovec, 2> iovecs{
+      iovec{header.data(), header.size()},
+      iovec{const_cast<char *>(message.data()), message.size()}};
+  if (!WriteAll(fd_, iovecs.data(), static_cast<int>(iovecs.size()))) {
+    spdlog::error(
+        "Failed to write capture record to {}: {}", path_,
+        std::strerror(errno));
+  }
+}
+
+}  // namespace jsonrpc::transport
@@ -0,0 +1,130 @@
+#include "jsonrpc/transport/delimiter_search.hpp"
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define JSONRPC_DELIMITER_SEARCH_X86 1
+#include <immintrin.h>
+#endif
+
+namespace jsonrpc::transport {
+
+namespace {
+
+auto FindScalar(
+    const char *data, std::size_t size, std::string_view delimiter)
+    -> std::size_t {
+  return std::string_view(data, size).find(delimiter);
+}
+
+#ifdef JSONRPC_DELIMITER_SEARCH_X86
+
+/// Checks the candidates in a mask of positions whose first and last bytes
+/// match. Returns the offset of the first full match, or npos.
+auto CheckCandidates(
+    const char *data, std::uint32_t mask, std::string_view delimiter)
+    -> std::size_t {
+  while (mask != 0) {
+    auto offset = static_cast<std::size_t>(std::countr_zero(mask));
+    // The first and last bytes already match.
+    if (delimiter.size() <= 2 ||
+        std::memcmp(
+            data + offset + 1, delimiter.data() + 1, delimiter.size() - 2) ==
+            0) {
+      return offset;
+    }
+    mask &= mask - 1;
+  }
+  return std::string_view::npos;
+}
+
+/// Searches the bytes that the block loop left over.
+auto FindTail(
+    const char *data, std::size_t size, std::size_t offset,
+    std::string_view delimiter) -> std::size_t {
+  std::size_t match = FindScalar(data + offset, size - offset, delimiter);
+  return match == std::string_view::npos ? match : offset + match;
+}
+
+// Both loops compare each block with the delimiter's first byte and the
+// block delimiter.size() - 1 bytes further on with its last byte; positions
+// where both match are candidates.
+
+auto FindSse2(const char *data, std::size_t size, std::string_view delimiter)
+    -> std::size_t {
+  constexpr std::size_t kBlockSize = 16;
+  const __m128i first = _mm_set1_epi8(delimiter.front());
+  const __m128i last = _mm_set1_epi8(delimiter.back());
+  std::size_t last_offset = delimiter.size() - 1;
+
+  std::size_t offset = 0;
+  for (; offset + last_offset + kBlockSize <= size; offset += kBlockSize) {
+    __m128i front_block =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + offset));
+    __m128i back_block = _mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(data + offset + last_offset));
+    __m128i matches = _mm_and_si128(
+        _mm_cmpeq_epi8(front_block, first), _mm_cmpeq_epi8(back_block, last));
+    auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(matches));
+    std::size_t match = CheckCandidates(data + offset, mask, delimiter);
+    if (match != std::string_view::npos) {
+      return offset + match;
+    }
+  }
+  return FindTail(data, size, offset, delimiter);
+}
+
+__attribute__((target("avx2"))) auto FindAvx2(
+    const char *data, std::size_t size, std::string_view delimiter)
+    -> std::size_t {
+  constexpr std::size_t kBlockSize = 32;
+  const __m256i first = _mm256_set1_epi8(delimiter.front());
+  const __m256i last = _mm256_set1_epi8(delimiter.back());
+  std::size_t last_offset = delimiter.size() - 1;
+
+  std::size_t offset = 0;
+  for (; offset + last_offset + kBlockSize <= size; offset += kBlockSize) {
+    __m256i front_block =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + offset));
+    __m256i back_block = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i *>(data + offset + last_offset));
+    __m256i matches = _mm256_and_si256(
+        _mm256_cmpeq_epi8(front_block, first),
+        _mm256_cmpeq_epi8(back_block, last));
+    auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(matches));
+    std::size_t match = CheckCandidates(data + offset, mask, delimiter);
+    if (match != std::string_view::npos) {
+      return offset + match;
+    }
+  }
+  return FindTail(data, size, offset, delimiter);
+}
+
+auto HasAvx2() -> bool {
+  static const bool has_avx2 = __builtin_cpu_supports("avx2") != 0;
+  return has_avx2;
+}
+
+#endif
+
+}  // namespace
+
+auto FindDelimiter(
+    const char *data, std::size_t size, std::string_view delimiter)
+    -> std::size_t {
+  if (delimiter.empty() || size < delimiter.size()) {
+    return delimiter.empty() ? 0 : std::string_view::npos;
+  }
+#ifdef JSONRPC_DELIMITER_SEARCH_X86
+  if (HasAvx2()) {
+    return FindAvx2(data, size, delimiter);
+  }
+  return FindSse2(data, size, delimiter);
+#else
+  return FindScalar(data, size, delimiter);
+#endif
+}
+
+}  // namespace jsonrpc::transport
@@ -0,0 +1,101 @@
+#include "jsonrpc/transport/fd_stream.hpp"
+
+#include <array>
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace jsonrpc::transport {
+
+FdStream::FdStream(int fd, bool interruptible) : fd_(fd) {
+  if (!interruptible) {
+    return;
+  }
+  std::array<int, 2> fds{};
+  if (::pipe(fds.data()) != 0) {
+    throw std::runtime_error("Failed to create interrupt pipe");
+  }
+  for (int pipe_fd : fds) {
+    ::fcntl(pipe_fd, F_SETFD, FD_CLOEXEC);
+  }
+  interrupt_read_fd_ = fds[0];
+  interrupt_write_fd_ = fds[1];
+}
+
+FdStream::~FdStream() {
+  if (interrupt_read_fd_ >= 0) {
+    ::close(interrupt_read_fd_);
+    ::close(interrupt_write_fd_);
+  }
+}
+
+void FdStream::Interrupt() {
+  if (interrupt_write_fd_ < 0) {
+    return;
+  }
+  // The byte is never read, so the pipe stays readable and every later wait
+  // ends at once.
+  char byte = 0;
+  while (::write(interrupt_write_fd_, &byte, 1) < 0 && errno == EINTR) {
+  }
+}
+
+auto FdStream::WaitReadable(asio::error_code &ec) -> bool {
+  std::array<pollfd, 2> fds{{
+      {fd_, POLLIN, 0},
+      {interrupt_read_fd_, POLLIN, 0},
+  }};
+  while (::poll(fds.data(), fds.size(), -1) < 0) {
+    if (errno != EINTR) {
+      ec = asio::error_code(errno, asio::error::get_system_category());
+      return false;
+    }
+  }
+  if (fds[1].revents != 0) {
+    ec = asio::error::operation_aborted;
+    return false;
+  }
+  return true;
+}
+
+auto FdStream::ReadSome(void *data, std::size_t size, asio::error_code &ec)
+    -> std::size_t {
+  if (interrupt_read_fd_ >= 0 && !WaitReadable(ec)) {
+    return 0;
+  }
+  while (true) {
+    ssize_t result = ::read(fd_, data, size);
+    if (result > 0) {
+      ec = {};
+      return static_cast<std::size_t>(result);
+    }
+    if (result == 0) {
+      ec = asio::error::eof;
+      return 0;
+    }
+    if (errno != EINTR) {
+      ec = asio::error_code(errno, asio::error::get_system_category());
+      return 0;
+    }
+  }
+}
+
+auto FdStream::WriteSome(
+    const iovec *iovecs, std::size_t count, asio::error_code &ec)
+    -> std::size_t {
+  while (true) {
+    ssize_t result = ::writev(fd_, iovecs, static_cast<int>(count));
+    if (result >= 0) {
+      ec = {};
+      return static_cast<std::size_t>(result);
+    }
+    if (errno != EINTR) {
+      ec = asio::error_code(errno, asio::error::get_system_category());
+      return 0;
+    }
+  }
+}
+
+}  // namespace jsonrpc::transport
@@ -8,66 +8,71 @@
 namespace jsonrpc::transport {
 
 FramedPipeTransport::FramedPipeTransport(
-    const std::string &socket_path, bool is_server)
-    : PipeTransport(socket_path, is_server) {
+    const std::string &socket_path, bool is_server,
+    const SocketOptions &options, const FramedOptions &framed_options)
+    : PipeTransport(socket_path, is_server, options),
+      FramedTransport(framed_options) {
+  spdlog::info(
+      "FramedPipeTransport initialized with socket path: {}", socket_path);
+}
+
+FramedPipeTransport::FramedPipeTransport(
+    asio::io_context &io_context, const std::string &socket_path,
+    bool is_server, const SocketOptions &options,
+    const FramedOptions &framed_options)
+    : PipeTransport(io_context, socket_path, is_server, options),
+      FramedTransport(framed_options) {
   spdlog::info(
       "FramedPipeTransport initialized with socket path: {}", socket_path);
 }
 
 void FramedPipeTransport::SendMessage(const std::string &message) {
   try {
-    asio::streambuf message_buf;
-    std::ostream message_stream(&message_buf);
-    FrameMessage(message_stream, message);
-
-    asio::error_code ec;
-    std::size_t bytes_written =
-        asio::write(GetSocket(), message_buf.data(), ec);
-
-    if (ec) {
-      throw std::runtime_error("Error sending message: " + ec.message());
-    }
-
+    GetWriteQueue().Send(MakeFrameHeader(message.size()).View(), message);
     spdlog::info(
-        "FramedPipeTransport sent message with {} bytes", bytes_written);
+        "FramedPipeTransport sent message with {} bytes", message.size());
   } catch (const std::exception &e) {
     spdlog::error("FramedPipeTransport failed to send message: {}", e.what());
     throw;
   }
 }
 
-auto FramedPipeTransport::ReceiveMessage() -> std::string {
-  asio::streambuf buffer;
-  asio::error_code ec;
-
-  // Read headers until \r\n\r\n delimiter
-  asio::read_until(GetSocket(), buffer, kHeaderDelimiter, ec);
-  if (ec) {
-    throw std::runtime_error("Failed to read message headers: " + ec.message());
+void FramedPipeTransport::SendMessage(std::string &&message) {
+  try {
+    std::size_t size = message.size();
+    GetWriteQueue().Send(MakeFrameHeader(size).View(), std::move(message));
+    spdlog::info("FramedPipeTransport sent message with {} bytes", size);
+  } catch (const std::exception &e) {
+    spdlog::error("FramedPipeTransport failed to send message: {}", e.what());
+    throw;
   }
+}
 
-  std::istream header_stream(&buffer);
+auto FramedPipeTransport::ReceiveMessage() -> std::string {
+  return WithStream([this](auto &stream) {
+    return ReceiveFramedMessage(stream, GetReadBuffer());
+  });
+}
 
-  // Extract content length from the headers
-  int content_length = ReadContentLengthFromStream(header_stream);
+auto FramedPipeTransport::IsStreaming() const -> bool {
+  return GetFramedOptions().stream_content;
+}
 
-  // Calculate how much more content we need to read
-  std::size_t remaining_content_length = content_length - buffer.size();
+auto FramedPipeTransport::ReceiveJson() -> nlohmann::json {
+  return WithStream([this](auto &stream) {
+    return ReceiveFramedJson(stream, GetReadBuffer());
+  });
+}
 
-  // Read any remaining content directly into the buffer
-  if (remaining_content_length > 0) {
-    asio::read(GetSocket(), buffer.prepare(remaining_content_length), ec);
-    if (ec && ec != asio::error::eof) {
-      throw std::runtime_error(
-          "Failed to read message content: " + ec.message());
-    }
-    buffer.commit(remaining_content_length);
-  }
+void FramedPipeTransport::DoAsyncSendMessage(
+    std::string message, SendHandler handler) {
+  FrameHeader header = MakeFrameHeader(message.size());
+  GetWriteQueue().AsyncSend(
+      header.View(), std::move(message), {}, std::move(handler));
+}
 
-  // Convert the entire buffer to a string
-  std::string content(
-      asio::buffers_begin(buffer.data()), asio::buffers_end(buffer.data()));
-  return content;
+void FramedPipeTransport::DoAsyncReceiveMessage(ReceiveHandler handler) {
+  AsyncReceiveFramedMessage(GetSocket(), GetReadBuffer(), std::move(handler));
 }
 
 }  // namespace jsonrpc::transport
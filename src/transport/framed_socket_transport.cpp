@@ -9,8 +9,21 @@
 namespace jsonrpc::transport {
 
 FramedSocketTransport::FramedSocketTransport(
-    const std::string &host, uint16_t port, bool is_server)
-    : SocketTransport(host, port, is_server), FramedTransport() {
+    const std::string &host, uint16_t port, bool is_server,
+    const SocketOptions &options, const FramedOptions &framed_options)
+    : SocketTransport(host, port, is_server, options),
+      FramedTransport(framed_options) {
+  spdlog::info(
+      "FramedSocketTransport initialized with host: {} and port: {}", host,
+      port);
+}
+
+FramedSocketTransport::FramedSocketTransport(
+    asio::io_context &io_context, const std::string &host, uint16_t port,
+    bool is_server, const SocketOptions &options,
+    const FramedOptions &framed_options)
+    : SocketTransport(io_context, host, port, is_server, options),
+      FramedTransport(framed_options) {
   spdlog::info(
       "FramedSocketTransport initialized with host: {} and port: {}", host,
       port);
@@ -18,58 +31,51 @@ FramedSocketTransport::FramedSocketTransport(
 
 void FramedSocketTransport::SendMessage(const std::string &message) {
   try {
-    asio::streambuf message_buf;
-    std::ostream message_stream(&message_buf);
-    FrameMessage(message_stream, message);
-
-    asio::error_code ec;
-    std::size_t bytes_written =
-        asio::write(GetSocket(), message_buf.data(), ec);
-
-    if (ec) {
-      throw std::runtime_error("Error sending message: " + ec.message());
-    }
-
+    GetWriteQueue().Send(MakeFrameHeader(message.size()).View(), message);
     spdlog::info(
-        "FramedSocketTransport sent message with {} bytes", bytes_written);
+        "FramedSocketTransport sent message with {} bytes", message.size());
   } catch (const std::exception &e) {
     spdlog::error("FramedSocketTransport failed to send message: {}", e.what());
     throw;
   }
 }
 
-auto FramedSocketTransport::ReceiveMessage() -> std::string {
-  asio::streambuf buffer;
-  asio::error_code ec;
-
-  // Read headers until \r\n\r\n delimiter
-  asio::read_until(GetSocket(), buffer, kHeaderDelimiter, ec);
-  if (ec) {
-    throw std::runtime_error("Failed to read message headers: " + ec.message());
+void FramedSocketTransport::SendMessage(std::string &&message) {
+  try {
+    std::size_t size = message.size();
+    GetWriteQueue().Send(MakeFrameHeader(size).View(), std::move(message));
+    spdlog::info("FramedSocketTransport sent message with {} bytes", size);
+  } catch (const std::exception &e) {
+    spdlog::error("FramedSocketTransport failed to send message: {}", e.what());
+    throw;
   }
+}
 
-  std::istream header_stream(&buffer);
+auto FramedSocketTransport::ReceiveMessage() -> std::string {
+  return WithStream([this](auto &stream) {
+    return ReceiveFramedMessage(stream, GetReadBuffer());
+  });
+}
 
-  // Extract content length from the headers
-  int content_length = ReadContentLengthFromStream(header_stream);
+auto FramedSocketTransport::IsStreaming() const -> bool {
+  return GetFramedOptions().stream_content;
+}
 
-  // Calculate how much more content we need to read
-  std::size_t remaining_content_length = content_length - buffer.size();
+auto FramedSocketTransport::ReceiveJson() -> nlohmann::json {
+  return WithStream([this](auto &stream) {
+    return ReceiveFramedJson(stream, GetReadBuffer());
+  });
+}
 
-  // Read any remaining content directly into the buffer
-  if (remaining_content_length > 0) {
-    asio::read(GetSocket(), buffer.prepare(remaining_content_length), ec);
-    if (ec && ec != asio::error::eof) {
-      throw std::runtime_error(
-          "Failed to read message content: " + ec.message());
-    }
-    buffer.commit(remaining_content_length);
-  }
+void FramedSocketTransport::DoAsyncSendMessage(
+    std::string message, SendHandler handler) {
+  FrameHeader header = MakeFrameHeader(message.size());
+  GetWriteQueue().AsyncSend(
+      header.View(), std::move(message), {}, std::move(handler));
+}
 
-  // Convert the entire buffer to a string
-  std::string content(
-      asio::buffers_begin(buffer.data()), asio::buffers_end(buffer.data()));
-  return content;
+void FramedSocketTransport::DoAsyncReceiveMessage(ReceiveHandler handler) {
+  AsyncReceiveFramedMessage(GetSocket(), GetReadBuffer(), std::move(handler));
 }
 
 }  // namespace jsonrpc::transport
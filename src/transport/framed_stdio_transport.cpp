@@ -1,21 +1,41 @@
 #include "jsonrpc/transport/framed_stdio_transport.hpp"
 
-#include <iostream>
+#include <utility>
 
 #include <spdlog/spdlog.h>
 
 namespace jsonrpc::transport {
 
+FramedStdioTransport::FramedStdioTransport(
+    StdioOptions options, FramedOptions framed_options)
+    : StdioTransport(options), FramedTransport(framed_options) {
+}
+
 void FramedStdioTransport::SendMessage(const std::string &message) {
   spdlog::debug("FramedStdioTransport sending message: {}", message);
-  FrameMessage(std::cout, message);
-  std::cout << std::flush;
+  Write(MakeFrameHeader(message.size()).View(), message, {});
+}
+
+void FramedStdioTransport::SendMessage(std::string &&message) {
+  spdlog::debug("FramedStdioTransport sending message: {}", message);
+  FrameHeader header = MakeFrameHeader(message.size());
+  Write(header.View(), std::move(message), {});
 }
 
 auto FramedStdioTransport::ReceiveMessage() -> std::string {
-  std::string response = ReceiveFramedMessage(std::cin);
+  FlushBeforeRead();
+  std::string response = ReceiveFramedMessage(GetInput(), GetReadBuffer());
   spdlog::debug("FramedStdioTransport received message: {}", response);
   return response;
 }
 
+auto FramedStdioTransport::IsStreaming() const -> bool {
+  return GetFramedOptions().stream_content;
+}
+
+auto FramedStdioTransport::ReceiveJson() -> nlohmann::json {
+  FlushBeforeRead();
+  return ReceiveFramedJson(GetInput(), GetReadBuffer());
+}
+
 }  // namespace jsonrpc::transport
@@ -1,73 +1,151 @@
 #include "jsonrpc/transport/framed_transport.hpp"
 
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <optional>
 #include <stdexcept>
+#include <string_view>
+
+#include <fmt/format.h>
 
 #include "jsonrpc/utils/string_utils.hpp"
 
 namespace jsonrpc::transport {
 
-void FramedTransport::FrameMessage(
-    std::ostream &output, const std::string &message) {
-  output << "Content-Length: " << message.size() << "\r\n"
-         << "Content-Type: application/vscode-jsonrpc; charset=utf-8\r\n"
-         << "\r\n"
-         << message;
+namespace {
+
+constexpr std::string_view kContentLengthName = "Content-Length";
+constexpr std::string_view kContentLengthPrefix = "Content-Length: ";
+constexpr std::string_view kContentTypeLine =
+    "\r\nContent-Type: application/vscode-jsonrpc; charset=utf-8\r\n\r\n";
+
+}  // namespace
+
+FramedTransport::FramedTransport(FramedOptions options) : options_(options) {
 }
 
-auto FramedTransport::ReadHeadersFromStream(std::istream &input)
-    -> FramedTransport::HeaderMap {
-  HeaderMap headers;
-  std::string line;
-
-  while (std::getline(input, line) && !line.empty() && line != "\r") {
-    auto colon_pos = line.find(':');
-    if (colon_pos != std::string::npos) {
-      std::string header_key = utils::Trim(line.substr(0, colon_pos));
-      std::string header_value = utils::Trim(line.substr(colon_pos + 1));
-      headers[header_key] = header_value;
+auto FramedTransport::GetFramedOptions() const -> const FramedOptions & {
+  return options_;
+}
+
+auto FramedTransport::MakeFrameHeader(std::size_t content_length)
+    -> FrameHeader {
+  static_assert(
+      kContentLengthPrefix.size() + 20 + kContentTypeLine.size() <=
+      kMaxHeaderSize);
+
+  FrameHeader header{};
+  char *out = header.data.data();
+  char *end = out + header.data.size();
+  std::memcpy(out, kContentLengthPrefix.data(), kContentLengthPrefix.size());
+  out += kContentLengthPrefix.size();
+  out = std::to_chars(out, end, content_length).ptr;
+  std::memcpy(out, kContentTypeLine.data(), kContentTypeLine.size());
+  out += kContentTypeLine.size();
+  header.size = static_cast<std::size_t>(out - header.data.data());
+  return header;
+}
+
+auto FramedTransport::ParseHeaders(std::string_view headers) -> std::size_t {
+  std::optional<std::size_t> content_length;
+  bool found_header = false;
+
+  while (!headers.empty()) {
+    std::size_t line_end = headers.find('\n');
+    std::string_view line = headers.substr(0, line_end);
+    headers.remove_prefix(
+        line_end == std::string_view::npos ? headers.size() : line_end + 1);
+    if (!line.empty() && line.back() == '\r') {
+      line.remove_suffix(1);
+    }
+    if (line.empty()) {
+      break;
+    }
+
+    std::size_t colon_pos = line.find(':');
+    if (colon_pos == std::string_view::npos) {
+      continue;
+    }
+    found_header = true;
+    std::string_view name = utils::TrimView(line.substr(0, colon_pos));
+    if (utils::EqualsIgnoreCase(name, kContentLengthName)) {
+      content_length = ParseContentLength(line.substr(colon_pos + 1));
     }
   }
 
-  if (headers.empty()) {
+  if (!found_header) {
     throw std::runtime_error("Failed to read headers");
   }
-
-  return headers;
-}
-
-auto FramedTransport::ReadContentLengthFromStream(std::istream &input) -> int {
-  auto headers = ReadHeadersFromStream(input);
-  auto it = headers.find("Content-Length");
-  if (it == headers.end()) {
+  if (!content_length) {
     throw std::runtime_error("Content-Length header missing");
   }
-  return ParseContentLength(it->second);
+  return *content_length;
 }
 
-auto FramedTransport::ReadContent(
-    std::istream &input, std::size_t content_length) -> std::string {
-  std::string content(content_length, '\0');
-  input.read(content.data(), static_cast<std::streamsize>(content_length));
-  if (input.gcount() != static_cast<std::streamsize>(content_length)) {
-    throw std::runtime_error("Failed to read the expected content length");
+auto FramedTransport::FindHeaderEnd(
+    const asio::streambuf &buffer, std::size_t &searched) -> std::size_t {
+  constexpr std::size_t kDelimiterSize =
+      std::string_view(kHeaderDelimiter).size();
+
+  // A streambuf's readable bytes are contiguous.
+  const auto *data = static_cast<const char *>(buffer.data().data());
+  std::size_t size = std::min(buffer.size(), kMaxReceivedHeaderSize);
+  if (size > searched) {
+    std::size_t pos =
+        FindDelimiter(data + searched, size - searched, kHeaderDelimiter);
+    if (pos != std::string_view::npos) {
+      return searched + pos + kDelimiterSize;
+    }
+    // A delimiter split across reads starts in the last few bytes.
+    searched = size - std::min(size, kDelimiterSize - 1);
   }
-  return content;
+  if (buffer.size() >= kMaxReceivedHeaderSize) {
+    throw std::runtime_error("Message headers too long");
+  }
+  return 0;
 }
 
-auto FramedTransport::ReceiveFramedMessage(std::istream &input) -> std::string {
-  int content_length = ReadContentLengthFromStream(input);
-  return ReadContent(input, content_length);
+auto FramedTransport::MessageTooLarge(std::size_t content_length) const
+    -> MessageTooLargeError {
+  return MessageTooLargeError(fmt::format(
+      "Message of {} bytes exceeds the limit of {} bytes", content_length,
+      options_.max_message_size));
 }
 
-auto FramedTransport::ParseContentLength(const std::string &header_value)
-    -> int {
-  try {
-    return std::stoi(header_value);
-  } catch (const std::invalid_argument &) {
-    throw std::runtime_error("Invalid Content-Length value");
-  } catch (const std::out_of_range &) {
+auto FramedTransport::TakeHeaders(
+    asio::streambuf &buffer, std::size_t header_size) -> std::size_t {
+  // A streambuf's readable bytes are contiguous, so the headers are parsed
+  // in place.
+  std::string_view headers(
+      static_cast<const char *>(buffer.data().data()), header_size);
+  std::size_t content_length = ParseHeaders(headers);
+  buffer.consume(header_size);
+  return content_length;
+}
+
+auto FramedTransport::TakeContent(
+    asio::streambuf &buffer, std::size_t content_length) -> std::string {
+  auto begin = asio::buffers_begin(buffer.data());
+  std::string content(
+      begin, begin + static_cast<std::ptrdiff_t>(content_length));
+  buffer.consume(content_length);
+  return content;
+}
+
+auto FramedTransport::ParseContentLength(std::string_view header_value)
+    -> std::size_t {
+  std::string_view digits = utils::TrimView(header_value);
+  std::size_t content_length = 0;
+  auto [end, ec] = std::from_chars(
+      digits.data(), digits.data() + digits.size(), content_length);
+  if (ec == std::errc::result_out_of_range) {
     throw std::runtime_error("Content-Length value out of range");
   }
+  if (ec != std::errc() || end != digits.data() + digits.size()) {
+    throw std::runtime_error("Invalid Content-Length value");
+  }
+  return content_length;
 }
 
 }  // namespace jsonrpc::transport
@@ -0,0 +1,475 @@
+#include "jsonrpc/transport/io_uring_stream.hpp"
+
+#ifdef JSONRPC_USE_IO_URING
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+namespace jsonrpc::transport {
+
+namespace {
+
+constexpr unsigned kQueueDepth = 8;
+constexpr std::uint16_t kBufferGroup = 0;
+constexpr std::uint64_t kReceiveTag = 1;
+constexpr std::uint64_t kSendTag = 2;
+
+auto Setup(unsigned entries, io_uring_params &params) -> int {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+}
+
+auto Enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags)
+    -> int {
+  return static_cast<int>(syscall(
+      __NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+auto Register(int fd, unsigned opcode, void *arg, unsigned nr_args) -> int {
+  return static_cast<int>(
+      syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+template <typename T>
+auto Load(T *field) -> T {
+  return std::atomic_ref<T>(*field).load(std::memory_order_acquire);
+}
+
+template <typename T>
+void Store(T *field, T value) {
+  std::atomic_ref<T>(*field).store(value, std::memory_order_release);
+}
+
+/// One io_uring instance used by a single thread at a time.
+class Ring {
+ public:
+  Ring() = default;
+
+  ~Ring() {
+    if (ring_ != MAP_FAILED) {
+      munmap(ring_, ring_size_);
+    }
+    if (sqes_ != MAP_FAILED) {
+      munmap(sqes_, sqes_size_);
+    }
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  Ring(const Ring &) = delete;
+  auto operator=(const Ring &) -> Ring & = delete;
+
+  Ring(Ring &&) = delete;
+  auto operator=(Ring &&) -> Ring & = delete;
+
+  auto Init(unsigned entries) -> bool {
+    io_uring_params params{};
+    fd_ = Setup(entries, params);
+    if (fd_ < 0) {
+      return false;
+    }
+    // Older kernels map the two rings separately; not worth supporting.
+    if ((params.features & IORING_FEAT_SINGLE_MMAP) == 0) {
+      return false;
+    }
+
+    std::size_t sq_size =
+        params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    std::size_t cq_size =
+        params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    ring_size_ = std::max(sq_size, cq_size);
+    ring_ = mmap(
+        nullptr, ring_size_, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = mmap(
+        nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+        fd_, IORING_OFF_SQES);
+    if (ring_ == MAP_FAILED || sqes_ == MAP_FAILED) {
+      return false;
+    }
+
+    auto *base = static_cast<char *>(ring_);
+    sq_tail_ = reinterpret_cast<unsigned *>(base + params.sq_off.tail);
+    sq_mask_ = *reinterpret_cast<unsigned *>(base + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned *>(base + params.sq_off.array);
+    cq_head_ = reinterpret_cast<unsigned *>(base + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned *>(base + params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<unsigned *>(base + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe *>(base + params.cq_off.cqes);
+    return true;
+  }
+
+  [[nodiscard]] auto Fd() const -> int {
+    return fd_;
+  }
+
+  /// Returns a zeroed SQE that is submitted by the next Submit().
+  auto NextSqe() -> io_uring_sqe & {
+    unsigned tail = *sq_tail_ + pending_;
+    unsigned index = tail & sq_mask_;
+    auto &sqe = static_cast<io_uring_sqe *>(sqes_)[index];
+    std::memset(&sqe, 0, sizeof(sqe));
+    sq_array_[index] = index;
+    ++pending_;
+    return sqe;
+  }
+
+  /// Submits pending SQEs and optionally waits for one completion.
+  auto Submit(bool wait) -> int {
+    Store(sq_tail_, *sq_tail_ + pending_);
+    unsigned to_submit = pending_;
+    pending_ = 0;
+    while (true) {
+      int result = Enter(
+          fd_, to_submit, wait ? 1 : 0, wait ? IORING_ENTER_GETEVENTS : 0);
+      if (result >= 0 || errno != EINTR) {
+        return result < 0 ? -errno : result;
+      }
+      // Interrupted waits are retried; SQEs were consumed before the wait.
+      to_submit = 0;
+    }
+  }
+
+  /// Pops the next completion, if any.
+  auto PopCqe(io_uring_cqe &cqe) -> bool {
+    unsigned head = *cq_head_;
+    if (head == Load(cq_tail_)) {
+      return false;
+    }
+    cqe = cqes_[head & cq_mask_];
+    Store(cq_head_, head + 1);
+    return true;
+  }
+
+ private:
+  int fd_ = -1;
+  void *ring_ = MAP_FAILED;
+  std::size_t ring_size_ = 0;
+  void *sqes_ = MAP_FAILED;
+  std::size_t sqes_size_ = 0;
+  unsigned *sq_tail_ = nullptr;
+  unsigned sq_mask_ = 0;
+  unsigned *sq_array_ = nullptr;
+  unsigned *cq_head_ = nullptr;
+  unsigned *cq_tail_ = nullptr;
+  unsigned cq_mask_ = 0;
+  io_uring_cqe *cqes_ = nullptr;
+  unsigned pending_ = 0;
+};
+
+/// Submits the pending SQE and waits for its completion. Returns the number
+/// of bytes transferred; end of stream on a receive is reported as eof.
+auto Complete(Ring &ring, asio::error_code &ec) -> std::size_t {
+  int result = ring.Submit(true);
+  io_uring_cqe cqe{};
+  while (result >= 0 && !ring.PopCqe(cqe)) {
+    result = ring.Submit(true);
+  }
+  if (result < 0) {
+    ec = asio::error_code(-result, asio::error::get_system_category());
+    return 0;
+  }
+  if (cqe.res < 0) {
+    ec = asio::error_code(-cqe.res, asio::error::get_system_category());
+    return 0;
+  }
+  if (cqe.res == 0 && cqe.user_data == kReceiveTag) {
+    ec = asio::error::eof;
+    return 0;
+  }
+  ec = {};
+  return static_cast<std::size_t>(cqe.res);
+}
+
+}  // namespace
+
+struct IoUringStream::State {
+  /// A received chunk still held in a provided buffer.
+  struct Chunk {
+    std::uint16_t buffer_id;
+    std::size_t offset;
+    std::size_t size;
+  };
+
+  int fd = -1;
+  IoUringOptions options;
+
+  Ring receive_ring;
+  Ring send_ring;
+
+  /// Ring of buffer descriptors shared with the kernel.
+  io_uring_buf_ring *buffer_ring = nullptr;
+  std::size_t buffer_ring_size = 0;
+  std::uint16_t buffer_ring_tail = 0;
+  bool buffer_ring_registered = false;
+  std::vector<char> buffers;
+
+  /// False when the kernel cannot fill buffers from the ring; each read is
+  /// then a single-shot receive into the caller's buffer.
+  bool use_buffer_ring = true;
+  std::deque<Chunk> chunks;
+  bool receive_armed = false;
+  bool at_eof = false;
+  int receive_error = 0;
+
+  ~State() {
+    if (buffer_ring_registered) {
+      io_uring_buf_reg reg{};
+      reg.bgid = kBufferGroup;
+      Register(receive_ring.Fd(), IORING_UNREGISTER_PBUF_RING, &reg, 1);
+    }
+    if (buffer_ring != nullptr) {
+      munmap(buffer_ring, buffer_ring_size);
+    }
+  }
+
+  auto BufferData(std::uint16_t id) -> char * {
+    return buffers.data() + static_cast<std::size_t>(id) * options.buffer_size;
+  }
+
+  /// Hands a buffer back to the kernel.
+  void Recycle(std::uint16_t id) {
+    unsigned mask = options.buffer_count - 1;
+    auto &entry = buffer_ring->bufs[buffer_ring_tail & mask];
+    entry.addr = reinterpret_cast<std::uint64_t>(BufferData(id));
+    entry.len = static_cast<std::uint32_t>(options.buffer_size);
+    entry.bid = id;
+    ++buffer_ring_tail;
+    Store(&buffer_ring->tail, buffer_ring_tail);
+  }
+
+  auto SetUpBuffers() -> bool {
+    buffer_ring_size = options.buffer_count * sizeof(io_uring_buf);
+    void *memory = mmap(
+        nullptr, buffer_ring_size, PROT_READ | PROT_WRITE,
+        MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    if (memory == MAP_FAILED) {
+      return false;
+    }
+    buffer_ring = static_cast<io_uring_buf_ring *>(memory);
+    buffers.resize(options.buffer_count * options.buffer_size);
+
+    io_uring_buf_reg reg{};
+    reg.ring_addr = reinterpret_cast<std::uint64_t>(buffer_ring);
+    reg.ring_entries = options.buffer_count;
+    reg.bgid = kBufferGroup;
+    if (Register(receive_ring.Fd(), IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+      return false;
+    }
+    buffer_ring_registered = true;
+    for (unsigned id = 0; id < options.buffer_count; ++id) {
+      Recycle(static_cast<std::uint16_t>(id));
+    }
+    return true;
+  }
+
+  void ArmReceive() {
+    auto &sqe = receive_ring.NextSqe();
+    sqe.opcode = IORING_OP_RECV;
+    sqe.fd = fd;
+    sqe.ioprio = IORING_RECV_MULTISHOT;
+    sqe.flags = IOSQE_BUFFER_SELECT;
+    sqe.buf_group = kBufferGroup;
+    sqe.user_data = kReceiveTag;
+    receive_armed = true;
+  }
+
+  /// Moves completed receives into chunks. Returns false if none were
+  /// available.
+  auto ReapReceives() -> bool {
+    bool reaped = false;
+    io_uring_cqe cqe{};
+    while (receive_ring.PopCqe(cqe)) {
+      reaped = true;
+      if ((cqe.flags & IORING_CQE_F_MORE) == 0) {
+        receive_armed = false;
+      }
+      if (cqe.res > 0) {
+        auto id =
+            static_cast<std::uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+        chunks.push_back({id, 0, static_cast<std::size_t>(cqe.res)});
+      } else if (cqe.res == 0) {
+        at_eof = true;
+      } else if (cqe.res != -ENOBUFS) {
+        // Running out of buffers only disarms the receive; it is re-armed
+        // once the reader has returned some.
+        receive_error = -cqe.res;
+      }
+    }
+    return reaped;
+  }
+};
+
+auto IoUringStream::Create(int fd, IoUringOptions options)
+    -> std::unique_ptr<IoUringStream> {
+  options.buffer_count =
+      std::bit_ceil(std::clamp(options.buffer_count, 1U, 32768U));
+  options.buffer_size = std::max<std::size_t>(options.buffer_size, 1);
+
+  auto state = std::make_unique<State>();
+  state->fd = fd;
+  state->options = options;
+  if (!state->receive_ring.Init(kQueueDepth) ||
+      !state->send_ring.Init(kQueueDepth) || !state->SetUpBuffers()) {
+    spdlog::info("io_uring unavailable ({}), using asio", strerror(errno));
+    return nullptr;
+  }
+
+  // Kernels without multishot receive reject it as soon as it is issued, and
+  // ones that cannot use the buffer ring end it at once with ENOBUFS.
+  state->ArmReceive();
+  if (state->receive_ring.Submit(false) < 0) {
+    spdlog::info("io_uring submission failed, using asio");
+    return nullptr;
+  }
+  state->ReapReceives();
+  if (state->receive_error != 0) {
+    spdlog::info(
+        "io_uring multishot receive unsupported ({}), using asio",
+        strerror(state->receive_error));
+    return nullptr;
+  }
+  if (!state->receive_armed && state->chunks.empty() && !state->at_eof) {
+    spdlog::debug("io_uring provided buffers unusable, receiving directly");
+    state->use_buffer_ring = false;
+  }
+
+  spdlog::debug("Using io_uring for socket {}", fd);
+  return std::unique_ptr<IoUringStream>(new IoUringStream(std::move(state)));
+}
+
+IoUringStream::IoUringStream(std::unique_ptr<State> state)
+    : state_(std::move(state)) {
+}
+
+IoUringStream::~IoUringStream() = default;
+
+auto IoUringStream::ReadSome(void *data, std::size_t size, asio::error_code &ec)
+    -> std::size_t {
+  State &state = *state_;
+  if (!state.use_buffer_ring) {
+    return ReceiveSome(data, size, ec);
+  }
+  while (state.chunks.empty()) {
+    if (state.receive_error != 0) {
+      ec = asio::error_code(
+          state.receive_error, asio::error::get_system_category());
+      return 0;
+    }
+    if (state.at_eof) {
+      ec = asio::error::eof;
+      return 0;
+    }
+    if (state.ReapReceives()) {
+      continue;
+    }
+    if (!state.receive_armed) {
+      state.ArmReceive();
+    }
+    int result = state.receive_ring.Submit(true);
+    if (result < 0) {
+      ec = asio::error_code(-result, asio::error::get_system_category());
+      return 0;
+    }
+  }
+
+  State::Chunk &chunk = state.chunks.front();
+  std::size_t copied = std::min(size, chunk.size - chunk.offset);
+  std::memcpy(data, state.BufferData(chunk.buffer_id) + chunk.offset, copied);
+  chunk.offset += copied;
+  if (chunk.offset == chunk.size) {
+    state.Recycle(chunk.buffer_id);
+    state.chunks.pop_front();
+  }
+  ec = {};
+  return copied;
+}
+
+auto IoUringStream::ReceiveSome(
+    void *data, std::size_t size, asio::error_code &ec) -> std::size_t {
+  auto &sqe = state_->receive_ring.NextSqe();
+  sqe.opcode = IORING_OP_RECV;
+  sqe.fd = state_->fd;
+  sqe.addr = reinterpret_cast<std::uint64_t>(data);
+  sqe.len = static_cast<std::uint32_t>(
+      std::min<std::size_t>(size, std::numeric_limits<std::uint32_t>::max()));
+  sqe.user_data = kReceiveTag;
+  return Complete(state_->receive_ring, ec);
+}
+
+auto IoUringStream::WriteSome(
+    const iovec *iovecs, std::size_t count, asio::error_code &ec)
+    -> std::size_t {
+  msghdr message{};
+  message.msg_iov = const_cast<iovec *>(iovecs);
+  message.msg_iovlen = count;
+
+  auto &sqe = state_->send_ring.NextSqe();
+  sqe.opcode = IORING_OP_SENDMSG;
+  sqe.fd = state_->fd;
+  sqe.addr = reinterpret_cast<std::uint64_t>(&message);
+  sqe.len = 1;
+  sqe.msg_flags = MSG_NOSIGNAL;
+  sqe.user_data = kSendTag;
+
+  return Complete(state_->send_ring, ec);
+}
+
+}  // namespace jsonrpc::transport
+
+#else
+
+namespace jsonrpc::transport {
+
+struct IoUringStream::State {};
+
+auto IoUringStream::Create(int /*fd*/, IoUringOptions /*options*/)
+    -> std::unique_ptr<IoUringStream> {
+  return nullptr;
+}
+
+IoUringStream::IoUringStream(std::unique_ptr<State> state)
+    : state_(std::move(state)) {
+}
+
+IoUringStream::~IoUringStream() = default;
+
+auto IoUringStream::ReadSome(
+    void * /*data*/, std::size_t /*size*/, asio::error_code &ec)
+    -> std::size_t {
+  ec = asio::error::operation_not_supported;
+  return 0;
+}
+
+auto IoUringStream::ReceiveSome(
+    void * /*data*/, std::size_t /*size*/, asio::error_code &ec)
+    -> std::size_t {
+  ec = asio::error::operation_not_supported;
+  return 0;
+}
+
+auto IoUringStream::WriteSome(
+    const iovec * /*iovecs*/, std::size_t /*count*/, asio::error_code &ec)
+    -> std::size_t {
+  ec = asio::error::operation_not_supported;
+  return 0;
+}
+
+}  // namespace jsonrpc::transport
+
+#endif
@@ -0,0 +1,266 @@
+#include "jsonrpc/transport/loopback_transport.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+namespace jsonrpc::transport {
+
+namespace {
+
+constexpr std::size_t kCacheLineSize = 64;
+
+}  // namespace
+
+/**
+ * Intrusive MPSC queue after Vyukov: senders link nodes at the head with one
+ * exchange, the receiver unlinks them at the tail without synchronizing with
+ * senders. The tail is always a node whose message was already taken,
+ * initially `stub_`.
+ */
+class LoopbackTransport::Inbox : public std::enable_shared_from_this<Inbox> {
+ public:
+  explicit Inbox(asio::any_io_executor executor)
+      : executor_(std::move(executor)) {
+  }
+
+  ~Inbox() {
+    Node *node = tail_->next.load(std::memory_order_relaxed);
+    if (tail_ != &stub_) {
+      delete tail_;
+    }
+    while (node != nullptr) {
+      Node *next = node->next.load(std::memory_order_relaxed);
+      delete node;
+      node = next;
+    }
+  }
+
+  Inbox(const Inbox &) = delete;
+  auto operator=(const Inbox &) -> Inbox & = delete;
+
+  Inbox(Inbox &&) = delete;
+  auto operator=(Inbox &&) -> Inbox & = delete;
+
+  void Push(std::string message) {
+    if (closed_.load(std::memory_order_acquire)) {
+      throw std::runtime_error("Loopback transport is closed");
+    }
+    auto *node = new Node{{nullptr}, std::move(message)};
+    Node *previous = head_.exchange(node, std::memory_order_acq_rel);
+    previous->next.store(node, std::memory_order_release);
+
+    // Sequentially consistent, like the receiver's arming of a wait, so that
+    // either the receiver sees the new sequence or the sender sees the wait.
+    data_seq_.fetch_add(1, std::memory_order_seq_cst);
+    if (readers_waiting_.load(std::memory_order_seq_cst) > 0) {
+      data_seq_.notify_one();
+    }
+    if (receive_pending_.load(std::memory_order_seq_cst)) {
+      CompletePending();
+    }
+  }
+
+  auto Pop() -> std::string {
+    std::lock_guard<std::mutex> lock(receive_mutex_);
+    std::string message;
+    while (true) {
+      std::uint32_t seq = data_seq_.load(std::memory_order_seq_cst);
+      if (TryPop(message)) {
+        return message;
+      }
+      if (closed_.load(std::memory_order_seq_cst)) {
+        // Messages sent before the close are still delivered.
+        if (TryPop(message)) {
+          return message;
+        }
+        throw std::runtime_error("Loopback transport is closed");
+      }
+      readers_waiting_.fetch_add(1, std::memory_order_seq_cst);
+      data_seq_.wait(seq, std::memory_order_seq_cst);
+      readers_waiting_.fetch_sub(1, std::memory_order_relaxed);
+    }
+  }
+
+  void AsyncPop(ReceiveHandler handler) {
+    std::uint32_t seq = data_seq_.load(std::memory_order_seq_cst);
+    std::string message;
+    if (TryPop(message)) {
+      Post(std::move(handler), {}, std::move(message));
+      return;
+    }
+    if (closed_.load(std::memory_order_seq_cst)) {
+      Post(std::move(handler), asio::error::eof, {});
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(pending_mutex_);
+      pending_ = std::move(handler);
+      receive_pending_.store(true, std::memory_order_seq_cst);
+    }
+    // A send or close that raced with arming may have missed the handler.
+    // The queue itself is not looked at again: once armed, the handler may
+    // already be running elsewhere as the receiver.
+    if (data_seq_.load(std::memory_order_seq_cst) != seq) {
+      CompletePending();
+    }
+  }
+
+  void Close() {
+    closed_.store(true, std::memory_order_seq_cst);
+    data_seq_.fetch_add(1, std::memory_order_seq_cst);
+    data_seq_.notify_all();
+    CompletePending();
+  }
+
+ private:
+  struct Node {
+    std::atomic<Node *> next;
+    std::string message;
+  };
+
+  /// Takes the oldest message. Only the receiver calls this.
+  auto TryPop(std::string &message) -> bool {
+    Node *next = tail_->next.load(std::memory_order_acquire);
+    if (next == nullptr) {
+      return false;
+    }
+    message = std::move(next->message);
+    if (tail_ != &stub_) {
+      delete tail_;
+    }
+    tail_ = next;
+    return true;
+  }
+
+  /// Hands the armed asynchronous receive back to the executor to retry.
+  void CompletePending() {
+    ReceiveHandler handler;
+    {
+      std::lock_guard<std::mutex> lock(pending_mutex_);
+      if (!pending_) {
+        return;
+      }
+      handler = std::move(pending_);
+      pending_ = nullptr;
+      receive_pending_.store(false, std::memory_order_seq_cst);
+    }
+    asio::post(
+        executor_,
+        [self = shared_from_this(), handler = std::move(handler)]() mutable {
+          self->AsyncPop(std::move(handler));
+        });
+  }
+
+  void Post(
+      ReceiveHandler handler, const asio::error_code &ec, std::string message) {
+    asio::post(
+        executor_, [handler = std::move(handler), ec,
+                    message = std::move(message)]() mutable {
+          handler(ec, std::move(message));
+        });
+  }
+
+  asio::any_io_executor executor_;
+
+  Node stub_{{nullptr}, {}};
+  alignas(kCacheLineSize) std::atomic<Node *> head_{&stub_};
+  alignas(kCacheLineSize) Node *tail_ = &stub_;
+
+  /// Bumped after each send and on close; blocked receivers wait on it.
+  alignas(kCacheLineSize) std::atomic<std::uint32_t> data_seq_{0};
+  std::atomic<std::uint32_t> readers_waiting_{0};
+  std::atomic<bool> receive_pending_{false};
+  std::atomic<bool> closed_{false};
+
+  std::mutex receive_mutex_;
+  std::mutex pending_mutex_;
+  ReceiveHandler pending_;
+};
+
+auto LoopbackTransport::CreatePair() -> Pair {
+  auto io_context = std::make_shared<asio::io_context>();
+  asio::any_io_executor executor = io_context->get_executor();
+  return CreatePair(std::move(io_context), std::move(executor));
+}
+
+auto LoopbackTransport::CreatePair(asio::io_context &io_context) -> Pair {
+  return CreatePair(nullptr, io_context.get_executor());
+}
+
+auto LoopbackTransport::CreatePair(
+    std::shared_ptr<asio::io_context> owned_io_context,
+    asio::any_io_executor executor) -> Pair {
+  auto first_inbox = std::make_shared<Inbox>(executor);
+  auto second_inbox = std::make_shared<Inbox>(executor);
+  // The constructor is private, so std::make_unique cannot be used.
+  std::unique_ptr<LoopbackTransport> first(new LoopbackTransport(
+      owned_io_context, executor, first_inbox, second_inbox));
+  std::unique_ptr<LoopbackTransport> second(new LoopbackTransport(
+      owned_io_context, executor, second_inbox, first_inbox));
+  return {std::move(first), std::move(second)};
+}
+
+LoopbackTransport::LoopbackTransport(
+    std::shared_ptr<asio::io_context> owned_io_context,
+    asio::any_io_executor executor, std::shared_ptr<Inbox> inbox,
+    std::shared_ptr<Inbox> peer_inbox)
+    : owned_io_context_(std::move(owned_io_context)),
+      executor_(std::move(executor)),
+      inbox_(std::move(inbox)),
+      peer_inbox_(std::move(peer_inbox)) {
+}
+
+LoopbackTransport::~LoopbackTransport() {
+  Close();
+}
+
+void LoopbackTransport::SendMessage(const std::string &message) {
+  peer_inbox_->Push(message);
+}
+
+void LoopbackTransport::SendMessage(std::string &&message) {
+  peer_inbox_->Push(std::move(message));
+}
+
+auto LoopbackTransport::ReceiveMessage() -> std::string {
+  return inbox_->Pop();
+}
+
+void LoopbackTransport::Close() {
+  inbox_->Close();
+  peer_inbox_->Close();
+}
+
+auto LoopbackTransport::GetExecutor() -> asio::any_io_executor {
+  return executor_;
+}
+
+auto LoopbackTransport::SupportsAsync() const -> bool {
+  return owned_io_context_ == nullptr;
+}
+
+void LoopbackTransport::DoAsyncSendMessage(
+    std::string message, SendHandler handler) {
+  asio::error_code ec;
+  try {
+    peer_inbox_->Push(std::move(message));
+  } catch (const std::runtime_error &e) {
+    spdlog::debug("LoopbackTransport dropped a message: {}", e.what());
+    ec = asio::error::broken_pipe;
+  }
+  asio::post(executor_, [handler = std::move(handler), ec]() {
+    handler(ec);
+  });
+}
+
+void LoopbackTransport::DoAsyncReceiveMessage(ReceiveHandler handler) {
+  inbox_->AsyncPop(std::move(handler));
+}
+
+}  // namespace jsonrpc::transport
@@ -1,5 +1,6 @@
 #include "jsonrpc/transport/pipe_transport.hpp"
 
+#include <cerrno>
 #include <stdexcept>
 #include <unistd.h>
 
@@ -7,8 +8,28 @@
 
 namespace jsonrpc::transport {
 
-PipeTransport::PipeTransport(const std::string &socket_path, bool is_server)
-    : socket_(io_context_), socket_path_(socket_path), is_server_(is_server) {
+PipeTransport::PipeTransport(
+    const std::string &socket_path, bool is_server,
+    const SocketOptions &options)
+    : PipeTransport(
+          std::make_unique<asio::io_context>(), nullptr, socket_path,
+          is_server, options) {
+}
+
+PipeTransport::PipeTransport(
+    asio::io_context &io_context, const std::string &socket_path,
+    bool is_server, const SocketOptions &options)
+    : PipeTransport(nullptr, &io_context, socket_path, is_server, options) {
+}
+
+PipeTransport::PipeTransport(
+    std::unique_ptr<asio::io_context> owned_io_context,
+    asio::io_context *io_context, const std::string &socket_path,
+    bool is_server, const SocketOptions &options)
+    : StreamTransport(std::move(owned_io_context), io_context),
+      socket_path_(socket_path),
+      is_server_(is_server),
+      options_(options) {
   spdlog::info(
       "Initializing PipeTransport with socket path: {}. IsServer: {}",
       socket_path, is_server);
@@ -19,16 +40,12 @@ PipeTransport::PipeTransport(const std::string &socket_path, bool is_server)
   } else {
     Connect();
   }
-}
 
-auto PipeTransport::GetSocket() -> asio::local::stream_protocol::socket & {
-  return socket_;
+  EnableIoUring();
 }
 
 PipeTransport::~PipeTransport() {
   spdlog::info("Closing socket and shutting down PipeTransport.");
-  socket_.close();
-  io_context_.stop();
 }
 
 void PipeTransport::RemoveExistingSocketFile() {
@@ -43,55 +60,70 @@ void PipeTransport::RemoveExistingSocketFile() {
 }
 
 void PipeTransport::Connect() {
-  try {
-    asio::local::stream_protocol::endpoint endpoint(socket_path_);
-    socket_.connect(endpoint);
-    spdlog::info("Connected to socket at path: {}", socket_path_);
-  } catch (const std::exception &e) {
-    spdlog::error("Error connecting to socket: {}", e.what());
+  // As in SocketTransport, the timeout runs on a private io_context.
+  asio::io_context connect_context;
+  asio::local::stream_protocol::socket connecting(connect_context);
+  asio::steady_timer timer(connect_context);
+  timer.expires_after(options_.connect_timeout);
+
+  asio::error_code connect_error;
+  bool timed_out = false;
+  connecting.async_connect(
+      asio::local::stream_protocol::endpoint(socket_path_),
+      [&](const asio::error_code &error) {
+        timer.cancel();
+        connect_error = error;
+      });
+  timer.async_wait([&](const asio::error_code &error) {
+    if (!error) {
+      timed_out = true;
+      connecting.close();
+    }
+  });
+
+  connect_context.run();
+  if (timed_out) {
+    connect_error = asio::error::timed_out;
+  }
+
+  if (!connect_error) {
+    int fd = ::dup(connecting.native_handle());
+    if (fd < 0) {
+      connect_error =
+          asio::error_code(errno, asio::error::get_system_category());
+    } else {
+      GetSocket().assign(asio::local::stream_protocol(), fd, connect_error);
+      if (connect_error) {
+        ::close(fd);
+      }
+    }
+  }
+
+  if (connect_error) {
+    spdlog::error("Error connecting to socket: {}", connect_error.message());
     throw std::runtime_error("Error connecting to socket");
   }
+  spdlog::info("Connected to socket at path: {}", socket_path_);
+  ApplySocketOptions(GetSocket(), options_);
 }
 
 void PipeTransport::BindAndListen() {
   try {
+    asio::local::stream_protocol::endpoint endpoint(socket_path_);
     asio::local::stream_protocol::acceptor acceptor(
-        io_context_, asio::local::stream_protocol::endpoint(socket_path_));
-    acceptor.listen();
+        GetSocket().get_executor());
+    acceptor.open(endpoint.protocol());
+    ApplyAcceptorOptions(acceptor, options_);
+    acceptor.bind(endpoint);
+    acceptor.listen(options_.listen_backlog);
     spdlog::info("Listening on socket path: {}", socket_path_);
-    acceptor.accept(socket_);
+    acceptor.accept(GetSocket());
     spdlog::info("Accepted connection on socket path: {}", socket_path_);
+    ApplySocketOptions(GetSocket(), options_);
   } catch (const std::exception &e) {
     spdlog::error("Error binding/listening on socket: {}", e.what());
     throw std::runtime_error("Error binding/listening on socket");
   }
 }
 
-void PipeTransport::SendMessage(const std::string &message) {
-  try {
-    std::string full_message = message + "\n";
-    asio::write(socket_, asio::buffer(full_message));
-    spdlog::debug("Sent message: {}", message);
-  } catch (const std::exception &e) {
-    spdlog::error("Error sending message: {}", e.what());
-    throw std::runtime_error("Error sending message");
-  }
-}
-
-auto PipeTransport::ReceiveMessage() -> std::string {
-  try {
-    asio::streambuf buffer;
-    asio::read_until(socket_, buffer, '\n');
-    std::istream is(&buffer);
-    std::string message;
-    std::getline(is, message);
-    spdlog::debug("Received message: {}", message);
-    return message;
-  } catch (const std::exception &e) {
-    spdlog::error("Error receiving message: {}", e.what());
-    socket_.close();
-    throw std::runtime_error("Error receiving message");
-  }
-}
-
 }  // namespace jsonrpc::transport
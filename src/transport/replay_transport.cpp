@@ -0,0 +1,137 @@
+#include "jsonrpc/transport/replay_transport.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <spdlog/spdlog.h>
+
+namespace jsonrpc::transport {
+
+namespace {
+
+template <typename T>
+auto Get(const char *data, std::size_t offset) -> T {
+  T value;
+  std::memcpy(&value, data + offset, sizeof(value));
+  return value;
+}
+
+}  // namespace
+
+ReplayTransport::ReplayTransport(
+    const std::string &path, ReplayOptions options)
+    : options_(options) {
+  namespace format = capture_format;
+
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    throw std::runtime_error(
+        "Failed to open capture file " + path + ": " + std::strerror(errno));
+  }
+  struct stat info {};
+  if (::fstat(fd, &info) != 0 ||
+      static_cast<std::size_t>(info.st_size) < format::kFileHeaderSize) {
+    ::close(fd);
+    throw std::runtime_error(path + " is not a capture file");
+  }
+  size_ = static_cast<std::size_t>(info.st_size);
+  void *mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (mapping == MAP_FAILED) {
+    throw std::runtime_error(
+        "Failed to map capture file " + path + ": " + std::strerror(errno));
+  }
+  data_ = static_cast<const char *>(mapping);
+  ::madvise(mapping, size_, MADV_SEQUENTIAL);
+
+  if (std::string_view(data_, format::kMagic.size()) != format::kMagic ||
+      Get<std::uint32_t>(data_, format::kVersionOffset) != format::kVersion) {
+    ::munmap(mapping, size_);
+    throw std::runtime_error(path + " is not a capture file");
+  }
+  framing_ = Get<CaptureFraming>(data_, format::kFramingOffset);
+  cursor_ = format::kFileHeaderSize;
+  spdlog::info("Replaying {} ({} bytes)", path, size_);
+}
+
+ReplayTransport::~ReplayTransport() {
+  ::munmap(const_cast<char *>(data_), size_);
+}
+
+void ReplayTransport::SendMessage(const std::string & /*message*/) {
+  sent_count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+auto ReplayTransport::ReceiveMessage() -> std::string {
+  while (auto record = NextRecord()) {
+    if (record->direction != options_.direction) {
+      continue;
+    }
+    if (!WaitUntilDue(*record)) {
+      break;
+    }
+    received_count_.fetch_add(1, std::memory_order_relaxed);
+    return {record->data, record->size};
+  }
+  throw std::runtime_error("Replay finished");
+}
+
+void ReplayTransport::Close() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+  }
+  closed_cv_.notify_all();
+}
+
+auto ReplayTransport::GetFraming() const -> CaptureFraming {
+  return framing_;
+}
+
+auto ReplayTransport::GetReceivedCount() const -> std::size_t {
+  return received_count_.load(std::memory_order_relaxed);
+}
+
+auto ReplayTransport::GetSentCount() const -> std::size_t {
+  return sent_count_.load(std::memory_order_relaxed);
+}
+
+auto ReplayTransport::NextRecord() -> std::optional<Record> {
+  namespace format = capture_format;
+
+  if (size_ - cursor_ < format::kRecordHeaderSize) {
+    return std::nullopt;
+  }
+  const char *header = data_ + cursor_;
+  auto size = Get<std::uint32_t>(header, format::kSizeOffset);
+  if (size_ - cursor_ - format::kRecordHeaderSize < size) {
+    return std::nullopt;
+  }
+  Record record{
+      Get<std::int64_t>(header, format::kTimestampOffset),
+      Get<CaptureDirection>(header, format::kDirectionOffset),
+      header + format::kRecordHeaderSize, size};
+  cursor_ += format::kRecordHeaderSize + size;
+  return record;
+}
+
+auto ReplayTransport::WaitUntilDue(const Record &record) -> bool {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (options_.pacing == ReplayPacing::kAsFastAsPossible) {
+    return !closed_;
+  }
+  if (!first_timestamp_) {
+    first_timestamp_ = record.timestamp;
+    start_ = std::chrono::steady_clock::now();
+  }
+  auto due =
+      start_ + std::chrono::nanoseconds(record.timestamp - *first_timestamp_);
+  return !closed_cv_.wait_until(lock, due, [this]() { return closed_; });
+}
+
+}  // namespace jsonrpc::transport
@@ -0,0 +1,363 @@
+#include "jsonrpc/transport/shared_memory_transport.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <new>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <thread>
+#include <unistd.h>
+
+#include <spdlog/spdlog.h>
+
+namespace jsonrpc::transport {
+
+namespace {
+
+constexpr std::size_t kCacheLineSize = 64;
+
+/// Marks a fully initialized region.
+constexpr std::uint32_t kMagic = 0x4a524d31;  // "JRM1"
+
+/// Size of the length prefix stored before each message.
+constexpr std::size_t kLengthSize = sizeof(std::uint32_t);
+
+/// Longest a sleeper waits before rechecking, in case a wake was missed
+/// because the peer died.
+constexpr auto kFutexTimeout = std::chrono::milliseconds(100);
+
+/// How long a client waits for the server to finish initializing.
+constexpr auto kOpenTimeout = std::chrono::seconds(1);
+
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free);
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t));
+
+void FutexWait(std::atomic<std::uint32_t> &word, std::uint32_t expected) {
+  timespec timeout{};
+  timeout.tv_nsec =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(kFutexTimeout)
+          .count();
+  // Not FUTEX_PRIVATE_FLAG: the word is shared with another process.
+  syscall(
+      SYS_futex, reinterpret_cast<std::uint32_t *>(&word), FUTEX_WAIT,
+      expected, &timeout, nullptr, 0);
+}
+
+void FutexWakeAll(std::atomic<std::uint32_t> &word) {
+  syscall(
+      SYS_futex, reinterpret_cast<std::uint32_t *>(&word), FUTEX_WAKE,
+      INT32_MAX, nullptr, nullptr, 0);
+}
+
+void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
+
+}  // namespace
+
+/// Control block of one direction. Positions count bytes ever written and
+/// read, so `head - tail` is the number of bytes in the ring.
+struct SharedMemoryTransport::Ring {
+  alignas(kCacheLineSize) std::atomic<std::uint64_t> head{0};
+  alignas(kCacheLineSize) std::atomic<std::uint64_t> tail{0};
+
+  /// Bumped after each publish; the reader sleeps on it.
+  alignas(kCacheLineSize) std::atomic<std::uint32_t> data_seq{0};
+  std::atomic<std::uint32_t> readers_waiting{0};
+
+  /// Bumped after each consume; the writer sleeps on it.
+  alignas(kCacheLineSize) std::atomic<std::uint32_t> space_seq{0};
+  std::atomic<std::uint32_t> writers_waiting{0};
+};
+
+/// Start of the mapping. The storage of the server-to-client ring follows,
+/// then that of the client-to-server ring.
+struct SharedMemoryTransport::Region {
+  std::atomic<std::uint32_t> magic{0};
+  std::atomic<std::uint32_t> closed{0};
+  std::uint64_t capacity = 0;
+  Ring to_client;
+  Ring to_server;
+};
+
+namespace {
+
+/// Polls until ready() holds, then sleeps on seq between checks. Returns
+/// false if the session was closed first.
+template <typename Ready>
+auto WaitFor(
+    std::atomic<std::uint32_t> &seq, std::atomic<std::uint32_t> &waiting,
+    const std::atomic<std::uint32_t> &closed, int spin_iterations,
+    Ready ready) -> bool {
+  for (int i = 0; i < spin_iterations; ++i) {
+    if (ready()) {
+      return true;
+    }
+    CpuRelax();
+  }
+  while (true) {
+    // Announce the sleep before the final check so the peer either sees a
+    // waiter or the check sees its update.
+    waiting.fetch_add(1);
+    std::uint32_t observed = seq.load();
+    bool is_ready = ready();
+    bool is_closed = closed.load() != 0;
+    if (!is_ready && !is_closed) {
+      FutexWait(seq, observed);
+    }
+    waiting.fetch_sub(1);
+    if (is_ready || ready()) {
+      return true;
+    }
+    if (is_closed) {
+      return false;
+    }
+  }
+}
+
+/// Bumps seq and wakes anyone sleeping on it.
+void Signal(
+    std::atomic<std::uint32_t> &seq, std::atomic<std::uint32_t> &waiting) {
+  seq.fetch_add(1);
+  if (waiting.load() != 0) {
+    FutexWakeAll(seq);
+  }
+}
+
+void CopyIn(
+    char *data, std::size_t capacity, std::uint64_t position,
+    const void *source, std::size_t size) {
+  std::size_t offset = position & (capacity - 1);
+  std::size_t first = std::min(size, capacity - offset);
+  std::memcpy(data + offset, source, first);
+  std::memcpy(data, static_cast<const char *>(source) + first, size - first);
+}
+
+void CopyOut(
+    const char *data, std::size_t capacity, std::uint64_t position,
+    void *target, std::size_t size) {
+  std::size_t offset = position & (capacity - 1);
+  std::size_t first = std::min(size, capacity - offset);
+  std::memcpy(target, data + offset, first);
+  std::memcpy(static_cast<char *>(target) + first, data, size - first);
+}
+
+}  // namespace
+
+SharedMemoryTransport::SharedMemoryTransport(
+    const std::string &name, bool is_server, SharedMemoryOptions options)
+    : name_(name), is_server_(is_server), options_(options) {
+  spdlog::info(
+      "Initializing SharedMemoryTransport with name: {}. IsServer: {}", name,
+      is_server);
+
+  if (is_server_) {
+    Create(options_.ring_capacity);
+  } else {
+    Open();
+  }
+  AttachRings();
+}
+
+SharedMemoryTransport::~SharedMemoryTransport() {
+  spdlog::info("Closing SharedMemoryTransport.");
+  Close();
+  munmap(mapping_, mapping_size_);
+  if (is_server_) {
+    shm_unlink(name_.c_str());
+  }
+}
+
+void SharedMemoryTransport::Create(std::size_t ring_capacity) {
+  std::size_t capacity =
+      std::bit_ceil(std::max<std::size_t>(ring_capacity, kCacheLineSize));
+  std::size_t size = sizeof(Region) + 2 * capacity;
+
+  shm_unlink(name_.c_str());
+  int fd = shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0) {
+    spdlog::error(
+        "Failed to create shared memory {}: {}", name_, strerror(errno));
+    throw std::runtime_error("Error creating shared memory");
+  }
+  if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+    spdlog::error(
+        "Failed to size shared memory {}: {}", name_, strerror(errno));
+    close(fd);
+    shm_unlink(name_.c_str());
+    throw std::runtime_error("Error creating shared memory");
+  }
+  try {
+    Map(fd, size);
+  } catch (...) {
+    shm_unlink(name_.c_str());
+    throw;
+  }
+
+  region_ = new (mapping_) Region();
+  region_->capacity = capacity;
+  region_->magic.store(kMagic, std::memory_order_release);
+}
+
+void SharedMemoryTransport::Open() {
+  int fd = shm_open(name_.c_str(), O_RDWR, 0);
+  if (fd < 0) {
+    spdlog::error(
+        "Failed to open shared memory {}: {}", name_, strerror(errno));
+    throw std::runtime_error("Error opening shared memory");
+  }
+
+  // The server may still be sizing and initializing the object.
+  auto deadline = std::chrono::steady_clock::now() + kOpenTimeout;
+  struct stat info {};
+  while (fstat(fd, &info) == 0 &&
+         static_cast<std::size_t>(info.st_size) < sizeof(Region) &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  if (static_cast<std::size_t>(info.st_size) < sizeof(Region)) {
+    close(fd);
+    throw std::runtime_error("Error opening shared memory");
+  }
+  Map(fd, static_cast<std::size_t>(info.st_size));
+
+  region_ = static_cast<Region *>(mapping_);
+  while (region_->magic.load(std::memory_order_acquire) != kMagic) {
+    if (std::chrono::steady_clock::now() >= deadline) {
+      munmap(mapping_, mapping_size_);
+      throw std::runtime_error("Shared memory was not initialized");
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  if (!std::has_single_bit(region_->capacity) ||
+      sizeof(Region) + 2 * region_->capacity > mapping_size_) {
+    munmap(mapping_, mapping_size_);
+    throw std::runtime_error("Shared memory is smaller than its rings");
+  }
+}
+
+void SharedMemoryTransport::Map(int fd, std::size_t size) {
+  void *mapping =
+      mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  // The mapping stays valid after the descriptor is closed.
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    spdlog::error("Failed to map shared memory {}: {}", name_, strerror(errno));
+    throw std::runtime_error("Error mapping shared memory");
+  }
+  mapping_ = mapping;
+  mapping_size_ = size;
+}
+
+void SharedMemoryTransport::AttachRings() {
+  capacity_ = region_->capacity;
+  char *to_client_data = static_cast<char *>(mapping_) + sizeof(Region);
+  char *to_server_data = to_client_data + capacity_;
+  if (is_server_) {
+    send_ring_ = &region_->to_client;
+    send_data_ = to_client_data;
+    receive_ring_ = &region_->to_server;
+    receive_data_ = to_server_data;
+  } else {
+    send_ring_ = &region_->to_server;
+    send_data_ = to_server_data;
+    receive_ring_ = &region_->to_client;
+    receive_data_ = to_client_data;
+  }
+}
+
+void SharedMemoryTransport::SendMessage(const std::string &message) {
+  std::size_t needed = kLengthSize + message.size();
+  if (needed > capacity_) {
+    spdlog::error(
+        "Message of {} bytes exceeds shared memory ring of {} bytes",
+        message.size(), capacity_);
+    throw std::runtime_error("Message is larger than the shared memory ring");
+  }
+
+  std::lock_guard<std::mutex> lock(send_mutex_);
+  Ring &ring = *send_ring_;
+  std::uint64_t head = ring.head.load(std::memory_order_relaxed);
+  if (region_->closed.load() != 0 ||
+      !WaitFor(
+          ring.space_seq, ring.writers_waiting, region_->closed,
+          options_.spin_iterations, [&]() {
+            std::uint64_t tail = ring.tail.load(std::memory_order_acquire);
+            return capacity_ - (head - tail) >= needed;
+          })) {
+    throw std::runtime_error("Error sending message: transport is closed");
+  }
+
+  auto length = static_cast<std::uint32_t>(message.size());
+  CopyIn(send_data_, capacity_, head, &length, kLengthSize);
+  CopyIn(
+      send_data_, capacity_, head + kLengthSize, message.data(),
+      message.size());
+  ring.head.store(head + needed, std::memory_order_release);
+  Signal(ring.data_seq, ring.readers_waiting);
+  spdlog::debug("SharedMemoryTransport sent message: {}", message);
+}
+
+auto SharedMemoryTransport::ReceiveMessage() -> std::string {
+  std::lock_guard<std::mutex> lock(receive_mutex_);
+  Ring &ring = *receive_ring_;
+  std::uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+  if (!WaitFor(
+          ring.data_seq, ring.readers_waiting, region_->closed,
+          options_.spin_iterations, [&]() {
+            return ring.head.load(std::memory_order_acquire) != tail;
+          })) {
+    throw std::runtime_error("Error receiving message: transport is closed");
+  }
+
+  // The writer publishes a message in one step, so its length and content
+  // are both available once the head has moved.
+  std::uint64_t available = ring.head.load(std::memory_order_acquire) - tail;
+  std::uint32_t length = 0;
+  if (available >= kLengthSize && available <= capacity_) {
+    CopyOut(receive_data_, capacity_, tail, &length, kLengthSize);
+  }
+  // The mapping is writable by the peer, so a corrupt ring must not be
+  // trusted with an allocation or a copy.
+  if (available < kLengthSize || available > capacity_ ||
+      length > available - kLengthSize) {
+    spdlog::error(
+        "Corrupt shared memory ring: message of {} bytes with {} available",
+        length, available);
+    Close();
+    throw std::runtime_error("Error receiving message: corrupt message length");
+  }
+  std::string message(length, '\0');
+  CopyOut(receive_data_, capacity_, tail + kLengthSize, message.data(), length);
+  ring.tail.store(tail + kLengthSize + length, std::memory_order_release);
+  Signal(ring.space_seq, ring.writers_waiting);
+  spdlog::debug("SharedMemoryTransport received message: {}", message);
+  return message;
+}
+
+void SharedMemoryTransport::Close() {
+  if (region_ == nullptr || region_->closed.exchange(1) != 0) {
+    return;
+  }
+  for (Ring *ring : {send_ring_, receive_ring_}) {
+    ring->data_seq.fetch_add(1);
+    FutexWakeAll(ring->data_seq);
+    ring->space_seq.fetch_add(1);
+    FutexWakeAll(ring->space_seq);
+  }
+}
+
+}  // namespace jsonrpc::transport
@@ -0,0 +1,117 @@
+#include "jsonrpc/transport/socket_options.hpp"
+
+#include <sys/socket.h>
+
+#include <spdlog/spdlog.h>
+
+namespace jsonrpc::transport {
+
+namespace {
+
+#ifdef SO_REUSEPORT
+/// SO_REUSEPORT, which Asio has no public option for, as a settable socket
+/// option.
+class ReusePort {
+ public:
+  explicit ReusePort(bool enabled) : value_(enabled ? 1 : 0) {
+  }
+
+  template <typename Protocol>
+  [[nodiscard]] auto level(const Protocol & /*protocol*/) const -> int {
+    return SOL_SOCKET;
+  }
+
+  template <typename Protocol>
+  [[nodiscard]] auto name(const Protocol & /*protocol*/) const -> int {
+    return SO_REUSEPORT;
+  }
+
+  template <typename Protocol>
+  [[nodiscard]] auto data(const Protocol & /*protocol*/) const -> const int * {
+    return &value_;
+  }
+
+  template <typename Protocol>
+  [[nodiscard]] auto size(const Protocol & /*protocol*/) const
+      -> std::size_t {
+    return sizeof(value_);
+  }
+
+ private:
+  int value_;
+};
+#endif
+
+/// Sets an option, logging instead of failing if the platform rejects it.
+template <typename Socket, typename Option>
+void SetOption(Socket &socket, const Option &option, const char *name) {
+  asio::error_code ec;
+  socket.set_option(option, ec);
+  if (ec) {
+    spdlog::warn("Failed to set socket option {}: {}", name, ec.message());
+  }
+}
+
+/// Applies the settings shared by TCP and Unix domain sockets.
+template <typename Socket>
+void ApplyBufferSizes(Socket &socket, const SocketOptions &options) {
+  if (options.send_buffer_size) {
+    SetOption(
+        socket, asio::socket_base::send_buffer_size(*options.send_buffer_size),
+        "SO_SNDBUF");
+  }
+  if (options.receive_buffer_size) {
+    SetOption(
+        socket,
+        asio::socket_base::receive_buffer_size(*options.receive_buffer_size),
+        "SO_RCVBUF");
+  }
+}
+
+}  // namespace
+
+void ApplySocketOptions(
+    asio::ip::tcp::socket &socket, const SocketOptions &options) {
+  SetOption(socket, asio::ip::tcp::no_delay(options.no_delay), "TCP_NODELAY");
+  if (options.keep_alive) {
+    SetOption(socket, asio::socket_base::keep_alive(true), "SO_KEEPALIVE");
+  }
+  ApplyBufferSizes(socket, options);
+}
+
+void ApplySocketOptions(
+    asio::local::stream_protocol::socket &socket,
+    const SocketOptions &options) {
+  ApplyBufferSizes(socket, options);
+}
+
+void ApplyAcceptorOptions(
+    asio::ip::tcp::acceptor &acceptor, const SocketOptions &options) {
+  SetOption(acceptor, asio::socket_base::reuse_address(true), "SO_REUSEADDR");
+  if (options.reuse_port) {
+#ifdef SO_REUSEPORT
+    SetOption(acceptor, ReusePort(true), "SO_REUSEPORT");
+#else
+    spdlog::warn("SO_REUSEPORT is not supported on this platform");
+#endif
+  }
+  if (options.receive_buffer_size) {
+    SetOption(
+        acceptor,
+        asio::socket_base::receive_buffer_size(*options.receive_buffer_size),
+        "SO_RCVBUF");
+  }
+}
+
+void ApplyAcceptorOptions(
+    asio::local::stream_protocol::acceptor &acceptor,
+    const SocketOptions &options) {
+  if (options.receive_buffer_size) {
+    SetOption(
+        acceptor,
+        asio::socket_base::receive_buffer_size(*options.receive_buffer_size),
+        "SO_RCVBUF");
+  }
+}
+
+}  // namespace jsonrpc::transport
@@ -1,14 +1,35 @@
 #include "jsonrpc/transport/socket_transport.hpp"
 
 #include <stdexcept>
+#include <unistd.h>
 
 #include <spdlog/spdlog.h>
 
 namespace jsonrpc::transport {
 
 SocketTransport::SocketTransport(
-    const std::string &host, uint16_t port, bool is_server)
-    : socket_(io_context_), host_(host), port_(port), is_server_(is_server) {
+    const std::string &host, uint16_t port, bool is_server,
+    const SocketOptions &options)
+    : SocketTransport(
+          std::make_unique<asio::io_context>(), nullptr, host, port, is_server,
+          options) {
+}
+
+SocketTransport::SocketTransport(
+    asio::io_context &io_context, const std::string &host, uint16_t port,
+    bool is_server, const SocketOptions &options)
+    : SocketTransport(nullptr, &io_context, host, port, is_server, options) {
+}
+
+SocketTransport::SocketTransport(
+    std::unique_ptr<asio::io_context> owned_io_context,
+    asio::io_context *io_context, const std::string &host, uint16_t port,
+    bool is_server, const SocketOptions &options)
+    : StreamTransport(std::move(owned_io_context), io_context),
+      host_(host),
+      port_(port),
+      is_server_(is_server),
+      options_(options) {
   spdlog::info(
       "Initializing SocketTransport with host: {} and port: {}", host, port);
 
@@ -17,35 +38,34 @@ SocketTransport::SocketTransport(
   } else {
     Connect();
   }
-}
 
-auto SocketTransport::GetSocket() -> asio::ip::tcp::socket & {
-  return socket_;
+  EnableIoUring();
 }
 
 SocketTransport::~SocketTransport() {
   spdlog::info("Closing socket and shutting down SocketTransport.");
-  std::error_code ec;
-  socket_.close(ec);
-  if (ec) {
-    spdlog::warn("Socket close error: {}", ec.message());
-  }
-  io_context_.stop();
 }
 
 void SocketTransport::Connect() {
-  asio::ip::tcp::resolver resolver(io_context_);
+  // The connect timeout needs an event loop, and the caller's io_context may
+  // be running elsewhere or not at all, so connect on a private one.
+  asio::io_context connect_context;
+  asio::ip::tcp::socket connecting(connect_context);
+  asio::ip::tcp::resolver resolver(connect_context);
   auto endpoints = resolver.resolve(host_, std::to_string(port_));
 
-  asio::steady_timer timer(io_context_);
-  timer.expires_after(std::chrono::seconds(3));
+  asio::steady_timer timer(connect_context);
+  timer.expires_after(options_.connect_timeout);
 
   std::error_code connect_error;
+  asio::ip::tcp::endpoint connected_endpoint;
   asio::async_connect(
-      socket_, endpoints,
-      [&](const asio::error_code &error, const asio::ip::tcp::endpoint &) {
+      connecting, endpoints,
+      [&](const asio::error_code &error,
+          const asio::ip::tcp::endpoint &endpoint) {
         if (!error) {
           timer.cancel();
+          connected_endpoint = endpoint;
         } else {
           connect_error = error;
         }
@@ -54,11 +74,24 @@ void SocketTransport::Connect() {
   timer.async_wait([&](const asio::error_code &error) {
     if (!error) {
       connect_error = asio::error::timed_out;
-      socket_.close();
+      connecting.close();
     }
   });
 
-  io_context_.run();
+  connect_context.run();
+
+  if (!connect_error) {
+    int fd = ::dup(connecting.native_handle());
+    if (fd < 0) {
+      connect_error =
+          asio::error_code(errno, asio::error::get_system_category());
+    } else {
+      GetSocket().assign(connected_endpoint.protocol(), fd, connect_error);
+      if (connect_error) {
+        ::close(fd);
+      }
+    }
+  }
 
   if (connect_error) {
     spdlog::error(
@@ -66,16 +99,21 @@ void SocketTransport::Connect() {
         connect_error.message());
     throw std::runtime_error("Error connecting to socket");
   }
+  ApplySocketOptions(GetSocket(), options_);
 }
 
 void SocketTransport::BindAndListen() {
   try {
-    asio::ip::tcp::acceptor acceptor(
-        io_context_, asio::ip::tcp::endpoint(asio::ip::tcp::v4(), port_));
-    acceptor.listen();
+    asio::ip::tcp::endpoint endpoint(asio::ip::tcp::v4(), port_);
+    asio::ip::tcp::acceptor acceptor(GetSocket().get_executor());
+    acceptor.open(endpoint.protocol());
+    ApplyAcceptorOptions(acceptor, options_);
+    acceptor.bind(endpoint);
+    acceptor.listen(options_.listen_backlog);
     spdlog::info("Listening on {}:{}", host_, port_);
-    acceptor.accept(socket_);
+    acceptor.accept(GetSocket());
     spdlog::info("Accepted connection on {}:{}", host_, port_);
+    ApplySocketOptions(GetSocket(), options_);
   } catch (const std::exception &e) {
     spdlog::error(
         "Error binding/listening on {}:{}. Error: {}", host_, port_, e.what());
@@ -83,30 +121,4 @@ void SocketTransport::BindAndListen() {
   }
 }
 
-void SocketTransport::SendMessage(const std::string &message) {
-  try {
-    asio::write(socket_, asio::buffer(message + "\n"));
-    spdlog::debug("Sent message: {}", message);
-  } catch (const std::exception &e) {
-    spdlog::error("Error sending message: {}", e.what());
-    throw std::runtime_error("Error sending message");
-  }
-}
-
-auto SocketTransport::ReceiveMessage() -> std::string {
-  try {
-    asio::streambuf buffer;
-    asio::read_until(socket_, buffer, '\n');
-    std::istream is(&buffer);
-    std::string message;
-    std::getline(is, message);
-    spdlog::debug("Received message: {}", message);
-    return message;
-  } catch (const std::exception &e) {
-    spdlog::error("Error receiving message: {}", e.what());
-    socket_.close();
-    return "";
-  }
-}
-
 }  // namespace jsonrpc::transport
@@ -1,23 +1,145 @@
 #include "jsonrpc/transport/stdio_transport.hpp"
 
-#include <iostream>
+#include <stdexcept>
+#include <utility>
 
 #include <spdlog/spdlog.h>
 
+#include "jsonrpc/transport/delimiter_search.hpp"
+
 namespace jsonrpc::transport {
 
+namespace {
+
+constexpr DelimiterMatch kLineMatch("\n");
+
+}  // namespace
+
+StdioTransport::StdioTransport(StdioOptions options)
+    : options_(options),
+      input_(options.input_fd, /*interruptible=*/true),
+      output_(options.output_fd),
+      write_queue_([this](const std::vector<asio::const_buffer> &buffers) {
+        asio::write(output_, buffers);
+      }) {
+  // read_until reads as much as the buffer has room for, up to 64 KiB.
+  read_buffer_.prepare(options_.read_buffer_size);
+  if (options_.flush_policy == FlushPolicy::kWhenFull) {
+    pending_output_.reserve(options_.write_buffer_size);
+  }
+}
+
+StdioTransport::~StdioTransport() {
+  try {
+    Flush();
+  } catch (const std::exception &e) {
+    spdlog::error("StdioTransport failed to flush output: {}", e.what());
+  }
+}
+
 void StdioTransport::SendMessage(const std::string &message) {
   spdlog::debug("StdioTransport sending message: {}", message);
-  std::cout << message << std::endl;
+  Write({}, message, "\n");
+}
+
+void StdioTransport::SendMessage(std::string &&message) {
+  spdlog::debug("StdioTransport sending message: {}", message);
+  Write({}, std::move(message), "\n");
 }
 
 auto StdioTransport::ReceiveMessage() -> std::string {
-  std::string response;
-  if (!std::getline(std::cin, response)) {
+  FlushBeforeRead();
+
+  asio::error_code ec;
+  std::size_t length = asio::read_until(input_, read_buffer_, kLineMatch, ec);
+  std::size_t line_length = length - 1;
+  if (ec == asio::error::eof && read_buffer_.size() > 0) {
+    // Like std::getline, a final line without a newline is still a message.
+    length = read_buffer_.size();
+    line_length = length;
+  } else if (ec) {
     throw std::runtime_error("Failed to receive message");
   }
+
+  auto begin = asio::buffers_begin(read_buffer_.data());
+  std::string response(
+      begin, begin + static_cast<std::ptrdiff_t>(line_length));
+  read_buffer_.consume(length);
   spdlog::debug("StdioTransport received response: {}", response);
   return response;
 }
 
+void StdioTransport::Flush() {
+  std::lock_guard<std::mutex> lock(output_mutex_);
+  FlushLocked();
+}
+
+void StdioTransport::Close() {
+  Flush();
+  input_.Interrupt();
+}
+
+auto StdioTransport::GetInput() -> FdStream & {
+  return input_;
+}
+
+auto StdioTransport::GetReadBuffer() -> asio::streambuf & {
+  return read_buffer_;
+}
+
+void StdioTransport::Write(
+    std::string_view prefix, std::string &&body, std::string_view suffix) {
+  if (options_.flush_policy == FlushPolicy::kEveryMessage) {
+    try {
+      write_queue_.Send(prefix, std::move(body), suffix);
+    } catch (const std::exception &e) {
+      spdlog::error("StdioTransport failed to write: {}", e.what());
+      throw std::runtime_error("Failed to send message");
+    }
+    return;
+  }
+  Write(prefix, static_cast<const std::string &>(body), suffix);
+}
+
+void StdioTransport::Write(
+    std::string_view prefix, const std::string &body,
+    std::string_view suffix) {
+  if (options_.flush_policy == FlushPolicy::kEveryMessage) {
+    try {
+      write_queue_.Send(prefix, body, suffix);
+    } catch (const std::exception &e) {
+      spdlog::error("StdioTransport failed to write: {}", e.what());
+      throw std::runtime_error("Failed to send message");
+    }
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(output_mutex_);
+  pending_output_.append(prefix).append(body).append(suffix);
+  if (pending_output_.size() >= options_.write_buffer_size) {
+    FlushLocked();
+  }
+}
+
+void StdioTransport::FlushBeforeRead() {
+  if (options_.flush_policy == FlushPolicy::kWhenFull) {
+    Flush();
+  }
+}
+
+void StdioTransport::FlushLocked() {
+  if (pending_output_.empty()) {
+    return;
+  }
+  std::string output;
+  output.reserve(options_.write_buffer_size);
+  std::swap(output, pending_output_);
+  try {
+    write_queue_.Send({}, std::move(output), {});
+  } catch (const std::exception &e) {
+    spdlog::error("StdioTransport failed to write: {}", e.what());
+    throw std::runtime_error("Failed to send message");
+  }
+}
+
 }  // namespace jsonrpc::transport
@@ -0,0 +1,178 @@
+#include "jsonrpc/transport/stream_transport.hpp"
+
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+#include "jsonrpc/transport/delimiter_search.hpp"
+
+namespace jsonrpc::transport {
+
+namespace {
+
+constexpr DelimiterMatch kLineMatch("\n");
+
+}  // namespace
+
+template <typename Protocol>
+StreamTransport<Protocol>::StreamTransport(
+    std::unique_ptr<asio::io_context> owned_io_context,
+    asio::io_context *io_context)
+    : owned_io_context_(std::move(owned_io_context)),
+      socket_(io_context != nullptr ? *io_context : *owned_io_context_),
+      write_queue_(
+          [this](const std::vector<asio::const_buffer> &buffers) {
+            WithStream([&](auto &stream) { asio::write(stream, buffers); });
+          },
+          [this](
+              const std::vector<asio::const_buffer> &buffers,
+              WriteQueue::Handler handler) {
+            asio::async_write(
+                socket_, buffers,
+                [handler = std::move(handler)](
+                    const asio::error_code &ec, std::size_t) { handler(ec); });
+          }) {
+}
+
+template <typename Protocol>
+StreamTransport<Protocol>::~StreamTransport() {
+  asio::error_code ec;
+  socket_.close(ec);
+  if (ec) {
+    spdlog::warn("Socket close error: {}", ec.message());
+  }
+}
+
+template <typename Protocol>
+auto StreamTransport<Protocol>::GetSocket() -> Socket & {
+  return socket_;
+}
+
+template <typename Protocol>
+auto StreamTransport<Protocol>::GetReadBuffer() -> asio::streambuf & {
+  return read_buffer_;
+}
+
+template <typename Protocol>
+auto StreamTransport<Protocol>::GetWriteQueue() -> WriteQueue & {
+  return write_queue_;
+}
+
+template <typename Protocol>
+auto StreamTransport<Protocol>::GetExecutor() -> asio::any_io_executor {
+  return socket_.get_executor();
+}
+
+template <typename Protocol>
+void StreamTransport<Protocol>::EnableIoUring() {
+  if (owned_io_context_ != nullptr) {
+    uring_stream_ = IoUringStream::Create(socket_.native_handle());
+  }
+}
+
+template <typename Protocol>
+void StreamTransport<Protocol>::SendMessage(const std::string &message) {
+  try {
+    write_queue_.Send({}, message, "\n");
+    spdlog::debug("Sent message: {}", message);
+  } catch (const std::exception &e) {
+    spdlog::error("Error sending message: {}", e.what());
+    throw std::runtime_error("Error sending message");
+  }
+}
+
+template <typename Protocol>
+void StreamTransport<Protocol>::SendMessage(std::string &&message) {
+  try {
+    // The message is moved into the queue, so the log line is formatted
+    // first but only emitted once the send has succeeded.
+    std::string sent;
+    if (spdlog::should_log(spdlog::level::debug)) {
+      sent = fmt::format("Sent message: {}", message);
+    }
+    write_queue_.Send({}, std::move(message), "\n");
+    if (!sent.empty()) {
+      spdlog::debug(sent);
+    }
+  } catch (const std::exception &e) {
+    spdlog::error("Error sending message: {}", e.what());
+    throw std::runtime_error("Error sending message");
+  }
+}
+
+template <typename Protocol>
+auto StreamTransport<Protocol>::ReceiveMessage() -> std::string {
+  try {
+    // read_until returns without touching the socket if a whole line is
+    // already buffered from an earlier read.
+    std::string message = TakeLine(WithStream([this](auto &stream) {
+      return asio::read_until(stream, read_buffer_, kLineMatch);
+    }));
+    spdlog::debug("Received message: {}", message);
+    return message;
+  } catch (const std::exception &e) {
+    spdlog::error("Error receiving message: {}", e.what());
+    ShutdownSocket();
+    throw std::runtime_error("Error receiving message");
+  }
+}
+
+template <typename Protocol>
+auto StreamTransport<Protocol>::SupportsAsync() const -> bool {
+  return owned_io_context_ == nullptr;
+}
+
+template <typename Protocol>
+void StreamTransport<Protocol>::DoAsyncSendMessage(
+    std::string message, SendHandler handler) {
+  write_queue_.AsyncSend({}, std::move(message), "\n", std::move(handler));
+}
+
+template <typename Protocol>
+void StreamTransport<Protocol>::DoAsyncReceiveMessage(ReceiveHandler handler) {
+  asio::async_read_until(
+      socket_, read_buffer_, kLineMatch,
+      [this, handler = std::move(handler)](
+          const asio::error_code &ec, std::size_t length) {
+        if (ec) {
+          handler(ec, std::string());
+          return;
+        }
+        handler(ec, TakeLine(length));
+      });
+}
+
+template <typename Protocol>
+auto StreamTransport<Protocol>::TakeLine(std::size_t length) -> std::string {
+  auto begin = asio::buffers_begin(read_buffer_.data());
+  std::string line(begin, begin + static_cast<std::ptrdiff_t>(length - 1));
+  read_buffer_.consume(length);
+  return line;
+}
+
+template <typename Protocol>
+void StreamTransport<Protocol>::Close() {
+  write_queue_.Close();
+  ShutdownSocket();
+}
+
+template <typename Protocol>
+void StreamTransport<Protocol>::ShutdownSocket() {
+  std::lock_guard<std::mutex> lock(shutdown_mutex_);
+  if (!socket_.is_open()) {
+    return;
+  }
+  asio::error_code ec;
+  socket_.shutdown(asio::socket_base::shutdown_both, ec);
+  if (ec && ec != asio::error::not_connected) {
+    spdlog::warn("Socket shutdown error: {}", ec.message());
+  }
+}
+
+template class StreamTransport<asio::local::stream_protocol>;
+template class StreamTransport<asio::ip::tcp>;
+
+}  // namespace jsonrpc::transport
@@ -0,0 +1,315 @@
+#include "jsonrpc/transport/write_queue.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+namespace jsonrpc::transport {
+
+auto WriteQueue::Entry::Size() const -> std::size_t {
+  return prefix_size + body.size() + suffix.size();
+}
+
+void WriteQueue::Entry::AppendBuffers(
+    std::vector<asio::const_buffer> &buffers) const {
+  if (prefix_size > 0) {
+    buffers.emplace_back(prefix.data(), prefix_size);
+  }
+  buffers.emplace_back(body.data(), body.size());
+  if (!suffix.empty()) {
+    buffers.emplace_back(suffix.data(), suffix.size());
+  }
+}
+
+WriteQueue::WriteQueue(Writer writer, WriteQueueOptions options)
+    : writer_(std::move(writer)), options_(options) {
+}
+
+WriteQueue::WriteQueue(
+    Writer writer, AsyncWriter async_writer, WriteQueueOptions options)
+    : writer_(std::move(writer)),
+      async_writer_(std::move(async_writer)),
+      options_(options) {
+}
+
+void WriteQueue::Send(
+    std::string_view prefix, const std::string &body,
+    std::string_view suffix) {
+  SendImpl(prefix, body, suffix, nullptr);
+}
+
+void WriteQueue::Send(
+    std::string_view prefix, std::string &&body, std::string_view suffix) {
+  SendImpl(prefix, body, suffix, &body);
+}
+
+void WriteQueue::SendImpl(
+    std::string_view prefix, const std::string &body,
+    std::string_view suffix, std::string *movable_body) {
+  if (prefix.size() > kMaxPrefixSize) {
+    throw std::invalid_argument("Message prefix is too long");
+  }
+  std::size_t size = prefix.size() + body.size() + suffix.size();
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    ThrowIfUnusableLocked();
+    if (!writing_) {
+      break;
+    }
+    // A message larger than the limit is still accepted into an empty queue.
+    if (queued_bytes_ == 0 ||
+        queued_bytes_ + size <= options_.max_queued_bytes) {
+      EnqueueBehindWriterLocked(
+          lock, prefix,
+          movable_body != nullptr ? std::move(*movable_body) : body, suffix);
+      return;
+    }
+    space_cv_.wait(lock);
+  }
+
+  // The queue is empty whenever no one is writing, so this message goes
+  // first and is written without being copied.
+  writing_ = true;
+  lock.unlock();
+  try {
+    std::vector<asio::const_buffer> buffers;
+    buffers.emplace_back(prefix.data(), prefix.size());
+    buffers.emplace_back(body.data(), body.size());
+    buffers.emplace_back(suffix.data(), suffix.size());
+    writer_(buffers);
+  } catch (...) {
+    lock.lock();
+    auto dropped = FailLocked(std::current_exception());
+    asio::error_code ec = ToErrorCode(error_);
+    lock.unlock();
+    NotifyWritten(dropped, ec);
+    throw;
+  }
+  lock.lock();
+  ReleaseWriterLocked(lock);
+}
+
+void WriteQueue::AsyncSend(
+    std::string_view prefix, std::string body, std::string_view suffix,
+    Handler handler) {
+  if (!async_writer_) {
+    throw std::logic_error("Write queue does not support asynchronous sends");
+  }
+  if (prefix.size() > kMaxPrefixSize) {
+    throw std::invalid_argument("Message prefix is too long");
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (error_ || closed_) {
+    asio::error_code ec =
+        error_ ? ToErrorCode(error_) : asio::error::operation_aborted;
+    lock.unlock();
+    handler(ec);
+    return;
+  }
+  EnqueueLocked(prefix, std::move(body), suffix).handler = std::move(handler);
+  if (writing_) {
+    return;
+  }
+  writing_ = true;
+  async_writing_ = true;
+  WriteNextAsyncLocked(lock);
+}
+
+auto WriteQueue::EnqueueLocked(
+    std::string_view prefix, std::string body, std::string_view suffix)
+    -> Entry & {
+  Entry &entry = queue_.emplace_back();
+  std::copy(prefix.begin(), prefix.end(), entry.prefix.begin());
+  entry.prefix_size = prefix.size();
+  entry.body = std::move(body);
+  entry.suffix = suffix;
+  queued_bytes_ += entry.Size();
+  return entry;
+}
+
+void WriteQueue::EnqueueBehindWriterLocked(
+    std::unique_lock<std::mutex> &lock, std::string_view prefix,
+    std::string body, std::string_view suffix) {
+  EnqueueLocked(prefix, std::move(body), suffix);
+  // An asynchronous chain drains the whole queue, and a sender already
+  // waiting for the writer role takes this message along.
+  if (async_writing_ || successors_ > handoffs_) {
+    return;
+  }
+
+  std::uint64_t ticket = ++successors_;
+  space_cv_.wait(lock, [this, ticket]() {
+    return handoffs_ >= ticket || error_ != nullptr;
+  });
+  if (handoffs_ < ticket) {
+    // The writer failed and dropped this message with the rest.
+    std::rethrow_exception(error_);
+  }
+  DrainLocked(lock, handoff_count_);
+}
+
+void WriteQueue::TakeBatchLocked(
+    std::vector<Entry> &batch, std::size_t limit) {
+  std::size_t batch_bytes = 0;
+  batch.clear();
+  do {
+    batch_bytes += queue_.front().Size();
+    batch.push_back(std::move(queue_.front()));
+    queue_.pop_front();
+  } while (!queue_.empty() && batch.size() < limit &&
+           batch_bytes < options_.max_write_bytes);
+  queued_bytes_ -= batch_bytes;
+  space_cv_.notify_all();
+}
+
+void WriteQueue::DrainLocked(
+    std::unique_lock<std::mutex> &lock, std::size_t count) {
+  std::vector<Entry> batch;
+  std::vector<asio::const_buffer> buffers;
+
+  while (count > 0) {
+    TakeBatchLocked(batch, count);
+    count -= batch.size();
+
+    lock.unlock();
+    try {
+      buffers.clear();
+      for (const auto &entry : batch) {
+        entry.AppendBuffers(buffers);
+      }
+      writer_(buffers);
+    } catch (...) {
+      lock.lock();
+      auto dropped = FailLocked(std::current_exception());
+      asio::error_code ec = ToErrorCode(error_);
+      lock.unlock();
+      NotifyWritten(batch, ec);
+      NotifyWritten(dropped, ec);
+      lock.lock();
+      throw;
+    }
+    NotifyWritten(batch, {});
+    lock.lock();
+  }
+
+  ReleaseWriterLocked(lock);
+}
+
+void WriteQueue::ReleaseWriterLocked(std::unique_lock<std::mutex> &lock) {
+  if (queue_.empty()) {
+    writing_ = false;
+    space_cv_.notify_all();
+    return;
+  }
+  if (successors_ > handoffs_) {
+    handoff_count_ = queue_.size();
+    handoffs_++;
+    space_cv_.notify_all();
+    return;
+  }
+  // No sender is waiting, so only asynchronous sends were queued meanwhile.
+  async_writing_ = true;
+  WriteNextAsyncLocked(lock);
+  lock.lock();
+}
+
+void WriteQueue::WriteNextAsyncLocked(std::unique_lock<std::mutex> &lock) {
+  if (queue_.empty()) {
+    writing_ = false;
+    async_writing_ = false;
+    space_cv_.notify_all();
+    lock.unlock();
+    return;
+  }
+
+  TakeBatchLocked(in_flight_, queue_.size());
+  in_flight_buffers_.clear();
+  for (const auto &entry : in_flight_) {
+    entry.AppendBuffers(in_flight_buffers_);
+  }
+  lock.unlock();
+  async_writer_(in_flight_buffers_, [this](const asio::error_code &ec) {
+    OnAsyncWriteDone(ec);
+  });
+}
+
+void WriteQueue::OnAsyncWriteDone(const asio::error_code &ec) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  std::vector<Entry> written = std::move(in_flight_);
+  in_flight_.clear();
+
+  if (ec) {
+    auto dropped = FailLocked(
+        std::make_exception_ptr(asio::system_error(ec, "Async write failed")));
+    lock.unlock();
+    NotifyWritten(written, ec);
+    NotifyWritten(dropped, ec);
+    return;
+  }
+
+  WriteNextAsyncLocked(lock);
+  NotifyWritten(written, {});
+}
+
+auto WriteQueue::FailLocked(std::exception_ptr error) -> std::vector<Entry> {
+  if (!queue_.empty()) {
+    spdlog::error(
+        "Dropping {} queued messages after a failed write", queue_.size());
+  }
+  error_ = std::move(error);
+  std::vector<Entry> dropped(
+      std::make_move_iterator(queue_.begin()),
+      std::make_move_iterator(queue_.end()));
+  queue_.clear();
+  queued_bytes_ = 0;
+  writing_ = false;
+  async_writing_ = false;
+  space_cv_.notify_all();
+  return dropped;
+}
+
+void WriteQueue::NotifyWritten(
+    std::vector<Entry> &entries, const asio::error_code &ec) {
+  for (auto &entry : entries) {
+    if (entry.handler) {
+      entry.handler(ec);
+    }
+  }
+}
+
+auto WriteQueue::ToErrorCode(const std::exception_ptr &error)
+    -> asio::error_code {
+  try {
+    std::rethrow_exception(error);
+  } catch (const asio::system_error &e) {
+    return e.code();
+  } catch (...) {
+    return asio::error::fault;
+  }
+}
+
+void WriteQueue::ThrowIfUnusableLocked() const {
+  if (error_) {
+    std::rethrow_exception(error_);
+  }
+  if (closed_) {
+    throw std::runtime_error("Write queue is closed");
+  }
+}
+
+void WriteQueue::Close() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  closed_ = true;
+  space_cv_.notify_all();
+}
+
+auto WriteQueue::GetQueuedBytes() const -> std::size_t {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return queued_bytes_;
+}
+
+}  // namespace jsonrpc::transport
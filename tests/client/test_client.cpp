@@ -1,3 +1,7 @@
+#include <atomic>
+#include <coroutine>
+#include <exception>
+
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_string.hpp>
 #include <fmt/core.h>
@@ -5,6 +9,80 @@
 
 #include "../common/mock_transport.hpp"
 #include "jsonrpc/client/client.hpp"
+#include "jsonrpc/transport/pipe_transport.hpp"
+
+using jsonrpc::transport::PipeTransport;
+using PipePair =
+    std::pair<std::unique_ptr<PipeTransport>, std::unique_ptr<PipeTransport>>;
+
+// Helper function to create a connected server and client PipeTransport pair
+auto CreatePipePair(const std::string &socket_path) -> PipePair {
+  std::unique_ptr<PipeTransport> server_transport;
+  std::thread server_thread([&]() {
+    server_transport = std::make_unique<PipeTransport>(socket_path, true);
+  });
+
+  // Give the server some time to start
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  auto client_transport = std::make_unique<PipeTransport>(socket_path, false);
+  server_thread.join();
+  return {std::move(server_transport), std::move(client_transport)};
+}
+
+// Minimal fire-and-forget coroutine type for driving awaitable calls
+struct DetachedCoroutine {
+  struct promise_type {
+    auto get_return_object() -> DetachedCoroutine {
+      return {};
+    }
+    auto initial_suspend() noexcept -> std::suspend_never {
+      return {};
+    }
+    auto final_suspend() noexcept -> std::suspend_never {
+      return {};
+    }
+    void return_void() {
+    }
+    void unhandled_exception() {
+      std::terminate();
+    }
+  };
+};
+
+// Executor that runs tasks inline and counts them
+class CountingExecutor : public jsonrpc::executor::Executor {
+ public:
+  void Execute(jsonrpc::executor::Task task) override {
+    count++;
+    task();
+  }
+
+  std::atomic<int> count{0};
+};
+
+auto SumTwoCalls(
+    jsonrpc::client::Client &client,
+    std::shared_ptr<jsonrpc::executor::Executor> executor,
+    std::promise<int> &sum) -> DetachedCoroutine {
+  nlohmann::json params = nlohmann::json::array();
+  params.push_back(1);
+  auto first = co_await client.Call("first", params);
+  auto second = co_await client.Call("second", std::nullopt, executor);
+  sum.set_value(first["result"].get<int>() + second["result"].get<int>());
+}
+
+auto AwaitTimeout(
+    jsonrpc::client::Client &client,
+    std::promise<bool> &timed_out) -> DetachedCoroutine {
+  try {
+    co_await client.Call(
+        "never_answered", std::nullopt, nullptr, std::chrono::milliseconds(5));
+    timed_out.set_value(false);
+  } catch (const jsonrpc::client::TimeoutError &) {
+    timed_out.set_value(true);
+  }
+}
 
 TEST_CASE("Client starts and stops correctly", "[Client]") {
   auto transport = std::make_unique<MockTransport>();
@@ -158,3 +236,493 @@ TEST_CASE(
 
   client.Stop();
 }
+
+TEST_CASE("Client listener stops promptly while idle", "[Client]") {
+  auto [server_transport, client_transport] =
+      CreatePipePair("/tmp/test_client_idle_socket");
+
+  jsonrpc::client::Client client(std::move(client_transport));
+  client.Start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  auto start = std::chrono::steady_clock::now();
+  client.Stop();
+  auto elapsed = std::chrono::steady_clock::now() - start;
+
+  REQUIRE(client.IsRunning() == false);
+  REQUIRE(elapsed < std::chrono::seconds(1));
+}
+
+TEST_CASE("Client ignores unsolicited messages", "[Client]") {
+  auto [server_transport, client_transport] =
+      CreatePipePair("/tmp/test_client_unsolicited_socket");
+
+  jsonrpc::client::Client client(std::move(client_transport));
+  client.Start();
+
+  server_transport->SendMessage(
+      R"({"jsonrpc":"2.0","method":"window/logMessage","params":{}})");
+  server_transport->SendMessage("not json");
+
+  auto future_response = client.SendMethodCallAsync("ping");
+  auto request = nlohmann::json::parse(server_transport->ReceiveMessage());
+  nlohmann::json response = {
+      {"jsonrpc", "2.0"}, {"result", "pong"}, {"id", request["id"]}};
+  server_transport->SendMessage(response.dump());
+
+  REQUIRE(
+      future_response.wait_for(std::chrono::seconds(1)) ==
+      std::future_status::ready);
+  REQUIRE(future_response.get()["result"] == "pong");
+
+  client.Stop();
+}
+
+TEST_CASE(
+    "Client fails pending requests when the transport closes", "[Client]") {
+  auto [server_transport, client_transport] =
+      CreatePipePair("/tmp/test_client_closed_socket");
+
+  jsonrpc::client::Client client(std::move(client_transport));
+  client.Start();
+
+  auto future_response = client.SendMethodCallAsync("never_answered");
+  server_transport.reset();
+
+  REQUIRE(
+      future_response.wait_for(std::chrono::seconds(1)) ==
+      std::future_status::ready);
+  REQUIRE_THROWS_AS(future_response.get(), std::runtime_error);
+  REQUIRE(client.HasPendingRequests() == false);
+
+  client.Stop();
+}
+
+TEST_CASE("Client sends a batch as a single message", "[Client][Batch]") {
+  auto transport = std::make_unique<MockTransport>();
+  MockTransport *transport_ptr = transport.get();
+
+  // Answer out of order to check that responses are routed by ID
+  transport_ptr->SetResponse(
+      R"([{"jsonrpc":"2.0","result":"second","id":1},)"
+      R"({"jsonrpc":"2.0","result":"first","id":0}])");
+
+  jsonrpc::client::Client client(std::move(transport));
+  client.Start();
+
+  jsonrpc::client::Batch batch;
+  auto first = batch.AddMethodCall("first", nlohmann::json::array({1}));
+  batch.AddNotification("notify_event");
+  auto second = batch.AddMethodCall("second");
+  REQUIRE(batch.Size() == 3);
+
+  client.SendBatch(std::move(batch));
+
+  REQUIRE(first.wait_for(std::chrono::seconds(1)) == std::future_status::ready);
+  REQUIRE(
+      second.wait_for(std::chrono::seconds(1)) == std::future_status::ready);
+  REQUIRE(first.get()["result"] == "first");
+  REQUIRE(second.get()["result"] == "second");
+  REQUIRE(client.HasPendingRequests() == false);
+
+  REQUIRE(transport_ptr->sent_requests.size() == 1);
+  auto sent = nlohmann::json::parse(transport_ptr->sent_requests[0]);
+  REQUIRE(sent.is_array());
+  REQUIRE(sent.size() == 3);
+  REQUIRE(sent[0]["method"] == "first");
+  REQUIRE(sent[0]["id"] == 0);
+  REQUIRE(sent[1]["method"] == "notify_event");
+  REQUIRE(sent[1].contains("id") == false);
+  REQUIRE(sent[2]["method"] == "second");
+  REQUIRE(sent[2]["id"] == 1);
+
+  client.Stop();
+}
+
+TEST_CASE(
+    "Client fails batch calls missing from the response", "[Client][Batch]") {
+  auto transport = std::make_unique<MockTransport>();
+  transport->SetResponse(R"([{"jsonrpc":"2.0","result":"ok","id":0}])");
+
+  jsonrpc::client::Client client(std::move(transport));
+  client.Start();
+
+  jsonrpc::client::Batch batch;
+  auto answered = batch.AddMethodCall("answered");
+  auto missing = batch.AddMethodCall("missing");
+  client.SendBatch(std::move(batch));
+
+  REQUIRE(
+      answered.wait_for(std::chrono::seconds(1)) == std::future_status::ready);
+  REQUIRE(
+      missing.wait_for(std::chrono::seconds(1)) == std::future_status::ready);
+  REQUIRE(answered.get()["result"] == "ok");
+  REQUIRE_THROWS_AS(missing.get(), std::runtime_error);
+  REQUIRE(client.HasPendingRequests() == false);
+  REQUIRE(client.GetPendingBatchCount() == 0);
+
+  client.Stop();
+}
+
+TEST_CASE(
+    "Client fails a batch rejected with a single error", "[Client][Batch]") {
+  const std::string rejection =
+      R"({"jsonrpc":"2.0","error":{"code":-32600,)"
+      R"("message":"Invalid Request"},"id":null})";
+  auto transport = std::make_unique<MockTransport>();
+  transport->SetResponse(rejection);
+
+  jsonrpc::client::Client client(std::move(transport));
+  client.Start();
+
+  jsonrpc::client::Batch batch;
+  auto first = batch.AddMethodCall("first");
+  auto second = batch.AddMethodCall("second");
+  client.SendBatch(std::move(batch));
+
+  REQUIRE(first.wait_for(std::chrono::seconds(1)) == std::future_status::ready);
+  REQUIRE(
+      second.wait_for(std::chrono::seconds(1)) == std::future_status::ready);
+  REQUIRE_THROWS_WITH(
+      first.get(), "Batch rejected by the server: " + rejection);
+  REQUIRE_THROWS_AS(second.get(), std::runtime_error);
+  REQUIRE(client.HasPendingRequests() == false);
+  REQUIRE(client.GetPendingBatchCount() == 0);
+
+  client.Stop();
+}
+
+TEST_CASE(
+    "Client keeps a batch when a single call is answered with a null ID",
+    "[Client][Batch]") {
+  auto transport = std::make_unique<MockTransport>();
+  MockTransport *transport_ptr = transport.get();
+
+  jsonrpc::client::Client client(std::move(transport));
+  client.Start();
+
+  jsonrpc::client::Batch batch;
+  auto first = batch.AddMethodCall("first");
+  auto second = batch.AddMethodCall("second");
+  client.SendBatch(std::move(batch));
+  auto single = client.SendMethodCallAsync("single");
+
+  // The error may be meant for the single call, so it must not reject the
+  // batch, which is answered afterwards.
+  transport_ptr->SetResponse(
+      R"({"jsonrpc":"2.0","error":{"code":-32600,)"
+      R"("message":"Invalid Request"},"id":null})");
+  transport_ptr->SetResponse(
+      R"([{"jsonrpc":"2.0","result":"first","id":0},)"
+      R"({"jsonrpc":"2.0","result":"second","id":1}])");
+
+  REQUIRE(first.wait_for(std::chrono::seconds(1)) == std::future_status::ready);
+  REQUIRE(
+      second.wait_for(std::chrono::seconds(1)) == std::future_status::ready);
+  REQUIRE(first.get()["result"] == "first");
+  REQUIRE(second.get()["result"] == "second");
+  REQUIRE(client.GetPendingBatchCount() == 0);
+
+  client.Stop();
+  REQUIRE_THROWS_AS(single.get(), std::runtime_error);
+}
+
+TEST_CASE("Client forgets a batch whose calls time out", "[Client][Batch]") {
+  auto transport = std::make_unique<MockTransport>();
+
+  jsonrpc::client::ClientOptions options;
+  options.default_timeout = std::chrono::milliseconds(5);
+  options.timer_wheel = std::make_shared<jsonrpc::client::TimerWheel>(
+      std::chrono::milliseconds(1));
+
+  jsonrpc::client::Client client(std::move(transport), options);
+  client.Start();
+
+  jsonrpc::client::Batch batch;
+  auto first = batch.AddMethodCall("first");
+  auto second = batch.AddMethodCall("second");
+  client.SendBatch(std::move(batch));
+  REQUIRE(client.GetPendingBatchCount() == 1);
+
+  REQUIRE_THROWS_AS(first.get(), jsonrpc::client::TimeoutError);
+  REQUIRE_THROWS_AS(second.get(), jsonrpc::client::TimeoutError);
+  REQUIRE(client.HasPendingRequests() == false);
+  REQUIRE(client.GetPendingBatchCount() == 0);
+
+  client.Stop();
+}
+
+TEST_CASE("Client fails batch calls when sending fails", "[Client][Batch]") {
+  class FailingTransport : public MockTransport {
+   public:
+    using MockTransport::SendMessage;
+
+    void SendMessage(const std::string & /*request*/) override {
+      throw std::runtime_error("Send failed");
+    }
+  };
+
+  jsonrpc::client::Client client(std::make_unique<FailingTransport>());
+
+  jsonrpc::client::Batch batch;
+  auto call = batch.AddMethodCall("call");
+  REQUIRE_THROWS_WITH(client.SendBatch(std::move(batch)), "Send failed");
+
+  REQUIRE(call.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+  REQUIRE_THROWS_WITH(call.get(), "Send failed");
+  REQUIRE(client.HasPendingRequests() == false);
+  REQUIRE(client.GetPendingBatchCount() == 0);
+}
+
+TEST_CASE("Client forgets a call whose send fails", "[Client]") {
+  class FailingTransport : public MockTransport {
+   public:
+    using MockTransport::SendMessage;
+
+    void SendMessage(const std::string & /*request*/) override {
+      throw std::runtime_error("Send failed");
+    }
+  };
+
+  jsonrpc::client::Client client(std::make_unique<FailingTransport>());
+
+  REQUIRE_THROWS_WITH(client.SendMethodCallAsync("call"), "Send failed");
+  REQUIRE_THROWS_WITH(client.SendMethodCall("call"), "Send failed");
+  REQUIRE(client.GetPendingRequestCount() == 0);
+}
+
+TEST_CASE("Client ignores an empty batch", "[Client][Batch]") {
+  auto transport = std::make_unique<MockTransport>();
+  MockTransport *transport_ptr = transport.get();
+
+  jsonrpc::client::Client client(std::move(transport));
+  client.Start();
+
+  client.SendBatch(jsonrpc::client::Batch());
+  REQUIRE(transport_ptr->sent_requests.empty());
+
+  client.Stop();
+}
+
+TEST_CASE(
+    "Client coalesces calls when auto-batching is enabled",
+    "[Client][AutoBatch]") {
+  auto transport = std::make_unique<MockTransport>();
+  MockTransport *transport_ptr = transport.get();
+  transport_ptr->SetResponse(
+      R"([{"jsonrpc":"2.0","result":"a","id":0},)"
+      R"({"jsonrpc":"2.0","result":"b","id":1}])");
+
+  jsonrpc::client::ClientOptions options;
+  options.auto_batch.enabled = true;
+  options.auto_batch.window = std::chrono::seconds(10);
+  options.auto_batch.max_messages = 3;
+
+  jsonrpc::client::Client client(std::move(transport), options);
+  client.Start();
+
+  auto first = client.SendMethodCallAsync("a");
+  client.SendNotification("notify_event");
+  REQUIRE(transport_ptr->sent_requests.empty());
+  auto second = client.SendMethodCallAsync("b");
+
+  REQUIRE(first.wait_for(std::chrono::seconds(1)) == std::future_status::ready);
+  REQUIRE(
+      second.wait_for(std::chrono::seconds(1)) == std::future_status::ready);
+  REQUIRE(first.get()["result"] == "a");
+  REQUIRE(second.get()["result"] == "b");
+
+  REQUIRE(transport_ptr->sent_requests.size() == 1);
+  auto sent = nlohmann::json::parse(transport_ptr->sent_requests[0]);
+  REQUIRE(sent.is_array());
+  REQUIRE(sent.size() == 3);
+  REQUIRE(sent[1]["method"] == "notify_event");
+
+  client.Stop();
+}
+
+TEST_CASE(
+    "Client sends a lone auto-batched call after the window",
+    "[Client][AutoBatch]") {
+  auto transport = std::make_unique<MockTransport>();
+  MockTransport *transport_ptr = transport.get();
+  transport_ptr->SetResponse(R"({"jsonrpc":"2.0","result":"ok","id":0})");
+
+  jsonrpc::client::ClientOptions options;
+  options.auto_batch.enabled = true;
+  options.auto_batch.window = std::chrono::milliseconds(5);
+
+  jsonrpc::client::Client client(std::move(transport), options);
+  client.Start();
+
+  auto response = client.SendMethodCall("single");
+  REQUIRE(response["result"] == "ok");
+
+  // A single buffered message is sent on its own, not as a batch
+  REQUIRE(transport_ptr->sent_requests.size() == 1);
+  auto sent = nlohmann::json::parse(transport_ptr->sent_requests[0]);
+  REQUIRE(sent.is_object());
+  REQUIRE(sent["method"] == "single");
+
+  client.Stop();
+}
+
+TEST_CASE(
+    "Client sends buffered messages when stopped", "[Client][AutoBatch]") {
+  auto transport = std::make_unique<MockTransport>();
+  MockTransport *transport_ptr = transport.get();
+
+  jsonrpc::client::ClientOptions options;
+  options.auto_batch.enabled = true;
+  options.auto_batch.window = std::chrono::seconds(10);
+
+  jsonrpc::client::Client client(std::move(transport), options);
+  client.Start();
+
+  client.SendNotification("first");
+  client.SendNotification("second");
+  REQUIRE(transport_ptr->sent_requests.empty());
+
+  client.Stop();
+  REQUIRE(transport_ptr->sent_requests.size() == 1);
+  REQUIRE(nlohmann::json::parse(transport_ptr->sent_requests[0]).size() == 2);
+}
+
+TEST_CASE("Client fails calls that time out", "[Client][Timeout]") {
+  auto transport = std::make_unique<MockTransport>();
+
+  jsonrpc::client::ClientOptions options;
+  options.default_timeout = std::chrono::milliseconds(20);
+  options.timer_wheel = std::make_shared<jsonrpc::client::TimerWheel>(
+      std::chrono::milliseconds(1));
+
+  jsonrpc::client::Client client(std::move(transport), options);
+  client.Start();
+
+  REQUIRE_THROWS_AS(
+      client.SendMethodCall("never_answered"),
+      jsonrpc::client::TimeoutError);
+  REQUIRE(client.HasPendingRequests() == false);
+
+  // A per-call timeout overrides the default
+  auto future = client.SendMethodCallAsync(
+      "slow", std::nullopt, std::chrono::milliseconds(5));
+  REQUIRE(
+      future.wait_for(std::chrono::seconds(1)) == std::future_status::ready);
+  REQUIRE_THROWS_AS(future.get(), jsonrpc::client::TimeoutError);
+
+  client.Stop();
+}
+
+TEST_CASE("Client discards responses that arrive late", "[Client][Timeout]") {
+  auto transport = std::make_unique<MockTransport>();
+  MockTransport *transport_ptr = transport.get();
+
+  jsonrpc::client::ClientOptions options;
+  options.timer_wheel = std::make_shared<jsonrpc::client::TimerWheel>(
+      std::chrono::milliseconds(1));
+
+  jsonrpc::client::Client client(std::move(transport), options);
+  client.Start();
+
+  auto late = client.SendMethodCallAsync(
+      "late", std::nullopt, std::chrono::milliseconds(5));
+  REQUIRE_THROWS_AS(late.get(), jsonrpc::client::TimeoutError);
+
+  // The late response is dropped and does not disturb the next call
+  transport_ptr->SetResponse(R"({"jsonrpc":"2.0","result":"late","id":0})");
+  transport_ptr->SetResponse(R"({"jsonrpc":"2.0","result":"ok","id":1})");
+  auto response = client.SendMethodCall("next");
+  REQUIRE(response["result"] == "ok");
+
+  client.Stop();
+}
+
+TEST_CASE("Client supports awaitable calls", "[Client][Coroutine]") {
+  auto transport = std::make_unique<MockTransport>();
+  MockTransport *transport_ptr = transport.get();
+  transport_ptr->SetResponse(R"({"jsonrpc":"2.0","result":1,"id":0})");
+  transport_ptr->SetResponse(R"({"jsonrpc":"2.0","result":2,"id":1})");
+
+  jsonrpc::client::Client client(std::move(transport));
+  client.Start();
+
+  auto executor = std::make_shared<CountingExecutor>();
+  std::promise<int> sum;
+  SumTwoCalls(client, executor, sum);
+
+  auto future = sum.get_future();
+  REQUIRE(
+      future.wait_for(std::chrono::seconds(1)) == std::future_status::ready);
+  REQUIRE(future.get() == 3);
+  REQUIRE(executor->count == 1);
+  REQUIRE(transport_ptr->sent_requests.size() == 2);
+  REQUIRE(client.HasPendingRequests() == false);
+
+  client.Stop();
+}
+
+TEST_CASE(
+    "Client resumes awaitable calls with their error", "[Client][Coroutine]") {
+  auto transport = std::make_unique<MockTransport>();
+
+  jsonrpc::client::ClientOptions options;
+  options.timer_wheel = std::make_shared<jsonrpc::client::TimerWheel>(
+      std::chrono::milliseconds(1));
+
+  jsonrpc::client::Client client(std::move(transport), options);
+  client.Start();
+
+  std::promise<bool> timed_out;
+  AwaitTimeout(client, timed_out);
+
+  auto future = timed_out.get_future();
+  REQUIRE(
+      future.wait_for(std::chrono::seconds(1)) == std::future_status::ready);
+  REQUIRE(future.get());
+  REQUIRE(client.HasPendingRequests() == false);
+
+  client.Stop();
+}
+
+TEST_CASE("Client sends calls to prepared methods", "[Client]") {
+  auto transport = std::make_unique<MockTransport>();
+  MockTransport *transport_ptr = transport.get();
+  transport_ptr->SetResponse(R"({"jsonrpc":"2.0","result":5,"id":0})");
+
+  jsonrpc::client::Client client(std::move(transport));
+  client.Start();
+
+  jsonrpc::client::PreparedMethod add("add");
+  auto response = client.SendMethodCall(add, nlohmann::json::array({2, 3}));
+  REQUIRE(response["result"] == 5);
+  client.SendNotification(add);
+
+  REQUIRE(transport_ptr->sent_requests.size() == 2);
+  REQUIRE(
+      transport_ptr->sent_requests[0] ==
+      R"({"jsonrpc":"2.0","method":"add","params":[2,3],"id":0})");
+  REQUIRE(
+      transport_ptr->sent_requests[1] == R"({"jsonrpc":"2.0","method":"add"})");
+
+  client.Stop();
+}
+
+TEST_CASE("Client delivers unparsed responses on request", "[Client]") {
+  auto transport = std::make_unique<MockTransport>();
+  transport->SetResponse(
+      R"({"jsonrpc":"2.0","result":{"rows":[1,2,3]},"id":0})");
+
+  jsonrpc::client::Client client(std::move(transport));
+  client.Start();
+
+  auto future = client.SendMethodCallRaw("query");
+  REQUIRE(
+      future.wait_for(std::chrono::seconds(1)) == std::future_status::ready);
+  auto response = future.get();
+  REQUIRE(response.GetId() == 0);
+  REQUIRE(response.GetRawValue() == R"({"rows":[1,2,3]})");
+  REQUIRE(response.GetResult()["rows"].size() == 3);
+
+  client.Stop();
+}
@@ -0,0 +1,165 @@
+#include <chrono>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <nlohmann/json.hpp>
+
+#include "../common/mock_transport.hpp"
+#include "jsonrpc/client/client_pool.hpp"
+
+using jsonrpc::client::ClientPool;
+using jsonrpc::client::ClientPoolOptions;
+using jsonrpc::client::LoadBalancing;
+
+namespace {
+
+auto CreateTransports(std::size_t count, std::vector<MockTransport *> &mocks)
+    -> std::vector<std::unique_ptr<jsonrpc::transport::Transport>> {
+  std::vector<std::unique_ptr<jsonrpc::transport::Transport>> transports;
+  for (std::size_t i = 0; i < count; ++i) {
+    auto transport = std::make_unique<MockTransport>();
+    mocks.push_back(transport.get());
+    transports.push_back(std::move(transport));
+  }
+  return transports;
+}
+
+}  // namespace
+
+TEST_CASE("ClientPool requires a transport", "[ClientPool]") {
+  REQUIRE_THROWS_AS(
+      ClientPool(
+          std::vector<std::unique_ptr<jsonrpc::transport::Transport>>()),
+      std::invalid_argument);
+}
+
+TEST_CASE("ClientPool spreads calls round-robin", "[ClientPool]") {
+  std::vector<MockTransport *> mocks;
+  ClientPool pool(CreateTransports(3, mocks));
+  pool.Start();
+  REQUIRE(pool.Size() == 3);
+
+  for (int i = 0; i < 6; ++i) {
+    pool.SendNotification("notify_event");
+  }
+  for (auto *mock : mocks) {
+    REQUIRE(mock->sent_requests.size() == 2);
+  }
+
+  pool.Stop();
+}
+
+TEST_CASE("ClientPool matches responses per connection", "[ClientPool]") {
+  std::vector<MockTransport *> mocks;
+  ClientPool pool(CreateTransports(2, mocks));
+  // Each connection numbers its own requests, so both answer ID 0
+  mocks[0]->SetResponse(R"({"jsonrpc":"2.0","result":"first","id":0})");
+  mocks[1]->SetResponse(R"({"jsonrpc":"2.0","result":"second","id":0})");
+  pool.Start();
+
+  REQUIRE(pool.SendMethodCall("call")["result"] == "first");
+  REQUIRE(pool.SendMethodCall("call")["result"] == "second");
+  REQUIRE(pool.HasPendingRequests() == false);
+
+  pool.Stop();
+}
+
+TEST_CASE(
+    "ClientPool avoids busy connections when balancing by load",
+    "[ClientPool]") {
+  for (auto policy :
+       {LoadBalancing::kLeastOutstanding, LoadBalancing::kPowerOfTwoChoices}) {
+    std::vector<MockTransport *> mocks;
+    ClientPoolOptions options;
+    options.load_balancing = policy;
+    ClientPool pool(CreateTransports(2, mocks), options);
+    pool.Start();
+
+    // One call stays unanswered and pins its connection as busy
+    auto pending = pool.SendMethodCallAsync("never_answered");
+    std::size_t busy = mocks[0]->sent_requests.empty() ? 1 : 0;
+    std::size_t idle = 1 - busy;
+
+    for (int i = 0; i < 4; ++i) {
+      pool.SendNotification("notify_event");
+    }
+    REQUIRE(mocks[busy]->sent_requests.size() == 1);
+    REQUIRE(mocks[idle]->sent_requests.size() == 4);
+
+    pool.Stop();
+    REQUIRE_THROWS_AS(pending.get(), std::runtime_error);
+  }
+}
+
+TEST_CASE("RetryBudget limits extra attempts", "[ClientPool][Hedging]") {
+  jsonrpc::client::RetryBudget budget(0.5, 2);
+
+  REQUIRE(budget.TryWithdraw());
+  REQUIRE(budget.TryWithdraw());
+  REQUIRE_FALSE(budget.TryWithdraw());
+
+  budget.Deposit();
+  REQUIRE_FALSE(budget.TryWithdraw());
+  budget.Deposit();
+  REQUIRE(budget.TryWithdraw());
+}
+
+TEST_CASE("LatencyTracker reports a percentile", "[ClientPool][Hedging]") {
+  jsonrpc::client::LatencyTracker tracker(0.9);
+  REQUIRE_FALSE(tracker.Get().has_value());
+
+  for (int i = 1; i <= 100; ++i) {
+    tracker.Record(std::chrono::microseconds(i));
+  }
+  // The percentile is refreshed every 32 samples, last at the 96th
+  REQUIRE(tracker.Get() == std::chrono::microseconds(87));
+}
+
+TEST_CASE("ClientPool hedges slow idempotent calls", "[ClientPool][Hedging]") {
+  std::vector<MockTransport *> mocks;
+  ClientPoolOptions options;
+  options.hedging.idempotent_methods = {"get"};
+  options.hedging.initial_hedge_delay = std::chrono::milliseconds(5);
+  ClientPool pool(CreateTransports(2, mocks), options);
+  // Only the second connection answers
+  mocks[1]->SetResponse(R"({"jsonrpc":"2.0","result":"fast","id":0})");
+  pool.Start();
+
+  REQUIRE(pool.SendMethodCall("get")["result"] == "fast");
+  REQUIRE(mocks[0]->sent_requests.size() == 1);
+  REQUIRE(mocks[1]->sent_requests.size() == 1);
+  // The slow attempt is abandoned once the hedge wins
+  REQUIRE(pool.HasPendingRequests() == false);
+
+  pool.Stop();
+}
+
+TEST_CASE(
+    "ClientPool retries failed idempotent calls", "[ClientPool][Hedging]") {
+  std::vector<MockTransport *> mocks;
+  ClientPoolOptions options;
+  options.client.default_timeout = std::chrono::milliseconds(5);
+  options.client.timer_wheel = std::make_shared<jsonrpc::client::TimerWheel>(
+      std::chrono::milliseconds(1));
+  options.hedging.idempotent_methods = {"get"};
+  options.hedging.hedge = false;
+  ClientPool pool(CreateTransports(2, mocks), options);
+  mocks[1]->SetResponse(R"({"jsonrpc":"2.0","result":"retried","id":0})");
+  pool.Start();
+
+  // The first attempt times out and is retried on the other connection
+  REQUIRE(pool.SendMethodCall("get")["result"] == "retried");
+
+  REQUIRE(mocks[0]->sent_requests.size() == 1);
+  REQUIRE(mocks[1]->sent_requests.size() == 1);
+
+  // Methods that are not idempotent are sent once
+  REQUIRE_THROWS_AS(
+      pool.SendMethodCall("set"), jsonrpc::client::TimeoutError);
+  REQUIRE(mocks[0]->sent_requests.size() == 2);
+  REQUIRE(mocks[1]->sent_requests.size() == 1);
+
+  pool.Stop();
+}
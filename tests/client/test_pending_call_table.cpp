@@ -0,0 +1,154 @@
+#include <future>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <nlohmann/json.hpp>
+
+#include "jsonrpc/client/pending_call_table.hpp"
+
+using jsonrpc::client::PendingCallTable;
+using jsonrpc::client::RawResponse;
+
+namespace {
+
+auto MakeResponse(int id, const nlohmann::json &result) -> RawResponse {
+  return RawResponse::Scan(
+      nlohmann::json{{"jsonrpc", "2.0"}, {"id", id}, {"result", result}}
+          .dump());
+}
+
+}  // namespace
+
+TEST_CASE(
+    "PendingCallTable completes a registered call", "[PendingCallTable]") {
+  PendingCallTable table;
+  REQUIRE(table.IsEmpty());
+
+  PendingCallTable::Promise promise;
+  auto future = promise.get_future();
+  table.Add(7, std::move(promise));
+  REQUIRE(table.Size() == 1);
+
+  REQUIRE(table.Complete(7, MakeResponse(7, 42)));
+  REQUIRE(table.IsEmpty());
+  REQUIRE(future.get()["result"] == 42);
+}
+
+TEST_CASE("PendingCallTable rejects unknown IDs", "[PendingCallTable]") {
+  PendingCallTable table;
+
+  REQUIRE_FALSE(table.Complete(3, MakeResponse(3, nullptr)));
+  REQUIRE_FALSE(table.Complete(-1, MakeResponse(-1, nullptr)));
+
+  table.Add(3, PendingCallTable::Promise());
+  REQUIRE(table.Complete(3, MakeResponse(3, nullptr)));
+  REQUIRE_FALSE(table.Complete(3, MakeResponse(3, nullptr)));
+}
+
+TEST_CASE(
+    "PendingCallTable handles IDs that wrap onto occupied slots",
+    "[PendingCallTable]") {
+  PendingCallTable table(2);
+
+  std::vector<std::future<nlohmann::json>> futures;
+  for (int id = 0; id < 5; ++id) {
+    PendingCallTable::Promise promise;
+    futures.push_back(promise.get_future());
+    table.Add(id, std::move(promise));
+  }
+  REQUIRE(table.Size() == 5);
+
+  for (int id = 4; id >= 0; --id) {
+    REQUIRE(table.Complete(id, MakeResponse(id, id)));
+  }
+  REQUIRE(table.IsEmpty());
+
+  for (int id = 0; id < 5; ++id) {
+    REQUIRE(futures[id].get()["result"] == id);
+  }
+}
+
+TEST_CASE("PendingCallTable fails all pending calls", "[PendingCallTable]") {
+  PendingCallTable table(2);
+
+  std::vector<std::future<nlohmann::json>> futures;
+  for (int id = 0; id < 3; ++id) {
+    PendingCallTable::Promise promise;
+    futures.push_back(promise.get_future());
+    table.Add(id, std::move(promise));
+  }
+
+  table.FailAll("stopped");
+  REQUIRE(table.IsEmpty());
+  for (auto &future : futures) {
+    REQUIRE_THROWS_AS(future.get(), std::runtime_error);
+  }
+}
+
+TEST_CASE(
+    "PendingCallTable supports concurrent registration and completion",
+    "[PendingCallTable]") {
+  PendingCallTable table(64);
+  const int num_threads = 4;
+  const int calls_per_thread = 2000;
+
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads);
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&table, t]() {
+      for (int i = 0; i < calls_per_thread; ++i) {
+        int id = t * calls_per_thread + i;
+        PendingCallTable::Promise promise;
+        auto future = promise.get_future();
+        table.Add(id, std::move(promise));
+        table.Complete(id, MakeResponse(id, id));
+        if (future.get()["result"] != id) {
+          throw std::runtime_error("Mismatched response");
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  REQUIRE(table.IsEmpty());
+}
+
+TEST_CASE("PendingCallTable notifies call waiters", "[PendingCallTable]") {
+  class RecordingWaiter : public jsonrpc::client::CallWaiter {
+   public:
+    void OnResponse(RawResponse response) override {
+      this->response = std::move(response);
+    }
+    void OnError(std::exception_ptr error) override {
+      this->error = std::move(error);
+    }
+
+    std::optional<RawResponse> response;
+    std::exception_ptr error;
+  };
+
+  PendingCallTable table;
+  RecordingWaiter completed;
+  RecordingWaiter failed;
+  RecordingWaiter removed;
+  table.Add(1, &completed);
+  table.Add(2, &failed);
+  table.Add(3, &removed);
+
+  REQUIRE(table.Complete(1, MakeResponse(1, 42)));
+  REQUIRE(completed.response.has_value());
+  REQUIRE(completed.response->GetResult() == 42);
+
+  REQUIRE(table.Fail(
+      2, std::make_exception_ptr(std::runtime_error("failed"))));
+  REQUIRE(failed.error != nullptr);
+
+  REQUIRE(table.Remove(3));
+  REQUIRE_FALSE(table.Remove(3));
+  REQUIRE(removed.error == nullptr);
+  REQUIRE(table.IsEmpty());
+}
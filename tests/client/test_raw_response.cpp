@@ -0,0 +1,72 @@
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+#include <nlohmann/json.hpp>
+
+#include "jsonrpc/client/raw_response.hpp"
+
+using jsonrpc::client::RawResponse;
+
+TEST_CASE("RawResponse scans a result response", "[RawResponse]") {
+  auto response = RawResponse::Scan(
+      R"( {"result": {"items": [1, "}]", {"a": null}]}, "jsonrpc": "2.0",)"
+      R"( "id": 12} )");
+
+  REQUIRE(response.GetId() == 12);
+  REQUIRE_FALSE(response.IsError());
+  REQUIRE(response.GetRawValue() == R"({"items": [1, "}]", {"a": null}]})");
+  REQUIRE(response.GetResult()["items"][1] == "}]");
+  REQUIRE(response.ToJson()["id"] == 12);
+}
+
+TEST_CASE("RawResponse scans an error response", "[RawResponse]") {
+  auto response = RawResponse::Scan(
+      R"({"jsonrpc":"2.0","error":{"code":-32601,"message":"Not found"},)"
+      R"("id":"abc"})");
+
+  REQUIRE_FALSE(response.GetId().has_value());
+  REQUIRE(response.GetRawId() == R"("abc")");
+  REQUIRE(response.IsError());
+  REQUIRE(response.GetError()["code"] == -32601);
+  REQUIRE_THROWS_AS(response.GetResult(), std::runtime_error);
+}
+
+TEST_CASE("RawResponse rejects invalid responses", "[RawResponse]") {
+  const char *invalid[] = {
+      R"([])",
+      R"({})",
+      R"({"jsonrpc":"2.0","result":1})",
+      R"({"jsonrpc":"1.0","result":1,"id":1})",
+      R"({"jsonrpc":"2.0","id":1})",
+      R"({"jsonrpc":"2.0","result":1,"error":{},"id":1})",
+      R"({"jsonrpc":"2.0","error":{"code":"x","message":"m"},"id":1})",
+      R"({"jsonrpc":"2.0","result":"unterminated,"id":1})",
+      R"({"jsonrpc":"2.0","result":1,"id":1} trailing)",
+  };
+  for (const char *message : invalid) {
+    INFO(message);
+    REQUIRE_THROWS(RawResponse::Scan(message));
+  }
+}
+
+TEST_CASE("RawResponse splits a batch response", "[RawResponse]") {
+  auto message = std::make_shared<const std::string>(
+      R"([{"jsonrpc":"2.0","result":"a,b","id":1}, )"
+      R"({"jsonrpc":"2.0","result":[2],"id":2}])");
+
+  REQUIRE_FALSE(RawResponse::SplitBatch(R"({"id":1})").has_value());
+  REQUIRE(RawResponse::SplitBatch(" [ ] ")->empty());
+
+  auto elements = RawResponse::SplitBatch(*message);
+  REQUIRE(elements.has_value());
+  REQUIRE(elements->size() == 2);
+
+  auto first = RawResponse::Scan(message, (*elements)[0]);
+  auto second = RawResponse::Scan(message, (*elements)[1]);
+  REQUIRE(first.GetId() == 1);
+  REQUIRE(first.GetResult() == "a,b");
+  REQUIRE(second.GetId() == 2);
+  REQUIRE(second.GetResult()[0] == 2);
+}
@@ -0,0 +1,55 @@
+#include <catch2/catch_test_macros.hpp>
+#include <nlohmann/json.hpp>
+
+#include "jsonrpc/client/request.hpp"
+
+using jsonrpc::client::PreparedMethod;
+using jsonrpc::client::Request;
+
+TEST_CASE("Client request serializes a method call", "[ClientRequest]") {
+  Request request(
+      "subtract", nlohmann::json::array({42, 23}), false, []() { return 7; });
+
+  REQUIRE(request.RequiresResponse());
+  REQUIRE(request.GetKey() == 7);
+  REQUIRE(
+      request.Dump() ==
+      R"({"jsonrpc":"2.0","method":"subtract","params":[42,23],"id":7})");
+}
+
+TEST_CASE("Client request serializes a notification", "[ClientRequest]") {
+  Request request("update", std::nullopt, true, []() { return 7; });
+
+  REQUIRE_FALSE(request.RequiresResponse());
+  REQUIRE(request.Dump() == R"({"jsonrpc":"2.0","method":"update"})");
+}
+
+TEST_CASE("Client request escapes the method name", "[ClientRequest]") {
+  Request request("say \"hi\"\n", std::nullopt, false, []() { return -1; });
+
+  auto parsed = nlohmann::json::parse(request.Dump());
+  REQUIRE(parsed["method"] == "say \"hi\"\n");
+  REQUIRE(parsed["id"] == -1);
+}
+
+TEST_CASE(
+    "Prepared method encodes the same request as a method name",
+    "[ClientRequest]") {
+  PreparedMethod prepared("log.append");
+  REQUIRE(prepared.GetName() == "log.append");
+  REQUIRE(
+      prepared.GetPrefix() == R"({"jsonrpc":"2.0","method":"log.append")");
+
+  nlohmann::json params = {{"level", "info"}, {"text", "café"}};
+  Request by_name("log.append", params, false, []() { return 3; });
+  Request by_prepared(prepared, params, false, []() { return 3; });
+  REQUIRE(by_prepared.Dump() == by_name.Dump());
+
+  // Encoding appends to an existing buffer
+  std::string buffer = "[";
+  by_prepared.DumpTo(buffer);
+  buffer += ']';
+  REQUIRE(
+      nlohmann::json::parse(buffer)[0] ==
+      nlohmann::json::parse(by_name.Dump()));
+}
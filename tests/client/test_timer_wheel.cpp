@@ -0,0 +1,100 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "jsonrpc/client/timer_wheel.hpp"
+
+using jsonrpc::client::TimerWheel;
+
+TEST_CASE("TimerWheel fires a scheduled timer", "[TimerWheel]") {
+  TimerWheel wheel(std::chrono::milliseconds(1), 8);
+
+  std::promise<void> fired;
+  auto start = std::chrono::steady_clock::now();
+  wheel.Schedule(std::chrono::milliseconds(20), [&fired]() {
+    fired.set_value();
+  });
+  REQUIRE(wheel.Size() == 1);
+
+  auto future = fired.get_future();
+  REQUIRE(
+      future.wait_for(std::chrono::seconds(1)) == std::future_status::ready);
+  REQUIRE(
+      std::chrono::steady_clock::now() - start >=
+      std::chrono::milliseconds(20));
+  REQUIRE(wheel.Size() == 0);
+}
+
+TEST_CASE(
+    "TimerWheel handles delays longer than one revolution", "[TimerWheel]") {
+  // Four slots of 1ms: a 30ms timer must wait several full rounds.
+  TimerWheel wheel(std::chrono::milliseconds(1), 4);
+
+  std::atomic<int> order{0};
+  std::atomic<int> short_done{0};
+  std::atomic<int> long_done{0};
+  wheel.Schedule(std::chrono::milliseconds(30), [&]() {
+    long_done = ++order;
+  });
+  wheel.Schedule(std::chrono::milliseconds(2), [&]() {
+    short_done = ++order;
+  });
+
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+  while (long_done == 0 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  REQUIRE(short_done == 1);
+  REQUIRE(long_done == 2);
+}
+
+TEST_CASE("TimerWheel cancels a pending timer", "[TimerWheel]") {
+  TimerWheel wheel(std::chrono::milliseconds(1), 8);
+
+  std::atomic<bool> fired{false};
+  auto id = wheel.Schedule(std::chrono::milliseconds(10), [&fired]() {
+    fired = true;
+  });
+  REQUIRE(wheel.Cancel(id));
+  REQUIRE_FALSE(wheel.Cancel(id));
+  REQUIRE(wheel.Size() == 0);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  REQUIRE_FALSE(fired);
+}
+
+TEST_CASE(
+    "TimerWheel rejects the ID of a timer whose node was reused",
+    "[TimerWheel]") {
+  TimerWheel wheel(std::chrono::milliseconds(1), 8);
+
+  auto first = wheel.Schedule(std::chrono::seconds(10), []() {});
+  REQUIRE(wheel.Cancel(first));
+  auto second = wheel.Schedule(std::chrono::seconds(10), []() {});
+  REQUIRE(second != first);
+
+  REQUIRE_FALSE(wheel.Cancel(first));
+  REQUIRE(wheel.Size() == 1);
+  REQUIRE(wheel.Cancel(second));
+}
+
+TEST_CASE(
+    "TimerWheel runs callbacks too large to store inline", "[TimerWheel]") {
+  TimerWheel wheel(std::chrono::milliseconds(1), 8);
+
+  std::array<int, 64> values{};
+  values.back() = 42;
+  std::promise<int> fired;
+  wheel.Schedule(std::chrono::milliseconds(2), [values, &fired]() {
+    fired.set_value(values.back());
+  });
+
+  auto future = fired.get_future();
+  REQUIRE(
+      future.wait_for(std::chrono::seconds(1)) == std::future_status::ready);
+  REQUIRE(future.get() == 42);
+}
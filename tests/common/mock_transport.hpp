@@ -1,5 +1,8 @@
-
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <queue>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -10,20 +13,61 @@ class MockTransport : public jsonrpc::transport::Transport {
   std::vector<std::string> sent_requests;
   std::queue<std::string> responses;
 
+  using Transport::SendMessage;
+
   void SendMessage(const std::string &request) override {
-    sent_requests.push_back(request);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      sent_requests.push_back(request);
+    }
+    cv_.notify_all();
   }
 
+  // Behaves like a blocking transport: a queued response is only delivered
+  // once a request has been sent for it. Returns an empty string after a short
+  // poll interval so that a server loop can observe Stop().
   auto ReceiveMessage() -> std::string override {
-    if (responses.empty()) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait_for(lock, kPollInterval, [this]() {
+      return closed_ || ResponseDue();
+    });
+    if (closed_) {
+      throw std::runtime_error("Transport closed");
+    }
+    if (!ResponseDue()) {
       return "";
     }
     std::string response = responses.front();
     responses.pop();
+    delivered_++;
     return response;
   }
 
+  void Close() override {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      closed_ = true;
+    }
+    cv_.notify_all();
+  }
+
   void SetResponse(const std::string &response) {
-    responses.push(response);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      responses.push(response);
+    }
+    cv_.notify_all();
+  }
+
+ private:
+  static constexpr std::chrono::milliseconds kPollInterval{10};
+
+  auto ResponseDue() const -> bool {
+    return !responses.empty() && delivered_ < sent_requests.size();
   }
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::size_t delivered_ = 0;
+  bool closed_ = false;
 };
@@ -2,6 +2,9 @@
 
 #include <iostream>
 #include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
 
 // Helper function to redirect stdin
 inline void setInput(const std::string &input) {
@@ -33,3 +36,67 @@ struct RedirectIO {
   std::streambuf *oldCinBuf;
   std::streambuf *oldCoutBuf;
 };
+
+// Pipes standing in for a process's standard input and output
+struct PipeIO {
+  PipeIO() {
+    if (pipe(input) != 0 || pipe(output) != 0) {
+      throw std::runtime_error("Failed to create pipes");
+    }
+  }
+
+  ~PipeIO() {
+    for (int fd : {input[0], input[1], output[0], output[1]}) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+  }
+
+  PipeIO(const PipeIO &) = delete;
+  auto operator=(const PipeIO &) -> PipeIO & = delete;
+
+  PipeIO(PipeIO &&) = delete;
+  auto operator=(PipeIO &&) -> PipeIO & = delete;
+
+  // Descriptor the transport reads from
+  [[nodiscard]] auto InputFd() const -> int {
+    return input[0];
+  }
+
+  // Descriptor the transport writes to
+  [[nodiscard]] auto OutputFd() const -> int {
+    return output[1];
+  }
+
+  // Feeds input to the transport and closes it
+  void SetInput(const std::string &data) {
+    std::size_t written = 0;
+    while (written < data.size()) {
+      ssize_t result =
+          write(input[1], data.data() + written, data.size() - written);
+      if (result < 0) {
+        throw std::runtime_error("Failed to write input");
+      }
+      written += static_cast<std::size_t>(result);
+    }
+    close(input[1]);
+    input[1] = -1;
+  }
+
+  // Returns everything the transport wrote, once its output is closed
+  auto GetOutput() -> std::string {
+    close(output[1]);
+    output[1] = -1;
+    std::string data;
+    char chunk[4096];
+    ssize_t result = 0;
+    while ((result = read(output[0], chunk, sizeof(chunk))) > 0) {
+      data.append(chunk, static_cast<std::size_t>(result));
+    }
+    return data;
+  }
+
+  int input[2] = {-1, -1};
+  int output[2] = {-1, -1};
+};
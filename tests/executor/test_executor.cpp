@@ -0,0 +1,178 @@
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <asio.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "jsonrpc/executor/inline_executor.hpp"
+#include "jsonrpc/executor/io_context_executor.hpp"
+#include "jsonrpc/executor/work_stealing_executor.hpp"
+
+TEST_CASE("InlineExecutor runs tasks on the calling thread", "[Executor]") {
+  jsonrpc::executor::InlineExecutor executor;
+
+  std::thread::id task_thread;
+  executor.Execute([&task_thread]() {
+    task_thread = std::this_thread::get_id();
+  });
+  REQUIRE(task_thread == std::this_thread::get_id());
+
+  auto future = executor.Submit([]() { return 42; });
+  REQUIRE(
+      future.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+  REQUIRE(future.get() == 42);
+}
+
+TEST_CASE("WorkStealingExecutor runs submitted tasks", "[Executor]") {
+  jsonrpc::executor::WorkStealingExecutor executor(4);
+  REQUIRE(executor.GetThreadCount() == 4);
+
+  const int num_tasks = 1000;
+  std::vector<std::future<int>> futures;
+  futures.reserve(num_tasks);
+  for (int i = 0; i < num_tasks; ++i) {
+    futures.push_back(executor.Submit([i]() { return i * 2; }));
+  }
+
+  for (int i = 0; i < num_tasks; ++i) {
+    REQUIRE(futures[i].get() == i * 2);
+  }
+}
+
+TEST_CASE(
+    "WorkStealingExecutor runs tasks submitted from workers", "[Executor]") {
+  jsonrpc::executor::WorkStealingExecutor executor(2);
+
+  std::atomic<int> counter{0};
+  std::promise<void> done;
+  const int num_children = 100;
+
+  executor.Execute([&]() {
+    for (int i = 0; i < num_children; ++i) {
+      executor.Execute([&]() {
+        if (counter.fetch_add(1) + 1 == num_children) {
+          done.set_value();
+        }
+      });
+    }
+  });
+
+  auto done_future = done.get_future();
+  REQUIRE(
+      done_future.wait_for(std::chrono::seconds(5)) ==
+      std::future_status::ready);
+  REQUIRE(counter.load() == num_children);
+}
+
+TEST_CASE(
+    "WorkStealingExecutor drains queued tasks on destruction", "[Executor]") {
+  std::atomic<int> counter{0};
+  {
+    jsonrpc::executor::WorkStealingExecutor executor(2);
+    for (int i = 0; i < 100; ++i) {
+      executor.Execute([&counter]() { counter.fetch_add(1); });
+    }
+  }
+  REQUIRE(counter.load() == 100);
+}
+
+TEST_CASE("WorkStealingExecutor treats zero threads as one", "[Executor]") {
+  jsonrpc::executor::WorkStealingExecutor executor(0);
+  REQUIRE(executor.GetThreadCount() == 1);
+  REQUIRE(executor.Submit([]() { return 1; }).get() == 1);
+}
+
+TEST_CASE("WorkStealingExecutor starts workers lazily", "[Executor]") {
+  jsonrpc::executor::WorkStealingExecutor executor(2);
+  REQUIRE(executor.IsStarted() == false);
+
+  REQUIRE(executor.Submit([]() { return 1; }).get() == 1);
+  REQUIRE(executor.IsStarted() == true);
+
+  jsonrpc::executor::WorkStealingExecutor eager(
+      jsonrpc::executor::WorkStealingOptions{.num_threads = 1,
+                                             .lazy_start = false});
+  REQUIRE(eager.IsStarted() == true);
+}
+
+TEST_CASE("WorkStealingExecutor shared instance is reused", "[Executor]") {
+  auto first = jsonrpc::executor::WorkStealingExecutor::GetShared();
+  auto second = jsonrpc::executor::WorkStealingExecutor::GetShared();
+  REQUIRE(first != nullptr);
+  REQUIRE(first == second);
+}
+
+TEST_CASE("WorkStealingExecutor rejects an unknown NUMA node", "[Executor]") {
+  REQUIRE_THROWS_AS(
+      jsonrpc::executor::WorkStealingExecutor(
+          jsonrpc::executor::WorkStealingOptions{.numa_node = 1 << 20}),
+      std::invalid_argument);
+}
+
+#ifdef __linux__
+TEST_CASE("WorkStealingExecutor pins workers to a CPU set", "[Executor]") {
+  // Pin to a CPU this process may run on, which need not be CPU 0 under
+  // cgroup or taskset limits.
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  REQUIRE(sched_getaffinity(0, sizeof(allowed), &allowed) == 0);
+  int cpu = 0;
+  while (!CPU_ISSET(cpu, &allowed)) {
+    ++cpu;
+  }
+
+  jsonrpc::executor::WorkStealingExecutor executor(
+      jsonrpc::executor::WorkStealingOptions{.num_threads = 2,
+                                             .cpu_set = {cpu}});
+
+  auto future = executor.Submit([cpu]() {
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    pthread_getaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+    return CPU_COUNT(&cpu_set) == 1 && CPU_ISSET(cpu, &cpu_set);
+  });
+  REQUIRE(future.get() == true);
+}
+
+TEST_CASE(
+    "WorkStealingExecutor rejects CPU ids outside the CPU set",
+    "[Executor]") {
+  REQUIRE_THROWS_AS(
+      jsonrpc::executor::WorkStealingExecutor(
+          jsonrpc::executor::WorkStealingOptions{.cpu_set = {CPU_SETSIZE}}),
+      std::invalid_argument);
+  REQUIRE_THROWS_AS(
+      jsonrpc::executor::WorkStealingExecutor(
+          jsonrpc::executor::WorkStealingOptions{.cpu_set = {-1}}),
+      std::invalid_argument);
+}
+#endif
+
+TEST_CASE("IoContextExecutor posts tasks to the io_context", "[Executor]") {
+  asio::io_context io_context;
+  jsonrpc::executor::IoContextExecutor executor(io_context);
+
+  std::set<int> seen;
+  executor.Execute([&seen]() { seen.insert(1); });
+  auto future = executor.Submit([&seen]() {
+    seen.insert(2);
+    return static_cast<int>(seen.size());
+  });
+
+  // Nothing runs until the io_context is driven.
+  REQUIRE(seen.empty());
+
+  io_context.run();
+
+  REQUIRE(seen == std::set<int>{1, 2});
+  REQUIRE(future.get() == 2);
+}
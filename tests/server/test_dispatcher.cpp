@@ -3,6 +3,8 @@
 #include <catch2/catch_test_macros.hpp>
 #include <nlohmann/json.hpp>
 
+#include "jsonrpc/executor/inline_executor.hpp"
+#include "jsonrpc/executor/work_stealing_executor.hpp"
 #include "jsonrpc/server/dispatcher.hpp"
 
 // Helper function to create a Dispatcher object
@@ -196,6 +198,19 @@ TEST_CASE("RPC call with invalid JSON", "[Dispatcher]") {
   REQUIRE(response_json["id"] == nullptr);
 }
 
+TEST_CASE(
+    "Dispatcher answers discarded JSON with a parse error", "[Dispatcher]") {
+  jsonrpc::server::Dispatcher dispatcher;
+
+  nlohmann::json discarded = nlohmann::json::parse("{oops", nullptr, false);
+  std::optional<std::string> response_str =
+      dispatcher.DispatchRequest(discarded);
+  REQUIRE(response_str.has_value());
+  nlohmann::json response_json = nlohmann::json::parse(response_str.value());
+  REQUIRE(response_json["error"]["code"] == -32700);  // Parse error
+  REQUIRE(response_json["id"] == nullptr);
+}
+
 TEST_CASE("RPC call with invalid ServerRequest object", "[Dispatcher]") {
   jsonrpc::server::Dispatcher dispatcher;
 
@@ -362,3 +377,39 @@ TEST_CASE("RPC call Batch (all notifications)", "[Dispatcher]") {
       dispatcher.DispatchRequest(request_json.dump());
   REQUIRE(!response_str.has_value());
 }
+
+TEST_CASE("Dispatcher rejects a null executor", "[Dispatcher]") {
+  REQUIRE_THROWS_AS(
+      jsonrpc::server::Dispatcher(
+          std::shared_ptr<jsonrpc::executor::Executor>()),
+      std::invalid_argument);
+}
+
+TEST_CASE("RPC call Batch on a shared executor", "[Dispatcher]") {
+  auto executor =
+      std::make_shared<jsonrpc::executor::WorkStealingExecutor>(2);
+  jsonrpc::server::Dispatcher first(executor);
+  jsonrpc::server::Dispatcher second(executor);
+  jsonrpc::server::Dispatcher inline_dispatcher(
+      std::make_shared<jsonrpc::executor::InlineExecutor>());
+
+  // clang-format off
+  nlohmann::json request_json = nlohmann::json::array({
+    {{"jsonrpc", "2.0"}, {"method", "sum"}, {"params", {1, 2, 4}}, {"id", 1}},
+    {{"jsonrpc", "2.0"}, {"method", "subtract"}, {"params", {42, 23}}, {"id", 2}}
+  });
+  // clang-format on
+
+  for (auto *dispatcher : {&first, &second, &inline_dispatcher}) {
+    RegisterCommonHandlers(*dispatcher);
+    std::optional<std::string> response_str =
+        dispatcher->DispatchRequest(request_json.dump());
+    REQUIRE(response_str.has_value());
+    nlohmann::json response_json = nlohmann::json::parse(response_str.value());
+    REQUIRE(response_json.size() == 2);
+    REQUIRE(response_json[0]["result"] == 7);
+    REQUIRE(response_json[0]["id"] == 1);
+    REQUIRE(response_json[1]["result"] == 19);
+    REQUIRE(response_json[1]["id"] == 2);
+  }
+}
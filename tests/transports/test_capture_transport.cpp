@@ -0,0 +1,214 @@
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <nlohmann/json.hpp>
+
+#include "jsonrpc/server/server.hpp"
+#include "jsonrpc/transport/capture_transport.hpp"
+#include "jsonrpc/transport/replay_transport.hpp"
+
+using jsonrpc::transport::CaptureDirection;
+using jsonrpc::transport::CaptureFraming;
+using jsonrpc::transport::CaptureTransport;
+using jsonrpc::transport::ReplayOptions;
+using jsonrpc::transport::ReplayPacing;
+using jsonrpc::transport::ReplayTransport;
+using Json = nlohmann::json;
+
+namespace {
+
+/// Transport that hands out scripted messages and keeps what is sent.
+class ScriptedTransport : public jsonrpc::transport::Transport {
+ public:
+  explicit ScriptedTransport(
+      std::deque<std::string> incoming, std::vector<std::string> *sent)
+      : incoming_(std::move(incoming)), sent_(sent) {
+  }
+
+  using Transport::SendMessage;
+
+  void SendMessage(const std::string &message) override {
+    sent_->push_back(message);
+  }
+
+  auto ReceiveMessage() -> std::string override {
+    if (incoming_.empty()) {
+      throw std::runtime_error("No more messages");
+    }
+    std::string message = std::move(incoming_.front());
+    incoming_.pop_front();
+    return message;
+  }
+
+ private:
+  std::deque<std::string> incoming_;
+  std::vector<std::string> *sent_;
+};
+
+/// Removes the capture file when the test ends.
+struct CaptureFile {
+  std::string path;
+
+  explicit CaptureFile(const std::string &name)
+      : path((std::filesystem::temp_directory_path() / name).string()) {
+    std::filesystem::remove(path);
+  }
+
+  ~CaptureFile() {
+    std::filesystem::remove(path);
+  }
+
+  CaptureFile(const CaptureFile &) = delete;
+  auto operator=(const CaptureFile &) -> CaptureFile & = delete;
+
+  CaptureFile(CaptureFile &&) = delete;
+  auto operator=(CaptureFile &&) -> CaptureFile & = delete;
+};
+
+}  // namespace
+
+TEST_CASE(
+    "ReplayTransport plays back what CaptureTransport recorded",
+    "[CaptureTransport]") {
+  CaptureFile file("jsonrpc_test_capture_roundtrip.bin");
+  std::vector<std::string> sent;
+
+  {
+    CaptureTransport capture(
+        std::make_unique<ScriptedTransport>(
+            std::deque<std::string>{"request 1", "", "request 2"}, &sent),
+        file.path, CaptureFraming::kContentLength);
+    REQUIRE(capture.ReceiveMessage() == "request 1");
+    capture.SendMessage("response 1");
+    REQUIRE(capture.ReceiveMessage().empty());
+    REQUIRE(capture.ReceiveMessage() == "request 2");
+    capture.SendMessage(std::string("response 2"));
+  }
+  REQUIRE(sent == std::vector<std::string>{"response 1", "response 2"});
+
+  ReplayTransport received(file.path);
+  REQUIRE(received.GetFraming() == CaptureFraming::kContentLength);
+  REQUIRE(received.ReceiveMessage() == "request 1");
+  REQUIRE(received.ReceiveMessage().empty());
+  REQUIRE(received.ReceiveMessage() == "request 2");
+  REQUIRE_THROWS_AS(received.ReceiveMessage(), std::runtime_error);
+  REQUIRE(received.GetReceivedCount() == 3);
+
+  ReplayOptions options;
+  options.direction = CaptureDirection::kSent;
+  ReplayTransport sent_replay(file.path, options);
+  REQUIRE(sent_replay.ReceiveMessage() == "response 1");
+  REQUIRE(sent_replay.ReceiveMessage() == "response 2");
+  REQUIRE_THROWS_AS(sent_replay.ReceiveMessage(), std::runtime_error);
+}
+
+TEST_CASE(
+    "CaptureTransport appends to an existing capture", "[CaptureTransport]") {
+  CaptureFile file("jsonrpc_test_capture_append.bin");
+  std::vector<std::string> sent;
+
+  for (const char *message : {"first", "second"}) {
+    CaptureTransport capture(
+        std::make_unique<ScriptedTransport>(
+            std::deque<std::string>{message}, &sent),
+        file.path);
+    capture.ReceiveMessage();
+  }
+
+  ReplayTransport replay(file.path);
+  REQUIRE(replay.ReceiveMessage() == "first");
+  REQUIRE(replay.ReceiveMessage() == "second");
+
+  // A record cut short at the end of the file is ignored.
+  std::filesystem::resize_file(
+      file.path, std::filesystem::file_size(file.path) - 2);
+  ReplayTransport truncated(file.path);
+  REQUIRE(truncated.ReceiveMessage() == "first");
+  REQUIRE_THROWS_AS(truncated.ReceiveMessage(), std::runtime_error);
+}
+
+TEST_CASE(
+    "ReplayTransport rejects files that are not captures",
+    "[CaptureTransport]") {
+  CaptureFile file("jsonrpc_test_capture_invalid.bin");
+  std::FILE *out = std::fopen(file.path.c_str(), "wb");
+  REQUIRE(out != nullptr);
+  std::fputs("this is not a capture file", out);
+  std::fclose(out);
+
+  REQUIRE_THROWS_AS(ReplayTransport(file.path), std::runtime_error);
+  std::vector<std::string> sent;
+  REQUIRE_THROWS_AS(
+      CaptureTransport(
+          std::make_unique<ScriptedTransport>(
+              std::deque<std::string>{}, &sent),
+          file.path),
+      std::runtime_error);
+}
+
+TEST_CASE(
+    "ReplayTransport keeps the recorded pacing", "[CaptureTransport]") {
+  CaptureFile file("jsonrpc_test_capture_pacing.bin");
+  std::vector<std::string> sent;
+  {
+    CaptureTransport capture(
+        std::make_unique<ScriptedTransport>(
+            std::deque<std::string>{"early", "late"}, &sent),
+        file.path);
+    capture.ReceiveMessage();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    capture.ReceiveMessage();
+  }
+
+  ReplayOptions options;
+  options.pacing = ReplayPacing::kRecorded;
+  ReplayTransport replay(file.path, options);
+  auto start = std::chrono::steady_clock::now();
+  REQUIRE(replay.ReceiveMessage() == "early");
+  REQUIRE(replay.ReceiveMessage() == "late");
+  REQUIRE(
+      std::chrono::steady_clock::now() - start >=
+      std::chrono::milliseconds(100));
+}
+
+TEST_CASE("ReplayTransport drives a Server", "[CaptureTransport]") {
+  CaptureFile file("jsonrpc_test_capture_server.bin");
+  std::vector<std::string> sent;
+  std::deque<std::string> requests;
+  for (int i = 0; i < 10; ++i) {
+    requests.push_back(
+        Json{{"jsonrpc", "2.0"},
+             {"method", "add"},
+             {"params", {{"a", i}, {"b", 1}}},
+             {"id", i}}
+            .dump());
+  }
+  {
+    CaptureTransport capture(
+        std::make_unique<ScriptedTransport>(requests, &sent), file.path);
+    for (std::size_t i = 0; i < requests.size(); ++i) {
+      capture.ReceiveMessage();
+    }
+  }
+
+  auto transport = std::make_unique<ReplayTransport>(file.path);
+  ReplayTransport *replay = transport.get();
+  jsonrpc::server::Server server(std::move(transport));
+  server.RegisterMethodCall("add", [](const std::optional<Json> &params) {
+    int sum = (*params)["a"].get<int>() + (*params)["b"].get<int>();
+    return Json{{"result", sum}};
+  });
+
+  // Returns once the capture is exhausted.
+  server.Start();
+  REQUIRE(replay->GetReceivedCount() == 10);
+  REQUIRE(replay->GetSentCount() == 10);
+}
@@ -0,0 +1,70 @@
+#include <string>
+#include <string_view>
+
+#include <asio.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "jsonrpc/transport/delimiter_search.hpp"
+
+using jsonrpc::transport::DelimiterMatch;
+using jsonrpc::transport::FindDelimiter;
+
+namespace {
+
+auto Find(std::string_view data, std::string_view delimiter) -> std::size_t {
+  return FindDelimiter(data.data(), data.size(), delimiter);
+}
+
+}  // namespace
+
+TEST_CASE("FindDelimiter finds a single byte", "[DelimiterSearch]") {
+  REQUIRE(Find("", "\n") == std::string_view::npos);
+  REQUIRE(Find("\n", "\n") == 0);
+  REQUIRE(Find("abc", "\n") == std::string_view::npos);
+  REQUIRE(Find("abc\ndef\n", "\n") == 3);
+}
+
+TEST_CASE(
+    "FindDelimiter agrees with string_view::find at every position",
+    "[DelimiterSearch]") {
+  for (std::string_view delimiter : {"\n", "\r\n", "\r\n\r\n"}) {
+    for (std::size_t size = 0; size < 100; ++size) {
+      for (std::size_t pos = 0; pos + delimiter.size() <= size; ++pos) {
+        // Near misses before the match must not be reported.
+        std::string data(size, 'x');
+        for (std::size_t i = 0; i + 2 < pos; i += 3) {
+          data.replace(i, 2, "\r\n");
+        }
+        data.replace(pos, delimiter.size(), delimiter);
+        REQUIRE(Find(data, delimiter) == data.find(delimiter));
+      }
+      REQUIRE(Find(std::string(size, 'x'), delimiter) == std::string::npos);
+    }
+  }
+}
+
+TEST_CASE(
+    "DelimiterMatch finds delimiters split across reads",
+    "[DelimiterSearch]") {
+  asio::streambuf buffer;
+  auto append = [&](std::string_view data) {
+    auto target = buffer.prepare(data.size());
+    asio::buffer_copy(target, asio::buffer(data.data(), data.size()));
+    buffer.commit(data.size());
+  };
+  DelimiterMatch match("\r\n\r\n");
+
+  append("Content-Length: 2\r\n\r");
+  auto begin = asio::buffers_begin(buffer.data());
+  auto end = asio::buffers_end(buffer.data());
+  auto [resume, found] = match(begin, end);
+  REQUIRE_FALSE(found);
+  REQUIRE(resume - begin == 17);
+
+  append("\n{}");
+  begin = asio::buffers_begin(buffer.data());
+  end = asio::buffers_end(buffer.data());
+  auto [match_end, found_again] = match(begin + 17, end);
+  REQUIRE(found_again);
+  REQUIRE(match_end - begin == 21);
+}
@@ -1,5 +1,5 @@
-#include <sstream>
 #include <string>
+#include <thread>
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_string.hpp>
@@ -10,117 +10,272 @@ namespace jsonrpc::transport {
 
 class FramedTransportTest : public jsonrpc::transport::FramedTransport {
  public:
-  using jsonrpc::transport::FramedTransport::FrameMessage;
-  using jsonrpc::transport::FramedTransport::ReadContent;
-  using jsonrpc::transport::FramedTransport::ReadContentLengthFromStream;
-  using jsonrpc::transport::FramedTransport::ReadHeadersFromStream;
+  explicit FramedTransportTest(FramedOptions options = {})
+      : FramedTransport(options) {
+  }
+
+  using jsonrpc::transport::FramedTransport::AsyncReceiveFramedMessage;
+  using jsonrpc::transport::FramedTransport::MakeFrameHeader;
+  using jsonrpc::transport::FramedTransport::ParseHeaders;
+  using jsonrpc::transport::FramedTransport::ReceiveFramedJson;
   using jsonrpc::transport::FramedTransport::ReceiveFramedMessage;
 
-  static auto TestParseContentLength(const std::string &header_value) -> int {
+  static auto TestParseContentLength(const std::string &header_value)
+      -> std::size_t {
     return ParseContentLength(header_value);
   }
 };
 
 }  // namespace jsonrpc::transport
 
-TEST_CASE("FramedTransport correctly frames a message", "[FramedTransport]") {
-  std::ostringstream output;
-  std::string message = R"({"jsonrpc":"2.0","method":"testMethod"})";
-
-  jsonrpc::transport::FramedTransportTest::FrameMessage(output, message);
+TEST_CASE(
+    "FramedTransport formats headers without the content",
+    "[FramedTransport]") {
+  auto header =
+      jsonrpc::transport::FramedTransportTest::MakeFrameHeader(1234567);
 
-  std::string expected_output =
-      "Content-Length: 39\r\n"
+  REQUIRE(
+      header.View() ==
+      "Content-Length: 1234567\r\n"
       "Content-Type: application/vscode-jsonrpc; charset=utf-8\r\n"
-      "\r\n" +
-      message;
-
-  REQUIRE(output.str() == expected_output);
+      "\r\n");
 }
 
-TEST_CASE("FramedTransport parses headers correctly", "[FramedTransport]") {
+TEST_CASE(
+    "FramedTransport returns correct content length", "[FramedTransport]") {
   std::string header_string =
       "Content-Length: 37\r\nContent-Type: "
       "application/vscode-jsonrpc; charset=utf-8\r\n\r\n";
-  std::istringstream header_stream(header_string);
 
-  auto headers = jsonrpc::transport::FramedTransportTest::ReadHeadersFromStream(
-      header_stream);
-
-  REQUIRE(headers.size() == 2);
-  REQUIRE(headers["Content-Length"] == "37");
   REQUIRE(
-      headers["Content-Type"] == "application/vscode-jsonrpc; charset=utf-8");
+      jsonrpc::transport::FramedTransportTest::ParseHeaders(header_string) ==
+      37);
 }
 
 TEST_CASE(
-    "FramedTransport returns correct content length", "[FramedTransport]") {
-  std::string header_string =
-      "Content-Length: 37\r\nContent-Type: "
-      "application/vscode-jsonrpc; charset=utf-8\r\n\r\n";
-  std::istringstream header_stream(header_string);
+    "FramedTransport throws error on invalid content length",
+    "[FramedTransport]") {
+  REQUIRE_THROWS_WITH(
+      jsonrpc::transport::FramedTransportTest::ParseHeaders(
+          "Content-Length: invalid\r\n\r\n"),
+      "Invalid Content-Length value");
+}
 
-  int content_length =
-      jsonrpc::transport::FramedTransportTest::ReadContentLengthFromStream(
-          header_stream);
+TEST_CASE(
+    "FramedTransport throws error on missing Content-Length",
+    "[FramedTransport]") {
+  REQUIRE_THROWS_WITH(
+      jsonrpc::transport::FramedTransportTest::ParseHeaders(
+          "Content-Type: application/vscode-jsonrpc; charset=utf-8\r\n\r\n"),
+      "Content-Length header missing");
+}
+
+TEST_CASE(
+    "FramedTransport throws error on out of range content length",
+    "[FramedTransport]") {
+  REQUIRE_THROWS_WITH(
+      jsonrpc::transport::FramedTransportTest::ParseHeaders(
+          "Content-Length: 9999999999999999999999\r\n\r\n"),
+      "Content-Length value out of range");
+}
 
-  REQUIRE(content_length == 37);
+TEST_CASE(
+    "FramedTransport matches header names case-insensitively",
+    "[FramedTransport]") {
+  using jsonrpc::transport::FramedTransportTest;
+
+  REQUIRE(
+      FramedTransportTest::ParseHeaders(
+          "content-length:42\r\nCONTENT-TYPE: application/json\r\n\r\n") ==
+      42);
+  REQUIRE(
+      FramedTransportTest::ParseHeaders("CoNtEnT-LeNgTh: \t7 \r\n\r\n") ==
+      7);
 }
 
-TEST_CASE("FramedTransport reads correct content", "[FramedTransport]") {
-  std::string content = R"({"jsonrpc":"2.0","method":"testMethod"})";
-  std::istringstream input(content);
+TEST_CASE("FramedTransport skips unknown headers", "[FramedTransport]") {
+  using jsonrpc::transport::FramedTransportTest;
 
-  std::string result = jsonrpc::transport::FramedTransportTest::ReadContent(
-      input, content.size());
+  REQUIRE(
+      FramedTransportTest::ParseHeaders(
+          "X-Trace: abc\r\nContent-Length: 5\r\nX-Other: 1:2\r\n\r\n"
+          "ignored: 9\r\n") == 5);
+}
+
+TEST_CASE(
+    "FramedTransport rejects malformed Content-Length values",
+    "[FramedTransport]") {
+  using jsonrpc::transport::FramedTransportTest;
 
-  REQUIRE(result == content);
+  REQUIRE_THROWS_WITH(
+      FramedTransportTest::ParseHeaders("Content-Length: 12abc\r\n\r\n"),
+      "Invalid Content-Length value");
+  REQUIRE_THROWS_WITH(
+      FramedTransportTest::ParseHeaders("Content-Length: -1\r\n\r\n"),
+      "Invalid Content-Length value");
+  REQUIRE_THROWS_WITH(
+      FramedTransportTest::ParseHeaders("Content-Length:\r\n\r\n"),
+      "Invalid Content-Length value");
+  REQUIRE_THROWS_WITH(
+      FramedTransportTest::ParseHeaders("\r\n"), "Failed to read headers");
 }
 
+namespace {
+
+/// @brief A connected pair of Unix domain sockets.
+struct SocketPair {
+  asio::io_context io_context;
+  asio::local::stream_protocol::socket reader{io_context};
+  asio::local::stream_protocol::socket writer{io_context};
+
+  SocketPair() {
+    asio::local::connect_pair(reader, writer);
+  }
+
+  void Write(const std::string &data) {
+    asio::write(writer, asio::buffer(data));
+  }
+
+  void WriteFramed(const std::string &content) {
+    Write(
+        "Content-Length: " + std::to_string(content.size()) + "\r\n\r\n" +
+        content);
+  }
+};
+
+}  // namespace
+
 TEST_CASE(
-    "FramedTransport correctly receives framed message", "[FramedTransport]") {
-  std::string framed_message =
-      "Content-Length: 39\r\nContent-Type: application/vscode-jsonrpc; "
-      "charset=utf-8\r\n\r\n"
-      R"({"jsonrpc":"2.0","method":"testMethod"})";
-  std::istringstream input(framed_message);
+    "FramedTransport parses message content while receiving it",
+    "[FramedTransport]") {
+  using jsonrpc::transport::FramedTransportTest;
 
-  std::string result =
-      jsonrpc::transport::FramedTransportTest::ReceiveFramedMessage(input);
+  SocketPair sockets;
+  FramedTransportTest transport;
+  asio::streambuf buffer;
 
-  REQUIRE(result == R"({"jsonrpc":"2.0","method":"testMethod"})");
+  // Larger than a streaming chunk and written in pieces, so the parser has
+  // to wait for more content several times.
+  std::string payload(300 * 1024, 'x');
+  std::string content = R"({"method":"big","params":[")" + payload + R"("]})";
+  std::string framed = "Content-Length: " + std::to_string(content.size()) +
+                       "\r\n\r\n" + content;
+  std::thread writer([&]() {
+    for (std::size_t offset = 0; offset < framed.size(); offset += 50000) {
+      sockets.Write(framed.substr(offset, 50000));
+    }
+    sockets.WriteFramed(R"({"method":"next"})");
+  });
+
+  nlohmann::json message = transport.ReceiveFramedJson(sockets.reader, buffer);
+  REQUIRE(message["method"] == "big");
+  REQUIRE(message["params"][0].get<std::string>() == payload);
+  REQUIRE(
+      transport.ReceiveFramedJson(sockets.reader, buffer)["method"] == "next");
+  writer.join();
 }
 
 TEST_CASE(
-    "FramedTransport throws error on invalid content length",
+    "FramedTransport skips the rest of invalid streamed content",
     "[FramedTransport]") {
-  jsonrpc::transport::FramedTransportTest transport;
-  std::istringstream input("Content-Length: invalid\r\n\r\n");
+  using jsonrpc::transport::FramedTransportTest;
 
-  REQUIRE_THROWS_WITH(
-      transport.ReadContentLengthFromStream(input),
-      "Invalid Content-Length value");
+  SocketPair sockets;
+  FramedTransportTest transport;
+  asio::streambuf buffer;
+
+  sockets.WriteFramed(R"({"method": oops, "params": [1, 2, 3]})");
+  sockets.WriteFramed(R"({"a":1} trailing)");
+  sockets.WriteFramed("[1]");
+
+  REQUIRE(transport.ReceiveFramedJson(sockets.reader, buffer).is_discarded());
+  REQUIRE(transport.ReceiveFramedJson(sockets.reader, buffer).is_discarded());
+  REQUIRE(
+      transport.ReceiveFramedJson(sockets.reader, buffer) ==
+      nlohmann::json::array({1}));
 }
 
 TEST_CASE(
-    "FramedTransport throws error on missing Content-Length",
+    "FramedTransport skips messages above the maximum size",
     "[FramedTransport]") {
-  jsonrpc::transport::FramedTransportTest transport;
-  std::istringstream input(
-      "Content-Type: application/vscode-jsonrpc; charset=utf-8\r\n\r\n");
+  using jsonrpc::transport::FramedTransportTest;
+  using jsonrpc::transport::MessageTooLargeError;
+
+  SocketPair sockets;
+  FramedTransportTest transport({.max_message_size = 16});
+  asio::streambuf buffer;
+
+  sockets.WriteFramed(R"({"method":"ok"})");
+  REQUIRE(
+      transport.ReceiveFramedMessage(sockets.reader, buffer) ==
+      R"({"method":"ok"})");
 
+  // Each oversized message is reported on its own and the next one is
+  // received intact.
+  std::string oversized(100000, 'x');
+  sockets.WriteFramed(oversized);
+  sockets.WriteFramed("after");
+  REQUIRE_THROWS_AS(
+      transport.ReceiveFramedMessage(sockets.reader, buffer),
+      MessageTooLargeError);
+  REQUIRE(transport.ReceiveFramedMessage(sockets.reader, buffer) == "after");
+
+  sockets.WriteFramed(std::string(17, 'x'));
+  sockets.WriteFramed("[1]");
   REQUIRE_THROWS_WITH(
-      transport.ReadContentLengthFromStream(input),
-      "Content-Length header missing");
+      transport.ReceiveFramedJson(sockets.reader, buffer),
+      "Message of 17 bytes exceeds the limit of 16 bytes");
+  REQUIRE(
+      transport.ReceiveFramedJson(sockets.reader, buffer) ==
+      nlohmann::json::array({1}));
+
+  sockets.WriteFramed(oversized);
+  sockets.WriteFramed("async");
+  asio::error_code error;
+  transport.AsyncReceiveFramedMessage(
+      sockets.reader, buffer,
+      [&](const asio::error_code &ec, const std::string &) { error = ec; });
+  sockets.io_context.run();
+  REQUIRE(error == asio::error::message_size);
+
+  std::string received;
+  transport.AsyncReceiveFramedMessage(
+      sockets.reader, buffer,
+      [&](const asio::error_code &ec, const std::string &message) {
+        error = ec;
+        received = message;
+      });
+  sockets.io_context.restart();
+  sockets.io_context.run();
+  REQUIRE_FALSE(error);
+  REQUIRE(received == "async");
 }
 
 TEST_CASE(
-    "FramedTransport throws error on out of range content length",
+    "FramedTransport rejects headers above the maximum size",
     "[FramedTransport]") {
-  jsonrpc::transport::FramedTransportTest transport;
-  std::istringstream input("Content-Length: 9999999999999999999999\r\n\r\n");
+  using jsonrpc::transport::FramedTransportTest;
 
-  REQUIRE_THROWS_WITH(
-      transport.ReadContentLengthFromStream(input),
-      "Content-Length value out of range");
+  std::string unterminated(16384, 'x');
+  {
+    SocketPair sockets;
+    FramedTransportTest transport;
+    asio::streambuf buffer;
+    sockets.Write(unterminated);
+    REQUIRE_THROWS_WITH(
+        transport.ReceiveFramedMessage(sockets.reader, buffer),
+        "Message headers too long");
+  }
+  {
+    SocketPair sockets;
+    FramedTransportTest transport;
+    asio::streambuf buffer;
+    sockets.Write(unterminated);
+    asio::error_code error;
+    transport.AsyncReceiveFramedMessage(
+        sockets.reader, buffer,
+        [&](const asio::error_code &ec, const std::string &) { error = ec; });
+    sockets.io_context.run();
+    REQUIRE(error == asio::error::invalid_argument);
+  }
 }
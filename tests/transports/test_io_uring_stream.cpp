@@ -0,0 +1,112 @@
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include <asio.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "jsonrpc/transport/io_uring_stream.hpp"
+
+using jsonrpc::transport::IoUringOptions;
+using jsonrpc::transport::IoUringStream;
+
+namespace {
+
+/// Closes both ends of a socket pair.
+struct SocketPair {
+  int fds[2] = {-1, -1};
+
+  SocketPair() {
+    REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+  }
+
+  ~SocketPair() {
+    for (int fd : fds) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+  }
+
+  SocketPair(const SocketPair &) = delete;
+  auto operator=(const SocketPair &) -> SocketPair & = delete;
+
+  SocketPair(SocketPair &&) = delete;
+  auto operator=(SocketPair &&) -> SocketPair & = delete;
+};
+
+}  // namespace
+
+TEST_CASE(
+    "IoUringStream reads lines across receive buffers", "[IoUringStream]") {
+  SocketPair sockets;
+  IoUringOptions options;
+  options.buffer_count = 2;
+  options.buffer_size = 8;
+  auto stream = IoUringStream::Create(sockets.fds[0], options);
+  if (stream == nullptr) {
+    WARN("io_uring is not available");
+    return;
+  }
+
+  constexpr int kLineCount = 200;
+  std::thread writer([&]() {
+    for (int i = 0; i < kLineCount; ++i) {
+      std::string line = "line number " + std::to_string(i) + "\n";
+      REQUIRE(
+          write(sockets.fds[1], line.data(), line.size()) ==
+          static_cast<ssize_t>(line.size()));
+    }
+  });
+
+  asio::streambuf buffer;
+  for (int i = 0; i < kLineCount; ++i) {
+    std::size_t length = asio::read_until(*stream, buffer, '\n');
+    std::string line(
+        asio::buffers_begin(buffer.data()),
+        asio::buffers_begin(buffer.data()) + static_cast<long>(length));
+    buffer.consume(length);
+    REQUIRE(line == "line number " + std::to_string(i) + "\n");
+  }
+  writer.join();
+}
+
+TEST_CASE("IoUringStream gathers writes", "[IoUringStream]") {
+  SocketPair sockets;
+  auto stream = IoUringStream::Create(sockets.fds[0]);
+  if (stream == nullptr) {
+    WARN("io_uring is not available");
+    return;
+  }
+
+  std::vector<asio::const_buffer> buffers{
+      asio::buffer("Hello, ", 7), asio::buffer("io_uring", 8),
+      asio::buffer("\n", 1)};
+  asio::write(*stream, buffers);
+
+  std::string received(16, '\0');
+  ssize_t size = read(sockets.fds[1], received.data(), received.size());
+  REQUIRE(size == 16);
+  REQUIRE(received == "Hello, io_uring\n");
+}
+
+TEST_CASE("IoUringStream reports end of stream", "[IoUringStream]") {
+  SocketPair sockets;
+  auto stream = IoUringStream::Create(sockets.fds[0]);
+  if (stream == nullptr) {
+    WARN("io_uring is not available");
+    return;
+  }
+
+  REQUIRE(write(sockets.fds[1], "tail", 4) == 4);
+  close(sockets.fds[1]);
+  sockets.fds[1] = -1;
+
+  asio::streambuf buffer;
+  asio::error_code ec;
+  asio::read(*stream, buffer, ec);
+  REQUIRE(ec == asio::error::eof);
+  REQUIRE(buffer.size() == 4);
+}
@@ -0,0 +1,166 @@
+#include <future>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+#include <nlohmann/json.hpp>
+
+#include "jsonrpc/client/client.hpp"
+#include "jsonrpc/server/server.hpp"
+#include "jsonrpc/transport/loopback_transport.hpp"
+
+using jsonrpc::transport::LoopbackTransport;
+
+TEST_CASE(
+    "LoopbackTransport exchanges messages in both directions",
+    "[LoopbackTransport]") {
+  auto [client, server] = LoopbackTransport::CreatePair();
+
+  client->SendMessage("Hello, Server!");
+  REQUIRE(server->ReceiveMessage() == "Hello, Server!");
+
+  server->SendMessage("");
+  server->SendMessage("Hello, Client!");
+  REQUIRE(client->ReceiveMessage().empty());
+  REQUIRE(client->ReceiveMessage() == "Hello, Client!");
+}
+
+TEST_CASE(
+    "LoopbackTransport hands over message buffers without copying",
+    "[LoopbackTransport]") {
+  auto [client, server] = LoopbackTransport::CreatePair();
+
+  std::string message(4096, 'x');
+  const char *data = message.data();
+  client->SendMessage(std::move(message));
+
+  std::string received = server->ReceiveMessage();
+  REQUIRE(received.size() == 4096);
+  REQUIRE(received.data() == data);
+}
+
+TEST_CASE(
+    "LoopbackTransport keeps each sender's order across concurrent senders",
+    "[LoopbackTransport]") {
+  auto [client, server] = LoopbackTransport::CreatePair();
+
+  constexpr int kSenders = 4;
+  constexpr int kMessagesPerSender = 5000;
+  std::vector<std::thread> senders;
+  for (int sender = 0; sender < kSenders; ++sender) {
+    senders.emplace_back([&client = client, sender]() {
+      for (int i = 0; i < kMessagesPerSender; ++i) {
+        client->SendMessage(
+            std::to_string(sender) + ":" + std::to_string(i));
+      }
+    });
+  }
+
+  std::vector<int> next(kSenders, 0);
+  for (int i = 0; i < kSenders * kMessagesPerSender; ++i) {
+    std::string message = server->ReceiveMessage();
+    std::size_t colon = message.find(':');
+    int sender = std::stoi(message.substr(0, colon));
+    REQUIRE(std::stoi(message.substr(colon + 1)) == next[sender]);
+    ++next[sender];
+  }
+  for (auto &thread : senders) {
+    thread.join();
+  }
+}
+
+TEST_CASE(
+    "LoopbackTransport delivers pending messages after close",
+    "[LoopbackTransport]") {
+  auto [client, server] = LoopbackTransport::CreatePair();
+
+  client->SendMessage("last");
+  client->Close();
+
+  REQUIRE(server->ReceiveMessage() == "last");
+  REQUIRE_THROWS_WITH(
+      server->ReceiveMessage(), "Loopback transport is closed");
+  REQUIRE_THROWS_WITH(
+      server->SendMessage("late"), "Loopback transport is closed");
+}
+
+TEST_CASE(
+    "LoopbackTransport close wakes a blocked receiver",
+    "[LoopbackTransport]") {
+  auto [client, server] = LoopbackTransport::CreatePair();
+
+  auto receive = std::async(std::launch::async, [&server = server]() {
+    return server->ReceiveMessage();
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  client.reset();
+
+  REQUIRE_THROWS_WITH(receive.get(), "Loopback transport is closed");
+}
+
+TEST_CASE(
+    "LoopbackTransport completes asynchronous operations",
+    "[LoopbackTransport]") {
+  asio::io_context io_context;
+  auto work = asio::make_work_guard(io_context);
+  std::thread io_thread([&]() { io_context.run(); });
+  auto [client, server] = LoopbackTransport::CreatePair(io_context);
+
+  // Armed before the message exists, then completed by a blocking send.
+  auto pending = server->AsyncReceiveMessage(asio::use_future);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  client->SendMessage("first");
+  REQUIRE(pending.get() == "first");
+
+  client->AsyncSendMessage("second", asio::use_future).get();
+  REQUIRE(server->AsyncReceiveMessage(asio::use_future).get() == "second");
+
+  auto closed = server->AsyncReceiveMessage(asio::use_future);
+  client->Close();
+  REQUIRE_THROWS_AS(closed.get(), asio::system_error);
+
+  work.reset();
+  io_thread.join();
+}
+
+TEST_CASE(
+    "LoopbackTransport without an io_context rejects asynchronous operations",
+    "[LoopbackTransport]") {
+  auto [client, server] = LoopbackTransport::CreatePair();
+
+  REQUIRE_THROWS_AS(
+      client->AsyncSendMessage("async", asio::use_future), std::logic_error);
+  REQUIRE_THROWS_AS(
+      server->AsyncReceiveMessage(asio::use_future), std::logic_error);
+
+  client->SendMessage("blocking");
+  REQUIRE(server->ReceiveMessage() == "blocking");
+}
+
+TEST_CASE(
+    "LoopbackTransport connects a Client and a Server in one process",
+    "[LoopbackTransport]") {
+  auto [client_end, server_end] = LoopbackTransport::CreatePair();
+
+  jsonrpc::server::Server server(std::move(server_end));
+  server.RegisterMethodCall(
+      "add", [](const std::optional<nlohmann::json> &params) {
+        return nlohmann::json{
+            {"result", (*params)[0].get<int>() + (*params)[1].get<int>()}};
+      });
+  std::thread server_thread([&]() { server.Start(); });
+
+  jsonrpc::client::Client client(std::move(client_end));
+  client.Start();
+  for (int i = 0; i < 100; ++i) {
+    auto response = client.SendMethodCall("add", nlohmann::json{i, 1});
+    REQUIRE(response["result"] == i + 1);
+  }
+  client.Stop();
+
+  server_thread.join();
+}
@@ -1,8 +1,13 @@
+#include <memory>
+#include <stdexcept>
+#include <vector>
 #include <thread>
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_string.hpp>
 
+#include "jsonrpc/server/server.hpp"
+#include "jsonrpc/transport/framed_pipe_transport.hpp"
 #include "jsonrpc/transport/pipe_transport.hpp"
 
 TEST_CASE(
@@ -66,3 +71,194 @@ TEST_CASE("PipeTransport throws on invalid socket path", "[PipeTransport]") {
       jsonrpc::transport::PipeTransport("/tmp/non_existent_socket", false),
       "Error connecting to socket");
 }
+
+TEST_CASE(
+    "PipeTransport returns every message from a single read",
+    "[PipeTransport]") {
+  std::string socket_path = "/tmp/test_socket_pipelined";
+  std::unique_ptr<jsonrpc::transport::PipeTransport> server_transport;
+
+  std::thread server_thread([&]() {
+    server_transport = std::make_unique<jsonrpc::transport::PipeTransport>(
+        socket_path, true);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  asio::io_context io_context;
+  asio::local::stream_protocol::socket client(io_context);
+  client.connect(asio::local::stream_protocol::endpoint(socket_path));
+  server_thread.join();
+
+  asio::write(client, asio::buffer(std::string("first\nsecond\nthi")));
+  REQUIRE(server_transport->ReceiveMessage() == "first");
+  REQUIRE(server_transport->ReceiveMessage() == "second");
+
+  asio::write(client, asio::buffer(std::string("rd\n")));
+  REQUIRE(server_transport->ReceiveMessage() == "third");
+}
+
+TEST_CASE(
+    "FramedPipeTransport returns every message from a single read",
+    "[PipeTransport]") {
+  std::string socket_path = "/tmp/test_socket_framed_pipelined";
+  std::unique_ptr<jsonrpc::transport::FramedPipeTransport> server_transport;
+
+  std::thread server_thread([&]() {
+    server_transport =
+        std::make_unique<jsonrpc::transport::FramedPipeTransport>(
+            socket_path, true);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  asio::io_context io_context;
+  asio::local::stream_protocol::socket client(io_context);
+  client.connect(asio::local::stream_protocol::endpoint(socket_path));
+  server_thread.join();
+
+  asio::write(
+      client, asio::buffer(std::string(
+                  "Content-Length: 5\r\n\r\nfirst"
+                  "Content-Length: 6\r\n\r\nsecond"
+                  "Content-Length: 5\r\n\r\nth")));
+  REQUIRE(server_transport->ReceiveMessage() == "first");
+  REQUIRE(server_transport->ReceiveMessage() == "second");
+
+  asio::write(client, asio::buffer(std::string("ird")));
+  REQUIRE(server_transport->ReceiveMessage() == "third");
+}
+
+TEST_CASE("FramedPipeTransport sends large messages", "[PipeTransport]") {
+  std::string socket_path = "/tmp/test_socket_framed_large";
+  std::string message(4 * 1024 * 1024, 'x');
+
+  std::thread server_thread([&]() {
+    jsonrpc::transport::FramedPipeTransport server_transport(socket_path, true);
+    REQUIRE(server_transport.ReceiveMessage() == message);
+    server_transport.SendMessage(std::string(message));
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  jsonrpc::transport::FramedPipeTransport client_transport(socket_path, false);
+  client_transport.SendMessage(message);
+  REQUIRE(client_transport.ReceiveMessage() == message);
+
+  server_thread.join();
+}
+
+TEST_CASE(
+    "FramedPipeTransport streams requests into a Server", "[PipeTransport]") {
+  std::string socket_path = "/tmp/test_socket_framed_streaming";
+  std::string payload(1024 * 1024, 'x');
+
+  std::thread server_thread([&]() {
+    jsonrpc::server::Server server(
+        std::make_unique<jsonrpc::transport::FramedPipeTransport>(
+            socket_path, true, jsonrpc::transport::SocketOptions{},
+            jsonrpc::transport::FramedOptions{
+                .max_message_size = 2 * 1024 * 1024,
+                .stream_content = true}));
+    server.RegisterMethodCall(
+        "size", [](const std::optional<nlohmann::json> &params) {
+          return nlohmann::json{
+              {"result", (*params)[0].get<std::string>().size()}};
+        });
+    // Returns once the client disconnects.
+    server.Start();
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  {
+    jsonrpc::transport::FramedPipeTransport client_transport(
+        socket_path, false);
+    client_transport.SendMessage(
+        nlohmann::json{
+            {"jsonrpc", "2.0"},
+            {"method", "size"},
+            {"params", {payload}},
+            {"id", 1}}
+            .dump());
+    auto response = nlohmann::json::parse(client_transport.ReceiveMessage());
+    REQUIRE(response["result"] == payload.size());
+
+    client_transport.SendMessage("{not json");
+    response = nlohmann::json::parse(client_transport.ReceiveMessage());
+    REQUIRE(response["error"]["code"] == -32700);
+
+    // An oversized request is answered with an error and does not stop the
+    // server.
+    client_transport.SendMessage(std::string(3 * 1024 * 1024, ' '));
+    response = nlohmann::json::parse(client_transport.ReceiveMessage());
+    REQUIRE(response["error"]["code"] == -32600);
+    REQUIRE(response["id"].is_null());
+
+    client_transport.SendMessage(
+        R"({"jsonrpc":"2.0","method":"size","params":["abc"],"id":2})");
+    response = nlohmann::json::parse(client_transport.ReceiveMessage());
+    REQUIRE(response["result"] == 3);
+  }
+
+  server_thread.join();
+}
+
+TEST_CASE(
+    "PipeTransport sends and receives on a supplied io_context",
+    "[PipeTransport]") {
+  std::string socket_path = "/tmp/test_socket_async";
+
+  std::thread server_thread([&]() {
+    jsonrpc::transport::PipeTransport server_transport(socket_path, true);
+    REQUIRE(server_transport.ReceiveMessage() == "first");
+    REQUIRE(server_transport.ReceiveMessage() == "second");
+    server_transport.SendMessage("reply");
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  asio::io_context io_context;
+  jsonrpc::transport::PipeTransport client_transport(
+      io_context, socket_path, false);
+
+  std::vector<asio::error_code> send_results;
+  std::string reply;
+  for (const char *message : {"first", "second"}) {
+    client_transport.AsyncSendMessage(
+        message,
+        [&](const asio::error_code &ec) { send_results.push_back(ec); });
+  }
+  client_transport.AsyncReceiveMessage(
+      [&](const asio::error_code &ec, std::string message) {
+        REQUIRE_FALSE(ec);
+        reply = std::move(message);
+      });
+
+  io_context.run();
+
+  REQUIRE(send_results.size() == 2);
+  REQUIRE_FALSE(send_results[0]);
+  REQUIRE_FALSE(send_results[1]);
+  REQUIRE(reply == "reply");
+
+  server_thread.join();
+}
+
+TEST_CASE(
+    "PipeTransport without an io_context rejects asynchronous operations",
+    "[PipeTransport]") {
+  std::string socket_path = "/tmp/test_socket_async_rejected";
+
+  std::thread server_thread([&]() {
+    jsonrpc::transport::PipeTransport server_transport(socket_path, true);
+    REQUIRE(server_transport.ReceiveMessage() == "blocking");
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  jsonrpc::transport::PipeTransport client_transport(socket_path, false);
+  REQUIRE_THROWS_AS(
+      client_transport.AsyncSendMessage("async", asio::use_future),
+      std::logic_error);
+  REQUIRE_THROWS_AS(
+      client_transport.AsyncReceiveMessage(asio::use_future),
+      std::logic_error);
+  client_transport.SendMessage("blocking");
+
+  server_thread.join();
+}
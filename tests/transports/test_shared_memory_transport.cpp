@@ -0,0 +1,130 @@
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <future>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+
+#include "jsonrpc/transport/shared_memory_transport.hpp"
+
+using jsonrpc::transport::SharedMemoryOptions;
+using jsonrpc::transport::SharedMemoryTransport;
+
+TEST_CASE(
+    "SharedMemoryTransport exchanges messages in both directions",
+    "[SharedMemoryTransport]") {
+  SharedMemoryTransport server("/jsonrpc_test_shm_basic", true);
+  SharedMemoryTransport client("/jsonrpc_test_shm_basic", false);
+
+  client.SendMessage("Hello, Server!");
+  REQUIRE(server.ReceiveMessage() == "Hello, Server!");
+
+  server.SendMessage("");
+  server.SendMessage("Hello, Client!");
+  REQUIRE(client.ReceiveMessage().empty());
+  REQUIRE(client.ReceiveMessage() == "Hello, Client!");
+}
+
+TEST_CASE(
+    "SharedMemoryTransport streams more data than the ring holds",
+    "[SharedMemoryTransport]") {
+  SharedMemoryOptions options;
+  options.ring_capacity = 256;
+  options.spin_iterations = 10;
+  SharedMemoryTransport server("/jsonrpc_test_shm_stream", true, options);
+  SharedMemoryTransport client("/jsonrpc_test_shm_stream", false);
+
+  constexpr int kMessageCount = 2000;
+  std::thread sender([&]() {
+    for (int i = 0; i < kMessageCount; ++i) {
+      client.SendMessage(std::string(static_cast<std::size_t>(i % 200), 'x'));
+    }
+  });
+
+  for (int i = 0; i < kMessageCount; ++i) {
+    REQUIRE(
+        server.ReceiveMessage() ==
+        std::string(static_cast<std::size_t>(i % 200), 'x'));
+  }
+  sender.join();
+}
+
+TEST_CASE(
+    "SharedMemoryTransport rejects messages larger than the ring",
+    "[SharedMemoryTransport]") {
+  SharedMemoryOptions options;
+  options.ring_capacity = 128;
+  SharedMemoryTransport server("/jsonrpc_test_shm_large", true, options);
+
+  REQUIRE_THROWS_WITH(
+      server.SendMessage(std::string(200, 'x')),
+      "Message is larger than the shared memory ring");
+}
+
+TEST_CASE(
+    "SharedMemoryTransport rejects a corrupt message length",
+    "[SharedMemoryTransport]") {
+  SharedMemoryOptions options;
+  options.ring_capacity = 128;
+  SharedMemoryTransport server("/jsonrpc_test_shm_corrupt", true, options);
+  SharedMemoryTransport client("/jsonrpc_test_shm_corrupt", false);
+  client.SendMessage("hello");
+
+  // The client-to-server ring is stored last, and the message was written
+  // at its start.
+  int fd = shm_open("/jsonrpc_test_shm_corrupt", O_RDWR, 0);
+  REQUIRE(fd >= 0);
+  struct stat info {};
+  REQUIRE(fstat(fd, &info) == 0);
+  auto size = static_cast<std::size_t>(info.st_size);
+  void *mapping =
+      mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  REQUIRE(mapping != MAP_FAILED);
+  std::uint32_t length = 0xfffffff0;
+  std::memcpy(
+      static_cast<char *>(mapping) + size - options.ring_capacity, &length,
+      sizeof(length));
+  munmap(mapping, size);
+
+  REQUIRE_THROWS_WITH(
+      server.ReceiveMessage(),
+      "Error receiving message: corrupt message length");
+  REQUIRE_THROWS_AS(client.SendMessage("after close"), std::runtime_error);
+}
+
+TEST_CASE(
+    "SharedMemoryTransport close wakes a blocked receiver",
+    "[SharedMemoryTransport]") {
+  SharedMemoryTransport server("/jsonrpc_test_shm_close", true);
+  SharedMemoryTransport client("/jsonrpc_test_shm_close", false);
+
+  server.SendMessage("last");
+  auto receiving = std::async(std::launch::async, [&]() {
+    REQUIRE(client.ReceiveMessage() == "last");
+    client.ReceiveMessage();
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  server.Close();
+
+  REQUIRE(
+      receiving.wait_for(std::chrono::seconds(1)) ==
+      std::future_status::ready);
+  REQUIRE_THROWS_AS(receiving.get(), std::runtime_error);
+  REQUIRE_THROWS_AS(client.SendMessage("after close"), std::runtime_error);
+}
+
+TEST_CASE(
+    "SharedMemoryTransport client fails without a server",
+    "[SharedMemoryTransport]") {
+  REQUIRE_THROWS_WITH(
+      SharedMemoryTransport("/jsonrpc_test_shm_missing", false),
+      "Error opening shared memory");
+}
@@ -1,8 +1,11 @@
+#include <exception>
+#include <memory>
 #include <thread>
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_string.hpp>
 
+#include "jsonrpc/transport/framed_socket_transport.hpp"
 #include "jsonrpc/transport/socket_transport.hpp"
 
 TEST_CASE(
@@ -64,3 +67,170 @@ TEST_CASE(
 
   server_thread.join();
 }
+
+TEST_CASE(
+    "SocketTransport returns every message from a single read",
+    "[SocketTransport]") {
+  std::string host = "127.0.0.1";
+  uint16_t port = 12347;
+  std::unique_ptr<jsonrpc::transport::SocketTransport> server_transport;
+
+  std::thread server_thread([&]() {
+    server_transport = std::make_unique<jsonrpc::transport::SocketTransport>(
+        host, port, true);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  asio::io_context io_context;
+  asio::ip::tcp::socket client(io_context);
+  client.connect(
+      asio::ip::tcp::endpoint(asio::ip::make_address(host), port));
+  server_thread.join();
+
+  asio::write(client, asio::buffer(std::string("first\nsecond\nthi")));
+  REQUIRE(server_transport->ReceiveMessage() == "first");
+  REQUIRE(server_transport->ReceiveMessage() == "second");
+
+  asio::write(client, asio::buffer(std::string("rd\n")));
+  REQUIRE(server_transport->ReceiveMessage() == "third");
+}
+
+TEST_CASE(
+    "FramedSocketTransport completes asynchronous operations with futures",
+    "[SocketTransport]") {
+  std::string host = "127.0.0.1";
+  uint16_t port = 12348;
+
+  std::thread server_thread([&]() {
+    jsonrpc::transport::FramedSocketTransport server_transport(
+        host, port, true);
+    std::string request = server_transport.ReceiveMessage();
+    server_transport.SendMessage("echo: " + request);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  asio::io_context io_context;
+  auto work = asio::make_work_guard(io_context);
+  std::thread io_thread([&]() { io_context.run(); });
+
+  jsonrpc::transport::FramedSocketTransport client_transport(
+      io_context, host, port, false);
+  client_transport.AsyncSendMessage("hello", asio::use_future).get();
+  auto reply = client_transport.AsyncReceiveMessage(asio::use_future);
+  REQUIRE(reply.get() == "echo: hello");
+
+  work.reset();
+  io_thread.join();
+  server_thread.join();
+}
+
+namespace {
+
+auto EchoOnce(jsonrpc::transport::AsyncTransport &transport)
+    -> asio::awaitable<void> {
+  std::string request =
+      co_await transport.AsyncReceiveMessage(asio::use_awaitable);
+  co_await transport.AsyncSendMessage("echo: " + request, asio::use_awaitable);
+}
+
+}  // namespace
+
+TEST_CASE(
+    "SocketTransport supports coroutine completion tokens",
+    "[SocketTransport]") {
+  std::string host = "127.0.0.1";
+  uint16_t port = 12349;
+  asio::io_context io_context;
+  std::unique_ptr<jsonrpc::transport::SocketTransport> server_transport;
+
+  std::thread server_thread([&]() {
+    server_transport = std::make_unique<jsonrpc::transport::SocketTransport>(
+        io_context, host, port, true);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  jsonrpc::transport::SocketTransport client_transport(host, port, false);
+  server_thread.join();
+
+  std::exception_ptr error;
+  asio::co_spawn(
+      io_context, EchoOnce(*server_transport),
+      [&](std::exception_ptr e) { error = e; });
+  client_transport.SendMessage("hi");
+  io_context.run();
+
+  REQUIRE_FALSE(error);
+  REQUIRE(client_transport.ReceiveMessage() == "echo: hi");
+}
+
+namespace {
+
+class InspectableSocketTransport : public jsonrpc::transport::SocketTransport {
+ public:
+  using SocketTransport::GetSocket;
+  using SocketTransport::SocketTransport;
+};
+
+}  // namespace
+
+TEST_CASE("SocketTransport applies socket options", "[SocketTransport]") {
+  std::string host = "127.0.0.1";
+  uint16_t port = 12350;
+  jsonrpc::transport::SocketOptions options;
+  options.keep_alive = true;
+  options.reuse_port = true;
+  options.receive_buffer_size = 256 * 1024;
+  options.send_buffer_size = 256 * 1024;
+  options.listen_backlog = 4;
+
+  std::unique_ptr<InspectableSocketTransport> server_transport;
+  std::thread server_thread([&]() {
+    server_transport =
+        std::make_unique<InspectableSocketTransport>(host, port, true, options);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  InspectableSocketTransport client_transport(host, port, false, options);
+  server_thread.join();
+
+  for (auto *transport : {server_transport.get(), &client_transport}) {
+    asio::ip::tcp::no_delay no_delay;
+    transport->GetSocket().get_option(no_delay);
+    REQUIRE(no_delay.value());
+
+    asio::socket_base::keep_alive keep_alive;
+    transport->GetSocket().get_option(keep_alive);
+    REQUIRE(keep_alive.value());
+
+    // The kernel may round the requested size, but not shrink it.
+    asio::socket_base::receive_buffer_size receive_buffer_size;
+    transport->GetSocket().get_option(receive_buffer_size);
+    REQUIRE(receive_buffer_size.value() >= *options.receive_buffer_size);
+  }
+
+  client_transport.SendMessage("ping");
+  REQUIRE(server_transport->ReceiveMessage() == "ping");
+}
+
+TEST_CASE(
+    "SocketTransport leaves Nagle's algorithm on when asked",
+    "[SocketTransport]") {
+  std::string host = "127.0.0.1";
+  uint16_t port = 12351;
+  jsonrpc::transport::SocketOptions options;
+  options.no_delay = false;
+
+  std::unique_ptr<InspectableSocketTransport> server_transport;
+  std::thread server_thread([&]() {
+    server_transport =
+        std::make_unique<InspectableSocketTransport>(host, port, true, options);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  InspectableSocketTransport client_transport(host, port, false, options);
+  server_thread.join();
+
+  asio::ip::tcp::no_delay no_delay;
+  client_transport.GetSocket().get_option(no_delay);
+  REQUIRE_FALSE(no_delay.value());
+}
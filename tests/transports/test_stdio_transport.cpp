@@ -1,28 +1,49 @@
+#include <chrono>
+#include <future>
+#include <memory>
+#include <thread>
+
 #include <catch2/catch_test_macros.hpp>
 
 #include "../common/test_utils.hpp"
+#include "jsonrpc/client/client.hpp"
+#include "jsonrpc/transport/framed_stdio_transport.hpp"
 #include "jsonrpc/transport/stdio_transport.hpp"
 
+using jsonrpc::transport::FlushPolicy;
+using jsonrpc::transport::FramedStdioTransport;
+using jsonrpc::transport::StdioOptions;
+using jsonrpc::transport::StdioTransport;
+
+namespace {
+
+auto MakeOptions(const PipeIO &io) -> StdioOptions {
+  StdioOptions options;
+  options.input_fd = io.InputFd();
+  options.output_fd = io.OutputFd();
+  return options;
+}
+
+}  // namespace
+
 TEST_CASE("StdioTransport sends a message correctly", "[StdioTransport]") {
   std::string test_message = R"({"jsonrpc": "2.0", "method": "example"})";
-  std::ostringstream captured_output;
-  RedirectIO redirect(std::cin, captured_output);
+  PipeIO io;
 
-  jsonrpc::transport::StdioTransport transport;
+  StdioTransport transport(MakeOptions(io));
   transport.SendMessage(test_message);
 
   // The tested class adds a newline to the end of the message
-  REQUIRE(captured_output.str() == test_message + "\n");
+  REQUIRE(io.GetOutput() == test_message + "\n");
 }
 
 TEST_CASE("StdioTransport reads a message correctly", "[StdioTransport]") {
   std::string test_input = R"({"jsonrpc": "2.0", "result": "success"})";
 
-  // Redirect std::cin to simulated input
-  std::istringstream simulated_input(test_input + "\n");
-  RedirectIO redirect(simulated_input, std::cout);
+  PipeIO io;
+  io.SetInput(test_input + "\n");
 
-  jsonrpc::transport::StdioTransport transport;
+  StdioTransport transport(MakeOptions(io));
   std::string response = transport.ReceiveMessage();
 
   REQUIRE(response == test_input);
@@ -30,30 +51,24 @@ TEST_CASE("StdioTransport reads a message correctly", "[StdioTransport]") {
 
 TEST_CASE("StdioTransport handles empty message", "[StdioTransport]") {
   std::string empty_message;
+  PipeIO io;
 
-  // Redirect std::cout to capture output
-  std::ostringstream captured_output;
-  RedirectIO redirect(std::cin, captured_output);
-
-  jsonrpc::transport::StdioTransport transport;
+  StdioTransport transport(MakeOptions(io));
   transport.SendMessage(empty_message);
 
   // Even empty messages should end with a newline
-  REQUIRE(captured_output.str() == "\n");
+  REQUIRE(io.GetOutput() == "\n");
 }
 
 TEST_CASE("StdioTransport handles large message", "[StdioTransport]") {
   // Create a large message of 10,000 'x' characters
   std::string large_message(10000, 'x');
+  PipeIO io;
 
-  // Redirect std::cout to capture output
-  std::ostringstream captured_output;
-  RedirectIO redirect(std::cin, captured_output);
-
-  jsonrpc::transport::StdioTransport transport;
+  StdioTransport transport(MakeOptions(io));
   transport.SendMessage(large_message);
 
-  REQUIRE(captured_output.str() == large_message + "\n");
+  REQUIRE(io.GetOutput() == large_message + "\n");
 }
 
 TEST_CASE(
@@ -61,26 +76,104 @@ TEST_CASE(
     "[StdioTransport]") {
   std::string special_message =
       R"({"jsonrpc": "2.0", "method": "example", "params": ["newline\n", "tab\t"]})";
+  PipeIO io;
 
-  // Redirect std::cout to capture output
-  std::ostringstream captured_output;
-  RedirectIO redirect(std::cin, captured_output);
-
-  jsonrpc::transport::StdioTransport transport;
+  StdioTransport transport(MakeOptions(io));
   transport.SendMessage(special_message);
 
-  REQUIRE(captured_output.str() == special_message + "\n");
+  REQUIRE(io.GetOutput() == special_message + "\n");
 }
 
 TEST_CASE("StdioTransport handles reading empty response", "[StdioTransport]") {
   std::string empty_input;
 
   // Add newline to simulate input
-  std::istringstream simulated_input(empty_input + "\n");
-  RedirectIO redirect(simulated_input, std::cout);
+  PipeIO io;
+  io.SetInput(empty_input + "\n");
 
-  jsonrpc::transport::StdioTransport transport;
+  StdioTransport transport(MakeOptions(io));
   std::string response = transport.ReceiveMessage();
 
   REQUIRE(response.empty());
 }
+
+TEST_CASE(
+    "StdioTransport reads buffered lines and a final unterminated line",
+    "[StdioTransport]") {
+  PipeIO io;
+  io.SetInput("first\nsecond\r\nlast");
+
+  StdioTransport transport(MakeOptions(io));
+  REQUIRE(transport.ReceiveMessage() == "first");
+  REQUIRE(transport.ReceiveMessage() == "second\r");
+  REQUIRE(transport.ReceiveMessage() == "last");
+  REQUIRE_THROWS_AS(transport.ReceiveMessage(), std::runtime_error);
+}
+
+TEST_CASE(
+    "StdioTransport collects output until flushed", "[StdioTransport]") {
+  PipeIO io;
+  io.SetInput("request\n");
+  StdioOptions options = MakeOptions(io);
+  options.flush_policy = FlushPolicy::kWhenFull;
+  options.write_buffer_size = 16;
+
+  {
+    StdioTransport transport(options);
+    transport.SendMessage("one");
+    transport.SendMessage("two");
+    // Waiting for input writes what has been collected so far.
+    REQUIRE(transport.ReceiveMessage() == "request");
+    transport.SendMessage("a message over the buffer size");
+    transport.SendMessage("three");
+  }
+
+  REQUIRE(
+      io.GetOutput() == "one\ntwo\na message over the buffer size\nthree\n");
+}
+
+TEST_CASE(
+    "FramedStdioTransport exchanges framed messages", "[StdioTransport]") {
+  std::string message = R"({"jsonrpc":"2.0","method":"testMethod"})";
+  PipeIO io;
+  io.SetInput(
+      "Content-Length: 39\r\n\r\n" + message + "Content-Length: 2\r\n\r\n{}");
+
+  FramedStdioTransport transport(MakeOptions(io));
+  REQUIRE(transport.ReceiveMessage() == message);
+  REQUIRE(transport.ReceiveMessage() == "{}");
+
+  transport.SendMessage(message);
+  REQUIRE(
+      io.GetOutput() ==
+      "Content-Length: 39\r\n"
+      "Content-Type: application/vscode-jsonrpc; charset=utf-8\r\n"
+      "\r\n" +
+          message);
+}
+
+TEST_CASE("StdioTransport close ends a blocked receive", "[StdioTransport]") {
+  PipeIO io;
+  StdioTransport transport(MakeOptions(io));
+
+  auto receive = std::async(std::launch::async, [&transport]() {
+    return transport.ReceiveMessage();
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  transport.Close();
+
+  REQUIRE_THROWS_AS(receive.get(), std::runtime_error);
+  REQUIRE_THROWS_AS(transport.ReceiveMessage(), std::runtime_error);
+}
+
+TEST_CASE("Client over stdio stops while idle", "[StdioTransport]") {
+  PipeIO io;
+  jsonrpc::client::Client client(
+      std::make_unique<StdioTransport>(MakeOptions(io)));
+  client.Start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  // The listener is blocked reading input that never comes.
+  client.Stop();
+  REQUIRE_FALSE(client.IsRunning());
+}
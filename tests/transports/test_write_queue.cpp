@@ -0,0 +1,297 @@
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+
+#include "jsonrpc/transport/write_queue.hpp"
+
+using jsonrpc::transport::WriteQueue;
+using jsonrpc::transport::WriteQueueOptions;
+
+namespace {
+
+/// Records each write and can hold the writer inside it until released.
+class RecordingWriter {
+ public:
+  void Write(const std::vector<asio::const_buffer> &buffers) {
+    std::string data;
+    for (const auto &buffer : buffers) {
+      data.append(static_cast<const char *>(buffer.data()), buffer.size());
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    writes_.push_back(std::move(data));
+    threads_.push_back(std::this_thread::get_id());
+    entered_ = true;
+    cv_.notify_all();
+    cv_.wait(lock, [this]() { return !blocked_; });
+  }
+
+  void Block() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    blocked_ = true;
+    entered_ = false;
+  }
+
+  void Release() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    blocked_ = false;
+    cv_.notify_all();
+  }
+
+  void WaitUntilEntered() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this]() { return entered_; });
+  }
+
+  auto GetWrites() -> std::vector<std::string> {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return writes_;
+  }
+
+  auto GetThreads() -> std::vector<std::thread::id> {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return threads_;
+  }
+
+  auto MakeWriter() -> WriteQueue::Writer {
+    return [this](const std::vector<asio::const_buffer> &buffers) {
+      Write(buffers);
+    };
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<std::string> writes_;
+  std::vector<std::thread::id> threads_;
+  bool blocked_ = false;
+  bool entered_ = false;
+};
+
+/// Waits until the queue holds the given number of bytes.
+void WaitForQueuedBytes(const WriteQueue &queue, std::size_t bytes) {
+  while (queue.GetQueuedBytes() != bytes) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+}  // namespace
+
+TEST_CASE("WriteQueue writes an idle send immediately", "[WriteQueue]") {
+  RecordingWriter writer;
+  WriteQueue queue(writer.MakeWriter());
+
+  queue.Send("<", std::string("body"), ">");
+  queue.Send({}, std::string("line"), "\n");
+
+  REQUIRE(writer.GetWrites() == std::vector<std::string>{"<body>", "line\n"});
+  REQUIRE(queue.GetQueuedBytes() == 0);
+}
+
+TEST_CASE(
+    "WriteQueue coalesces messages queued during a write", "[WriteQueue]") {
+  RecordingWriter writer;
+  WriteQueue queue(writer.MakeWriter());
+
+  writer.Block();
+  std::thread first([&]() { queue.Send({}, std::string("a"), "\n"); });
+  writer.WaitUntilEntered();
+
+  // The first sender is writing, so the next one waits to write next and
+  // the rest are queued and return at once.
+  std::thread second([&]() { queue.Send({}, std::string("b"), "\n"); });
+  WaitForQueuedBytes(queue, 2);
+  std::string owned = "c";
+  queue.Send({}, std::move(owned), "\n");
+  queue.Send("#", std::string("d"), "\n");
+  REQUIRE(queue.GetQueuedBytes() == 7);
+
+  writer.Release();
+  first.join();
+  second.join();
+
+  REQUIRE(writer.GetWrites() == std::vector<std::string>{"a\n", "b\nc\n#d\n"});
+  REQUIRE(queue.GetQueuedBytes() == 0);
+}
+
+TEST_CASE("WriteQueue splits large backlogs across writes", "[WriteQueue]") {
+  RecordingWriter writer;
+  WriteQueueOptions options;
+  options.max_write_bytes = 4;
+  WriteQueue queue(writer.MakeWriter(), options);
+
+  writer.Block();
+  std::thread first([&]() { queue.Send({}, std::string("a"), "\n"); });
+  writer.WaitUntilEntered();
+  std::thread second([&]() { queue.Send({}, std::string("b"), "\n"); });
+  WaitForQueuedBytes(queue, 2);
+  for (const char *body : {"c", "d"}) {
+    queue.Send({}, std::string(body), "\n");
+  }
+  writer.Release();
+  first.join();
+  second.join();
+
+  REQUIRE(
+      writer.GetWrites() == std::vector<std::string>{"a\n", "b\nc\n", "d\n"});
+}
+
+TEST_CASE("WriteQueue blocks senders when the queue is full", "[WriteQueue]") {
+  RecordingWriter writer;
+  WriteQueueOptions options;
+  options.max_queued_bytes = 4;
+  WriteQueue queue(writer.MakeWriter(), options);
+
+  writer.Block();
+  std::thread first([&]() { queue.Send({}, std::string("a"), "\n"); });
+  writer.WaitUntilEntered();
+  std::thread second([&]() { queue.Send({}, std::string("bcd"), "\n"); });
+  WaitForQueuedBytes(queue, 4);
+
+  auto blocked = std::async(std::launch::async, [&]() {
+    queue.Send({}, std::string("e"), "\n");
+  });
+  REQUIRE(
+      blocked.wait_for(std::chrono::milliseconds(50)) ==
+      std::future_status::timeout);
+
+  writer.Release();
+  first.join();
+  second.join();
+  REQUIRE(
+      blocked.wait_for(std::chrono::seconds(1)) == std::future_status::ready);
+  blocked.get();
+
+  std::string written;
+  for (const auto &write : writer.GetWrites()) {
+    written += write;
+  }
+  REQUIRE(written == "a\nbcd\ne\n");
+}
+
+TEST_CASE(
+    "WriteQueue hands the writer role to a waiting sender", "[WriteQueue]") {
+  RecordingWriter writer;
+  WriteQueue queue(writer.MakeWriter());
+
+  writer.Block();
+  std::thread first([&]() { queue.Send({}, std::string("a"), "\n"); });
+  writer.WaitUntilEntered();
+  std::thread::id second_id;
+  std::thread second([&]() {
+    second_id = std::this_thread::get_id();
+    queue.Send({}, std::string("b"), "\n");
+  });
+  WaitForQueuedBytes(queue, 2);
+  queue.Send({}, std::string("c"), "\n");
+
+  // The first sender only writes its own message; the messages queued
+  // behind it are written by the sender that waited.
+  writer.Release();
+  first.join();
+  second.join();
+
+  REQUIRE(writer.GetWrites() == std::vector<std::string>{"a\n", "b\nc\n"});
+  REQUIRE(writer.GetThreads()[1] == second_id);
+}
+
+TEST_CASE("WriteQueue fails later sends after a write error", "[WriteQueue]") {
+  std::atomic<int> calls{0};
+  WriteQueue queue([&](const std::vector<asio::const_buffer> &) {
+    calls++;
+    throw std::runtime_error("broken pipe");
+  });
+
+  REQUIRE_THROWS_WITH(queue.Send({}, std::string("a"), "\n"), "broken pipe");
+  REQUIRE_THROWS_WITH(queue.Send({}, std::string("b"), "\n"), "broken pipe");
+  REQUIRE(calls == 1);
+}
+
+TEST_CASE("WriteQueue rejects sends once closed", "[WriteQueue]") {
+  RecordingWriter writer;
+  WriteQueue queue(writer.MakeWriter());
+
+  queue.Close();
+
+  REQUIRE_THROWS_AS(queue.Send({}, std::string("a"), "\n"), std::runtime_error);
+  REQUIRE(writer.GetWrites().empty());
+}
+
+TEST_CASE(
+    "WriteQueue coalesces asynchronous sends behind a pending write",
+    "[WriteQueue]") {
+  RecordingWriter writer;
+  std::vector<std::string> async_writes;
+  WriteQueue::Handler complete_write;
+  WriteQueue queue(
+      writer.MakeWriter(), [&](const std::vector<asio::const_buffer> &buffers,
+                               WriteQueue::Handler handler) {
+        std::string data;
+        for (const auto &buffer : buffers) {
+          data.append(static_cast<const char *>(buffer.data()), buffer.size());
+        }
+        async_writes.push_back(std::move(data));
+        complete_write = std::move(handler);
+      });
+
+  std::vector<std::string> completed;
+  auto on_written = [&](const char *name) {
+    return [&completed, name](const asio::error_code &ec) {
+      REQUIRE_FALSE(ec);
+      completed.emplace_back(name);
+    };
+  };
+
+  queue.AsyncSend({}, "a", "\n", on_written("a"));
+  queue.AsyncSend({}, "b", "\n", on_written("b"));
+  queue.Send({}, std::string("c"), "\n");
+  queue.AsyncSend("#", "d", "\n", on_written("d"));
+  REQUIRE(async_writes == std::vector<std::string>{"a\n"});
+  REQUIRE(completed.empty());
+
+  std::exchange(complete_write, nullptr)({});
+  REQUIRE(async_writes == std::vector<std::string>{"a\n", "b\nc\n#d\n"});
+  REQUIRE(completed == std::vector<std::string>{"a"});
+
+  std::exchange(complete_write, nullptr)({});
+  REQUIRE(completed == std::vector<std::string>{"a", "b", "d"});
+
+  // Once idle, a blocking send writes directly again.
+  queue.Send({}, std::string("e"), "\n");
+  REQUIRE(writer.GetWrites() == std::vector<std::string>{"e\n"});
+}
+
+TEST_CASE(
+    "WriteQueue reports asynchronous write errors to every handler",
+    "[WriteQueue]") {
+  WriteQueue::Handler complete_write;
+  WriteQueue queue(
+      [](const std::vector<asio::const_buffer> &) {},
+      [&](const std::vector<asio::const_buffer> &,
+          WriteQueue::Handler handler) {
+        complete_write = std::move(handler);
+      });
+
+  std::vector<asio::error_code> results;
+  for (const char *body : {"a", "b"}) {
+    queue.AsyncSend({}, body, "\n", [&](const asio::error_code &ec) {
+      results.push_back(ec);
+    });
+  }
+  std::exchange(complete_write, nullptr)(asio::error::broken_pipe);
+
+  REQUIRE(results.size() == 2);
+  REQUIRE(results[0] == asio::error::broken_pipe);
+  REQUIRE(results[1] == asio::error::broken_pipe);
+  REQUIRE_THROWS(queue.Send({}, std::string("c"), "\n"));
+}